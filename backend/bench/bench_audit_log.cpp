@@ -0,0 +1,87 @@
+﻿// bench/bench_audit_log.cpp
+// Латентність мутації (ShipsRepo::update + рядок аудиту) для
+// синхронного і асинхронного запису logs. Серія з 10k оновлень.
+//
+// Запуск: OOP_DB_PATH=/tmp/bench.db ./oop_bench_audit_log [updates]
+//         OOP_DB_PROFILE=bench ./oop_bench_audit_log  (in-memory: лише вартість застосунку)
+#include "db/Db.h"
+#include "repos/ShipsRepo.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Result {
+    double meanUs{0};
+    double p50Us{0};
+    double p99Us{0};
+    double totalMs{0};
+};
+
+Result burst(const Ship& base, int updates) {
+    ShipsRepo repo;
+    std::vector<double> lat;
+    lat.reserve(updates);
+
+    Ship s = base;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < updates; ++i) {
+        s.speed_knots = 10.0 + (i % 20);
+        const auto t0 = std::chrono::steady_clock::now();
+        repo.update(s);
+        const auto t1 = std::chrono::steady_clock::now();
+        lat.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+    }
+    // Час до повного запису аудиту входить у загальний підсумок
+    Db::instance().flushLogs();
+    const auto end = std::chrono::steady_clock::now();
+
+    std::sort(lat.begin(), lat.end());
+    Result r;
+    for (double v : lat) r.meanUs += v;
+    r.meanUs /= lat.size();
+    r.p50Us   = lat[lat.size() / 2];
+    r.p99Us   = lat[lat.size() * 99 / 100];
+    r.totalMs = std::chrono::duration<double, std::milli>(end - start).count();
+    return r;
+}
+
+void print(const char* name, const Result& r) {
+    std::printf("%-6s mean=%7.1f us  p50=%7.1f us  p99=%7.1f us  total(incl. flush)=%8.1f ms\n",
+                name, r.meanUs, r.p50Us, r.p99Us, r.totalMs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (!std::getenv("OOP_DB_PATH") && !std::getenv("OOP_DB_PROFILE")) {
+        std::fprintf(stderr, "set OOP_DB_PATH to a scratch database or OOP_DB_PROFILE=bench\n");
+        return 2;
+    }
+    const int updates = argc > 1 ? std::atoi(argv[1]) : 10000;
+
+    ShipsRepo repo;
+    Ship s;
+    s.name = "audit-bench-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    s.type = "cargo";
+    s.country = "Bench";
+    s = repo.create(s);
+
+    AuditLogOptions opts;
+
+    opts.mode = AuditLogMode::Sync;
+    Db::instance().configureAuditLog(opts);
+    print("sync", burst(s, updates));
+
+    opts.mode = AuditLogMode::Async;
+    Db::instance().configureAuditLog(opts);
+    print("async", burst(s, updates));
+
+    repo.remove(s.id);
+    return 0;
+}
@@ -0,0 +1,83 @@
+﻿// bench/bench_geo.cpp
+// Haversine: скалярна формула по парі і пакетне ядро (AVX2, якщо є) над SoA-масивами.
+//
+// Запуск: ./oop_bench_geo [pairs]
+//         OOP_GEO_KERNEL=scalar ./oop_bench_geo  (пакетний шлях без AVX2)
+#include "geo/Geo.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr int kRounds = 5;
+
+struct Pairs {
+    std::vector<double> lat1, lon1, lat2, lon2;
+};
+
+Pairs makePairs(std::size_t n) {
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> lat(-90.0, 90.0);
+    std::uniform_real_distribution<double> lon(-180.0, 180.0);
+
+    Pairs p;
+    p.lat1.resize(n); p.lon1.resize(n); p.lat2.resize(n); p.lon2.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        p.lat1[i] = lat(rng); p.lon1[i] = lon(rng);
+        p.lat2[i] = lat(rng); p.lon2[i] = lon(rng);
+    }
+    return p;
+}
+
+// Найкращий з kRounds прогонів, нс на пару
+template <typename F>
+double bestNsPerPair(std::size_t n, F&& run) {
+    double best = 1e300;
+    for (int r = 0; r < kRounds; ++r) {
+        const auto t0 = std::chrono::steady_clock::now();
+        run();
+        const auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count() / n);
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const Pairs p = makePairs(n);
+
+    std::vector<double> ref(n), out(n);
+
+    const double scalarNs = bestNsPerPair(n, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            ref[i] = geo::haversineKm(p.lat1[i], p.lon1[i], p.lat2[i], p.lon2[i]);
+        }
+    });
+
+    const double batchNs = bestNsPerPair(n, [&] {
+        geo::haversineKm(p.lat1.data(), p.lon1.data(), p.lat2.data(), p.lon2.data(), out.data(), n);
+    });
+
+    double maxAbs = 0.0;
+    double maxRel = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double d = std::fabs(out[i] - ref[i]);
+        maxAbs = std::max(maxAbs, d);
+        if (ref[i] > 1.0) maxRel = std::max(maxRel, d / ref[i]);
+    }
+
+    std::printf("pairs: %zu\n", n);
+    std::printf("scalar (per pair):   %6.2f ns/pair  %7.1f Mpairs/s\n", scalarNs, 1e3 / scalarNs);
+    std::printf("batch  (%-6s):     %6.2f ns/pair  %7.1f Mpairs/s  (%.2fx)\n",
+                geo::kernelName(), batchNs, 1e3 / batchNs, scalarNs / batchNs);
+    std::printf("max |batch - scalar|: %.3g km (rel %.3g)\n", maxAbs, maxRel);
+    return 0;
+}
@@ -0,0 +1,97 @@
+﻿// bench/bench_pool.cpp
+// Пропускна здатність читання (ShipsRepo::all / PortsRepo::all)
+// залежно від кількості потоків. Кожен потік бере своє з'єднання з пулу Db,
+// так само як IO-потоки Drogon при threads_num > 1.
+//
+// Запуск: OOP_DB_PATH=/tmp/bench.db ./oop_bench_pool [ships] [seconds]
+//         OOP_DB_PROFILE=bench ./oop_bench_pool  (in-memory: лише вартість застосунку)
+#include "db/Db.h"
+#include "repos/PortsRepo.h"
+#include "repos/ShipsRepo.h"
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void seed(int ships) {
+    sqlite3* db = Db::instance().handle();
+    sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+    sqlite3_exec(db,
+        "INSERT OR IGNORE INTO ports(name, region, lat, lon) "
+        "VALUES('Bench Port','Europe',51.9,4.4);",
+        nullptr, nullptr, nullptr);
+
+    sqlite3_stmt* st = nullptr;
+    sqlite3_prepare_v2(db,
+        "INSERT OR IGNORE INTO ships(name, type, country, port_id, status) "
+        "VALUES(?, 'cargo', 'Bench', (SELECT id FROM ports WHERE name='Bench Port'), 'docked');",
+        -1, &st, nullptr);
+    for (int i = 0; i < ships; ++i) {
+        const std::string name = "bench-ship-" + std::to_string(i);
+        sqlite3_bind_text(st, 1, name.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_step(st);
+        sqlite3_reset(st);
+    }
+    sqlite3_finalize(st);
+    sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (!std::getenv("OOP_DB_PATH") && !std::getenv("OOP_DB_PROFILE")) {
+        std::fprintf(stderr, "set OOP_DB_PATH to a scratch database or OOP_DB_PROFILE=bench\n");
+        return 2;
+    }
+
+    const int ships   = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const int seconds = argc > 2 ? std::atoi(argv[2]) : 3;
+
+    seed(ships);
+
+    const unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("threads  requests/s  (ships=%d, %ds per run)\n", ships, seconds);
+
+    std::vector<unsigned> counts;
+    for (unsigned n = 1; n < maxThreads; n *= 2) counts.push_back(n);
+    counts.push_back(maxThreads);
+
+    for (unsigned n : counts) {
+        std::atomic<bool> stop{false};
+        std::atomic<long long> done{0};
+
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < n; ++t) {
+            workers.emplace_back([&] {
+                ShipsRepo ships;
+                PortsRepo ports;
+                long long local = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    // Аналог GET /api/ships та GET /api/ports
+                    (void)ships.all();
+                    (void)ports.all();
+                    local += 2;
+                }
+                done += local;
+            });
+        }
+
+        std::this_thread::sleep_for(std::chrono::seconds(seconds));
+        stop = true;
+        for (auto& w : workers) w.join();
+
+        std::printf("%7u  %10.0f\n", n, static_cast<double>(done) / seconds);
+    }
+
+    std::printf("pool connections: %zu\n", Db::instance().poolSize());
+    return 0;
+}
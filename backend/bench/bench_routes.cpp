@@ -0,0 +1,75 @@
+﻿// bench/bench_routes.cpp
+// Матриця маршрутів усіх пар (geo::RouteMatrix): масштабування від 1 до N потоків
+// і час повторного відкриття збереженого файлу.
+//
+// Запуск: ./oop_bench_routes [ports] [max_threads] [matrix_path]
+#include "geo/RouteMatrix.h"
+#include "geo/RoutePlanner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::vector<Port> makePorts(std::size_t n) {
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> lat(-60.0, 70.0);
+    std::uniform_real_distribution<double> lon(-180.0, 180.0);
+
+    std::vector<Port> ports(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        ports[i].id = static_cast<std::int64_t>(i + 1);
+        ports[i].name = "P" + std::to_string(i + 1);
+        ports[i].lat = lat(rng);
+        ports[i].lon = lon(rng);
+    }
+    return ports;
+}
+
+double msSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000;
+    const unsigned maxThreads = argc > 2
+        ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10))
+        : std::max(1u, std::thread::hardware_concurrency());
+    const std::string path = argc > 3 ? argv[3] : "bench_route_matrix.bin";
+
+    auto t0 = std::chrono::steady_clock::now();
+    const auto graph = geo::buildRouteGraph(makePorts(n), {}, geo::RouteOptions{});
+    std::printf("graph: %zu ports, %zu directed edges, built in %.1f ms\n",
+                graph->size(), graph->targets.size(), msSince(t0));
+
+    std::vector<float> out(n * n);
+    double base = 0.0;
+    std::printf("%8s %12s %9s\n", "threads", "compute_ms", "speedup");
+    for (unsigned t = 1; t <= maxThreads; t *= 2) {
+        t0 = std::chrono::steady_clock::now();
+        geo::RouteMatrix::compute(*graph, out.data(), t);
+        const double ms = msSince(t0);
+        if (t == 1) base = ms;
+        std::printf("%8u %12.1f %8.2fx\n", t, ms, base / ms);
+        if (t < maxThreads && t * 2 > maxThreads) t = maxThreads / 2;   // останній крок — рівно N
+    }
+
+    auto& matrix = geo::RouteMatrix::instance();
+    t0 = std::chrono::steady_clock::now();
+    matrix.rebuild(*graph, path, maxThreads);
+    std::printf("rebuild to %s (%.1f MB): %.1f ms\n", path.c_str(),
+                (64.0 + 8.0 * n + 4.0 * n * n) / (1024.0 * 1024.0), msSince(t0));
+
+    t0 = std::chrono::steady_clock::now();
+    const bool ok = matrix.load(path, graph->fingerprint);
+    std::printf("reload (mmap): %s in %.3f ms\n", ok ? "ok" : "FAILED", msSince(t0));
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,74 @@
+﻿// bench/bench_stmt_cache.cpp
+// ShipsRepo::byId з кешем prepared statements і без нього.
+//
+// Запуск: OOP_DB_PATH=/tmp/bench.db ./oop_bench_stmt_cache [lookups]
+//         OOP_DB_PROFILE=bench ./oop_bench_stmt_cache  (in-memory: лише вартість застосунку)
+#include "db/Db.h"
+#include "repos/ShipsRepo.h"
+
+#include <sqlite3.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+constexpr int kShips = 1000;
+
+void seed() {
+    sqlite3* db = Db::instance().handle();
+    sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+    for (int i = 0; i < kShips; ++i) {
+        const std::string sql =
+            "INSERT OR IGNORE INTO ships(name, type, country, status) "
+            "VALUES('cache-bench-" + std::to_string(i) + "', 'cargo', 'Bench', 'docked');";
+        sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr);
+    }
+    sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+}
+
+double runLookups(int lookups) {
+    ShipsRepo repo;
+    long long found = 0;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookups; ++i) {
+        if (repo.byId(1 + i % kShips)) ++found;
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+
+    if (found == 0) std::printf("warning: no ships found\n");
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / lookups;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (!std::getenv("OOP_DB_PATH") && !std::getenv("OOP_DB_PROFILE")) {
+        std::fprintf(stderr, "set OOP_DB_PATH to a scratch database or OOP_DB_PROFILE=bench\n");
+        return 2;
+    }
+
+    const int lookups = argc > 1 ? std::atoi(argv[1]) : 200000;
+    seed();
+
+    Db& db = Db::instance();
+
+    db.setStmtCacheEnabled(false);
+    const double uncached = runLookups(lookups);
+
+    db.setStmtCacheEnabled(true);
+    const auto before = db.stmtCacheStats();
+    const double cached = runLookups(lookups);
+    const auto after = db.stmtCacheStats();
+
+    std::printf("byId without cache: %8.0f ns/lookup\n", uncached);
+    std::printf("byId with cache:    %8.0f ns/lookup  (%.2fx)\n", cached, uncached / cached);
+    std::printf("cache hits=%llu misses=%llu statements=%zu\n",
+                static_cast<unsigned long long>(after.hits - before.hits),
+                static_cast<unsigned long long>(after.misses - before.misses),
+                after.size);
+    return 0;
+}
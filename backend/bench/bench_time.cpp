@@ -0,0 +1,153 @@
+﻿// bench/bench_time.cpp
+// Розбір і форматування ISO-8601: util::Time проти std::get_time / strftime.
+// Дві серії міток: "журнал" (зростають кроком 0..50 мс, секунда повторюється)
+// і "розкид" (випадкові за 2000..2040 роки, кеш секунди не допомагає).
+//
+// Запуск: ./oop_bench_time [count]
+#include "util/Time.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+double msSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// timegm / gmtime_r — POSIX; у MSVC їх аналоги _mkgmtime / gmtime_s
+std::time_t toTimeUtc(std::tm* tm) {
+#ifdef _MSC_VER
+    return _mkgmtime(tm);
+#else
+    return timegm(tm);
+#endif
+}
+
+void toTmUtc(std::time_t sec, std::tm* tm) {
+#ifdef _MSC_VER
+    gmtime_s(tm, &sec);
+#else
+    gmtime_r(&sec, tm);
+#endif
+}
+
+// Старий шлях: istringstream + get_time, далі timegm (UTC) або mktime (локальна зона)
+util::EpochMs parseGetTime(const std::string& s, bool local) {
+    std::tm tm{};
+    std::istringstream in(s);
+    in >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
+    if (in.fail()) return -1;
+    long millis = 0;
+    if (in.peek() == '.') {
+        in.get();
+        int scale = 100;
+        while (std::isdigit(in.peek())) {
+            millis += (in.get() - '0') * scale;
+            scale /= 10;
+        }
+    }
+    const std::time_t sec = local ? std::mktime(&tm) : toTimeUtc(&tm);
+    return static_cast<util::EpochMs>(sec) * 1000 + millis;
+}
+
+std::string formatStrftime(util::EpochMs ms) {
+    const std::time_t sec = static_cast<std::time_t>(ms / 1000);
+    const int millis = static_cast<int>(ms % 1000);
+    std::tm tm{};
+    toTmUtc(sec, &tm);
+    char buf[32];
+    std::size_t n = std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm);
+    n += std::snprintf(buf + n, sizeof(buf) - n, ".%03d", millis);
+    buf[n++] = 'Z';
+    return std::string(buf, n);
+}
+
+template <class F>
+void run(const char* name, std::size_t n, F&& f) {
+    const auto t0 = std::chrono::steady_clock::now();
+    const std::size_t sink = f();
+    const double ms = msSince(t0);
+    std::printf("  %-28s %9.1f ms %8.1f ns/op  (sink %zu)\n", name, ms, ms * 1e6 / n, sink);
+}
+
+void benchSeries(const char* title, const std::vector<util::EpochMs>& ts) {
+    const std::size_t n = ts.size();
+    std::printf("%s: %zu timestamps\n", title, n);
+
+    std::vector<std::string> iso;
+    iso.reserve(n);
+    for (util::EpochMs t : ts) iso.push_back(util::formatIsoMs(t));
+
+    // Перевірка: усі шляхи дають ті самі значення
+    std::size_t bad = 0, badLocal = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (formatStrftime(ts[i]) != iso[i]) ++bad;
+        if (util::parseIsoMs(iso[i]) != ts[i]) ++bad;
+        if (parseGetTime(iso[i], false) != ts[i]) ++bad;
+        if (parseGetTime(iso[i], true) != ts[i]) ++badLocal;
+    }
+    std::printf("  check: %zu mismatches; get_time+mktime off in %zu of %zu (TZ=%s)\n",
+                bad, badLocal, n, std::getenv("TZ") ? std::getenv("TZ") : "<unset>");
+
+    run("parse get_time+timegm", n, [&] {
+        std::size_t s = 0;
+        for (const auto& v : iso) s += static_cast<std::size_t>(parseGetTime(v, false));
+        return s;
+    });
+    run("parse util::parseIsoMs", n, [&] {
+        std::size_t s = 0;
+        for (const auto& v : iso) s += static_cast<std::size_t>(*util::parseIsoMs(v));
+        return s;
+    });
+    run("format gmtime_r+strftime", n, [&] {
+        std::size_t s = 0;
+        for (util::EpochMs t : ts) s += formatStrftime(t).size();
+        return s;
+    });
+    run("format util::formatIso", n, [&] {
+        std::size_t s = 0;
+        for (util::EpochMs t : ts) s += util::formatIso(t).view().size();
+        return s;
+    });
+    run("format IsoFormatter (cache)", n, [&] {
+        util::IsoFormatter f;
+        std::size_t s = 0;
+        for (util::EpochMs t : ts) s += f.format(t).view().size();
+        return s;
+    });
+    run("format util::formatIsoMs", n, [&] {
+        std::size_t s = 0;
+        for (util::EpochMs t : ts) s += util::formatIsoMs(t).size();
+        return s;
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    std::mt19937_64 rng(42);
+
+    std::vector<util::EpochMs> log(n);
+    std::uniform_int_distribution<int> step(0, 50);
+    util::EpochMs t = *util::parseIsoMs("2024-03-01T08:00:00Z");
+    for (auto& v : log) v = t += step(rng);
+
+    std::vector<util::EpochMs> spread(n);
+    std::uniform_int_distribution<util::EpochMs> any(*util::parseIsoMs("2000-01-01"),
+                                                     *util::parseIsoMs("2040-01-01"));
+    for (auto& v : spread) v = any(rng);
+
+    benchSeries("log", log);
+    benchSeries("spread", spread);
+    return 0;
+}
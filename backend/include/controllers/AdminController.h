@@ -0,0 +1,19 @@
+﻿#pragma once
+
+#include <drogon/HttpController.h>
+#include <functional>
+
+// Адмін-API (онлайн-копія БД). Доступ — Bearer/?token= з OOP_ADMIN_TOKEN;
+// без цієї змінної ендпоінти відповідають 503.
+class AdminController : public drogon::HttpController<AdminController> {
+public:
+    using Callback = std::function<void(const drogon::HttpResponsePtr&)>;
+
+    METHOD_LIST_BEGIN
+        ADD_METHOD_TO(AdminController::startBackup,  "/api/admin/backup", drogon::Post);
+        ADD_METHOD_TO(AdminController::backupStatus, "/api/admin/backup", drogon::Get);
+    METHOD_LIST_END
+
+    void startBackup (const drogon::HttpRequestPtr& req, Callback&& cb);
+    void backupStatus(const drogon::HttpRequestPtr& req, Callback&& cb);
+};
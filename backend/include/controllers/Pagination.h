@@ -0,0 +1,98 @@
+﻿// include/controllers/Pagination.h
+#pragma once
+
+#include "repos/Page.h"
+#include "util/Cursor.h"
+
+#include <drogon/drogon.h>
+#include <json/json.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+// Спільний шар пагінації для list-ендпоінтів: ?limit=&after=<cursor>.
+// Тіло відповіді лишається JSON-масивом (як і без пагінації), а посилання
+// на наступну сторінку йде в заголовках:
+//   Link: </api/ships?limit=100&after=...>; rel="next"
+//   X-Next-Cursor: ...
+// Запит без limit/after повертає весь список, як раніше.
+namespace pagination {
+
+constexpr int kDefaultLimit = 100;
+constexpr int kMaxLimit     = 1000;
+
+// Чи просив клієнт пагінацію
+inline bool requested(const drogon::HttpRequestPtr& req) {
+    return !req->getParameter("limit").empty() || !req->getParameter("after").empty();
+}
+
+inline bool parseLimit(const std::string& v, int& out) {
+    if (v.empty()) return true;
+    if (v.size() > 9 || v.find_first_not_of("0123456789") != std::string::npos) return false;
+    out = std::stoi(v);
+    return out >= 1 && out <= kMaxLimit;
+}
+
+// Розбір limit і курсора; keys — ключі з курсора (порожньо, якщо after нема).
+// false — некоректні параметри, err містить причину.
+inline bool parse(const drogon::HttpRequestPtr& req, int& limit,
+                  std::vector<std::int64_t>& keys, std::size_t keyCount, std::string& err) {
+    limit = kDefaultLimit;
+    if (!parseLimit(req->getParameter("limit"), limit)) {
+        err = "limit must be integer 1.." + std::to_string(kMaxLimit);
+        return false;
+    }
+
+    keys.clear();
+    const auto& after = req->getParameter("after");
+    if (!after.empty()) {
+        auto decoded = util::decodeCursor(after);
+        if (!decoded || decoded->size() != keyCount) {
+            err = "invalid cursor";
+            return false;
+        }
+        keys = std::move(*decoded);
+    }
+    return true;
+}
+
+// Для таблиць з ключем id
+inline bool parse(const drogon::HttpRequestPtr& req, PageRequest& out, std::string& err) {
+    std::vector<std::int64_t> keys;
+    if (!parse(req, out.limit, keys, 1, err)) return false;
+    out.after = keys.empty() ? 0 : keys[0];
+    return true;
+}
+
+// Заголовки Link/X-Next-Cursor; інші параметри запиту (фільтри) зберігаються
+inline void setNext(const drogon::HttpRequestPtr& req, const drogon::HttpResponsePtr& resp,
+                    int limit, const std::string& cursor) {
+    std::string url = req->path() + "?";
+    for (const auto& [k, v] : req->getParameters()) {
+        if (k == "after" || k == "offset" || k == "limit") continue;
+        url += drogon::utils::urlEncodeComponent(k) + "=" + drogon::utils::urlEncodeComponent(v) + "&";
+    }
+    url += "limit=" + std::to_string(limit) + "&after=" + cursor;
+
+    resp->addHeader("Link", "<" + url + ">; rel=\"next\"");
+    resp->addHeader("X-Next-Cursor", cursor);
+}
+
+// Відповідь для сторінки з ключем id
+template <class T, class ToJson>
+drogon::HttpResponsePtr response(const drogon::HttpRequestPtr& req, const Page<T>& page,
+                                 int limit, ToJson toJson) {
+    Json::Value arr(Json::arrayValue);
+    for (const auto& item : page.items) {
+        arr.append(toJson(item));
+    }
+    auto resp = drogon::HttpResponse::newHttpJsonResponse(arr);
+    if (page.hasMore && !page.items.empty()) {
+        setNext(req, resp, limit, util::encodeCursor({page.items.back().id}));
+    }
+    return resp;
+}
+
+} // namespace pagination
@@ -11,9 +11,13 @@ public:
     METHOD_LIST_BEGIN
         ADD_METHOD_TO(PortsController::list,   "/api/ports",     drogon::Get);
         ADD_METHOD_TO(PortsController::create, "/api/ports",     drogon::Post);
+        // статичні шляхи — до /api/ports/{1}, щоб "nearest" не став id
+        ADD_METHOD_TO(PortsController::nearest, "/api/ports/nearest", drogon::Get);
+        ADD_METHOD_TO(PortsController::within,  "/api/ports/within",  drogon::Get);
         ADD_METHOD_TO(PortsController::getOne, "/api/ports/{1}", drogon::Get);
         ADD_METHOD_TO(PortsController::update, "/api/ports/{1}", drogon::Put);
         ADD_METHOD_TO(PortsController::remove, "/api/ports/{1}", drogon::Delete);
+        ADD_METHOD_TO(PortsController::distances, "/api/ports/{1}/distances", drogon::Get);
     METHOD_LIST_END
 
     void list  (const drogon::HttpRequestPtr& req, Callback&& cb);
@@ -21,4 +25,10 @@ public:
     void getOne(const drogon::HttpRequestPtr& req, Callback&& cb, std::int64_t id);
     void update(const drogon::HttpRequestPtr& req, Callback&& cb, std::int64_t id);
     void remove(const drogon::HttpRequestPtr& req, Callback&& cb, std::int64_t id);
+    // ?lat=&lon=&k= — k найближчих портів (geo::PortIndex)
+    void nearest(const drogon::HttpRequestPtr& req, Callback&& cb);
+    // ?lat=&lon=&radius_km= — порти в радіусі
+    void within (const drogon::HttpRequestPtr& req, Callback&& cb);
+    // Відстані від порту до всіх інших (рядок geo::DistanceMatrix)
+    void distances(const drogon::HttpRequestPtr& req, Callback&& cb, std::int64_t id);
 };
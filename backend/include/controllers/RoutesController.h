@@ -0,0 +1,23 @@
+﻿#pragma once
+
+#include <drogon/HttpController.h>
+#include <cstdint>
+#include <functional>
+
+class RoutesController : public drogon::HttpController<RoutesController> {
+public:
+    using Callback = std::function<void(const drogon::HttpResponsePtr&)>;
+
+    METHOD_LIST_BEGIN
+        ADD_METHOD_TO(RoutesController::plan, "/api/routes", drogon::Get);
+        ADD_METHOD_TO(RoutesController::matrixStatus, "/api/routes/matrix", drogon::Get);
+        ADD_METHOD_TO(RoutesController::matrixRow, "/api/routes/matrix/{1}", drogon::Get);
+    METHOD_LIST_END
+
+    // ?from=&to= — найкоротший маршрут портами (geo::RoutePlanner, A*)
+    void plan(const drogon::HttpRequestPtr& req, Callback&& cb);
+    // Стан фонової матриці маршрутів усіх пар (geo::RouteMatrix)
+    void matrixStatus(const drogon::HttpRequestPtr& req, Callback&& cb);
+    // Довжини маршрутів від порту до всіх інших (рядок матриці)
+    void matrixRow(const drogon::HttpRequestPtr& req, Callback&& cb, std::int64_t id);
+};
@@ -11,6 +11,8 @@ public:
     METHOD_LIST_BEGIN
         ADD_METHOD_TO(ShipsController::list,      "/api/ships",     drogon::Get);
         ADD_METHOD_TO(ShipsController::create,    "/api/ships",     drogon::Post);
+        ADD_METHOD_TO(ShipsController::bulkCreate, "/api/ships/bulk", drogon::Post);
+        ADD_METHOD_TO(ShipsController::positions, "/api/ships/positions", drogon::Get);
         ADD_METHOD_TO(ShipsController::getOne,    "/api/ships/{1}", drogon::Get);
         ADD_METHOD_TO(ShipsController::updateOne, "/api/ships/{1}", drogon::Put);
         ADD_METHOD_TO(ShipsController::deleteOne, "/api/ships/{1}", drogon::Delete);
@@ -19,6 +21,10 @@ public:
 
     void list     (const drogon::HttpRequestPtr& req, Callback&& cb);
     void create   (const drogon::HttpRequestPtr& req, Callback&& cb);
+    // Масовий імпорт: JSON-масив або NDJSON (один об'єкт на рядок)
+    void bulkCreate(const drogon::HttpRequestPtr& req, Callback&& cb);
+    // Поточні координати всіх кораблів у дорозі
+    void positions(const drogon::HttpRequestPtr& req, Callback&& cb);
     void getOne   (const drogon::HttpRequestPtr& req, Callback&& cb, std::int64_t id);
     void updateOne(const drogon::HttpRequestPtr& req, Callback&& cb, std::int64_t id);
     void deleteOne(const drogon::HttpRequestPtr& req, Callback&& cb, std::int64_t id);
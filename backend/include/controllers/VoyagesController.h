@@ -0,0 +1,22 @@
+﻿#pragma once
+
+#include <drogon/HttpController.h>
+#include <functional>
+
+class VoyagesController : public drogon::HttpController<VoyagesController> {
+public:
+    using Callback = std::function<void(const drogon::HttpResponsePtr&)>;
+
+    METHOD_LIST_BEGIN
+        ADD_METHOD_TO(VoyagesController::list,        "/api/voyages",              drogon::Get);
+        ADD_METHOD_TO(VoyagesController::routeStats,  "/api/voyages/stats/routes", drogon::Get);
+        ADD_METHOD_TO(VoyagesController::shipStats,   "/api/voyages/stats/ships",  drogon::Get);
+    METHOD_LIST_END
+
+    // ?ship_id=&limit=&after= — журнал рейсів, keyset-сторінки за id
+    void list(const drogon::HttpRequestPtr& req, Callback&& cb);
+    // ?origin=&destination=&since=&until= — середній час переходу по маршрутах
+    void routeStats(const drogon::HttpRequestPtr& req, Callback&& cb);
+    // ?ship_id=&since=&until= — час у морі і завантаженість кораблів
+    void shipStats(const drogon::HttpRequestPtr& req, Callback&& cb);
+};
@@ -0,0 +1,78 @@
+﻿// include/db/AuditLog.h
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Один рядок таблиці logs
+struct LogRecord {
+    std::int64_t ts{0};     // мс від epoch (UTC)
+    std::string level;
+    std::string event_type;
+    std::string entity;
+    int         entity_id{0};
+    std::string user;
+    std::string message;
+};
+
+enum class AuditLogMode {
+    Sync,   // рядок пишеться в запиті (строго, кожен insert — окремий commit)
+    Async   // рядок стає в чергу, фоновий потік пише пачками в одній транзакції
+};
+
+struct AuditLogOptions {
+    AuditLogMode mode{AuditLogMode::Sync};
+    std::size_t  batchRows{256};        // commit, щойно набралось стільки рядків
+    int          flushIntervalMs{50};   // ... або минув цей час
+    std::size_t  capacity{16384};       // розмір кільцевого буфера
+    int          retentionMonths{0};    // скільки помісячних партицій журналу тримати; 0 — усі
+};
+
+// Обмежена черга (кільцевий буфер) + фоновий писач.
+// Якщо буфер заповнений, enqueue повертає false і викликач пише синхронно,
+// тож переповнення рядків не губить. Пачку, яку не вдалось записати,
+// писач повторює з паузою, а далі пише рядки поодинці; втрачається (з
+// повідомленням у stderr) лише рядок, що не записався й окремо.
+class AuditLogWriter {
+public:
+    using Sink = std::function<void(std::vector<LogRecord>&)>;
+
+    AuditLogWriter(const AuditLogOptions& opts, Sink sink);
+    ~AuditLogWriter();  // дописує чергу і зупиняє потік
+
+    bool enqueue(LogRecord&& r);
+
+    // Блокує, доки все поставлене в чергу до цього моменту не записано
+    void flush();
+
+    AuditLogWriter(const AuditLogWriter&) = delete;
+    AuditLogWriter& operator=(const AuditLogWriter&) = delete;
+
+private:
+    void run();
+    void writeBatch(std::vector<LogRecord>& batch);
+
+    AuditLogOptions opts_;
+    Sink sink_;
+
+    std::mutex mu_;
+    std::condition_variable wake_;   // писачу: є робота / flush / stop
+    std::condition_variable done_;   // flush(): пачку записано
+
+    std::vector<LogRecord> ring_;
+    std::size_t head_{0};            // звідки читає писач
+    std::size_t size_{0};
+
+    std::uint64_t enqueued_{0};
+    std::uint64_t written_{0};
+    std::uint64_t flushTarget_{0};
+    bool stop_{false};
+
+    std::thread thread_;
+};
@@ -0,0 +1,75 @@
+﻿// include/db/Backup.h
+#pragma once
+
+// Forward declaration замість важкого include
+struct sqlite3;
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Онлайн-копія БД через sqlite3_backup_*.
+// Копіюємо порціями сторінок з паузою між ними, щоб не тримати БД зайнятою.
+// У WAL-режимі джерело читається з одного знімка (read-транзакція на весь час
+// копії): писачі не блокуються, а копія не перезапускається від їхніх змін.
+
+enum class BackupState { Idle, Running, Done, Failed, Cancelled };
+
+const char* toString(BackupState s) noexcept;
+
+struct BackupOptions {
+    int pagesPerStep{256};   // сторінок за один sqlite3_backup_step
+    int pauseMs{5};          // пауза між порціями — вікно для інших з'єднань
+};
+
+struct BackupStatus {
+    BackupState state{BackupState::Idle};
+    std::string dest;
+    int         totalPages{0};
+    int         remainingPages{0};
+    int         steps{0};
+    double      elapsedMs{0};
+    std::string error;
+
+    double percent() const noexcept {
+        return totalPages > 0 ? 100.0 * (totalPages - remainingPages) / totalPages : 0.0;
+    }
+};
+
+// Блокуюча копія src ("main") у файл dest.
+// Пишемо спочатку у dest + ".part" і перейменовуємо після успіху,
+// тож dest ніколи не буває напівзаписаним.
+// progress викликається після кожної порції; false — скасувати копію.
+// Кидає std::runtime_error при помилці SQLite або файлової системи.
+BackupStatus runBackup(sqlite3* src,
+                       const std::string& dest,
+                       const BackupOptions& opts,
+                       const std::function<bool(const BackupStatus&)>& progress = {});
+
+// Одна фонова копія на процес (адмін-ендпоінт)
+class BackupService {
+public:
+    static BackupService& instance();
+
+    // false, якщо попередня копія ще триває
+    bool start(const std::string& dest, const BackupOptions& opts = {});
+    BackupStatus status() const;
+
+    // <каталог БД>/backups/app-YYYYMMDD-HHMMSS.db
+    static std::string defaultDestination();
+    static std::string backupDir();
+
+    BackupService(const BackupService&) = delete;
+    BackupService& operator=(const BackupService&) = delete;
+
+private:
+    BackupService() = default;
+    ~BackupService();
+
+    mutable std::mutex mu_;
+    BackupStatus status_;
+    std::thread worker_;
+    std::atomic<bool> stop_{false};
+};
@@ -0,0 +1,125 @@
+﻿// include/db/ChangeFeed.h
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Таблиці, зміни яких публікуються (журнал logs_* і службові — ні)
+enum class ChangeTable : std::uint8_t {
+    Ports,
+    ShipTypes,
+    People,
+    Companies,
+    Ships,
+    CompanyPorts,
+    CrewAssignments,
+    Count_
+};
+
+enum class ChangeOp : std::uint8_t { Insert, Update, Delete };
+
+// ChangeTable::Count_ — таблиця не відстежується
+ChangeTable changeTableFromName(std::string_view name) noexcept;
+const char* toString(ChangeTable t) noexcept;
+const char* toString(ChangeOp op) noexcept;
+
+struct ChangeEvent {
+    ChangeTable   table{ChangeTable::Count_};
+    ChangeOp      op{ChangeOp::Insert};
+    std::int64_t  rowid{0};
+    std::uint64_t commitSeq{0};   // номер коміту, у якому зміна стала видимою
+};
+
+// Потік змін даних (CDC) у межах процесу.
+//
+// Db збирає події sqlite3_update_hook по з'єднанню, на commit_hook дає їм
+// commit_seq (під write-локом SQLite, тож порядок seq = порядок комітів)
+// і публікує сюди вже ПІСЛЯ успішного COMMIT — підписник, який перечитує
+// рядок, гарантовано бачить нові дані.
+//
+// Публікація lock-free: кільцевий буфер фіксованого розміру. Позиції в
+// кільці резервуються разом з commit_seq у commit_hook (reserve), тож
+// порядок у кільці = порядок комітів; після COMMIT події пишуться у свої
+// слоти (publish). Підписник не проходить далі зарезервованого, але ще
+// не записаного слоту. Слот захоплюється CAS-ом, тож два публікатори з
+// різних кіл ніколи не пишуть його одночасно, а старе коло не затирає нове.
+// Підписник читає зі своїм курсором; якщо відстав більше ніж на розмір
+// кільця — отримує lost() і має перечитати стан з БД. Семантика «хоча б
+// раз»: зайва подія (напр. з відкоченого statement) можлива, пропущена — ні.
+// commit_seq монотонний, але не неперервний і живе лише в межах процесу.
+class ChangeFeed {
+public:
+    static constexpr std::size_t kDefaultCapacity = 4096;  // степінь двійки
+
+    explicit ChangeFeed(std::size_t capacity = kDefaultCapacity);
+
+    // Виділити номер наступного коміту (викликається з commit_hook)
+    std::uint64_t nextCommitSeq() noexcept {
+        return seqAlloc_.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    // Зарезервувати n позицій кільця; повертає першу. Викликати там же,
+    // де nextCommitSeq (під write-локом), і обов'язково потім publish —
+    // інакше підписники зупиняться на незаписаному слоті.
+    std::uint64_t reserve(std::size_t n) noexcept {
+        return head_.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    // Записати події одного коміту в зарезервовані позиції first..first+n-1
+    void publish(std::uint64_t first, const ChangeEvent* events, std::size_t n) noexcept;
+
+    // Найбільший опублікований commit_seq — версія даних для HTTP (ETag тощо)
+    std::uint64_t commitSeq() const noexcept { return lastSeq_.load(std::memory_order_acquire); }
+
+    // Останній commit_seq, що змінив таблицю (0 — змін не було)
+    std::uint64_t tableSeq(ChangeTable t) const noexcept {
+        return tableSeq_[static_cast<std::size_t>(t)].load(std::memory_order_acquire);
+    }
+
+    class Subscriber {
+    public:
+        explicit Subscriber(const ChangeFeed& feed) noexcept;
+
+        // Дочитати до max нових подій в out; повертає кількість
+        std::size_t poll(std::vector<ChangeEvent>& out, std::size_t max = SIZE_MAX);
+
+        // Підписник відстав і частина подій перезаписана — треба ресинк
+        bool lost() const noexcept { return lost_; }
+        void clearLost() noexcept { lost_ = false; }
+
+    private:
+        const ChangeFeed* feed_;
+        std::uint64_t cursor_;
+        bool lost_{false};
+    };
+
+    Subscriber subscribe() const noexcept { return Subscriber(*this); }
+
+    ChangeFeed(const ChangeFeed&) = delete;
+    ChangeFeed& operator=(const ChangeFeed&) = delete;
+
+private:
+    // Подія зберігається атомарними словами, щоб читання під час
+    // перезапису слоту не було гонкою даних (seqlock перевіряє seq)
+    struct Slot {
+        std::atomic<std::uint64_t> seq{0};    // позиція + 1; kWriting — слот пишеться
+        std::atomic<std::uint64_t> kind{0};   // table | op << 8
+        std::atomic<std::int64_t>  rowid{0};
+        std::atomic<std::uint64_t> commitSeq{0};
+    };
+
+    static constexpr std::uint64_t kWriting = ~std::uint64_t{0};
+
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t mask_;
+
+    std::atomic<std::uint64_t> head_{0};      // наступна незарезервована позиція кільця
+    std::atomic<std::uint64_t> seqAlloc_{0};
+    std::atomic<std::uint64_t> lastSeq_{0};
+    std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(ChangeTable::Count_)> tableSeq_{};
+};
@@ -3,13 +3,43 @@
 
 // Forward declaration замість важкого include
 struct sqlite3;
+struct sqlite3_stmt;
+#include "db/AuditLog.h"
+#include "db/ChangeFeed.h"
+#include "db/DbOptions.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+
+// Лічильники кешу prepared statements
+struct StmtCacheStats {
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+    std::size_t   size{0};    // кількість закешованих statements в усіх з'єднаннях
+};
 
 class Db {
 public:
+    class Transaction;
+
     static Db& instance(); // <-- без noexcept
 
-    sqlite3* handle() const noexcept { return db_; }
+    // Параметри сховища. Діють лише якщо викликано до першого instance();
+    // пізніший виклик кидає std::logic_error.
+    static void configure(const DbOptions& opts);
+    const DbOptions& options() const noexcept { return opts_; }
+    const std::string& path() const noexcept { return path_; }
+
+    // З'єднання поточного потоку.
+    // Кожен потік (IO-потік Drogon, фоновий воркер) при першому зверненні
+    // бере окреме з'єднання з пулу і тримає його до свого завершення.
+    // У WAL-режимі читання йдуть паралельно, а записи серіалізує сама SQLite.
+    sqlite3* handle();
 
     void runMigrations();  // створення/оновлення схеми
     void insertLog(const std::string &level,
@@ -20,6 +50,30 @@ public:
                    const std::string &message);
     void reset();          // очистка даних для тестів
 
+    // Режим запису аудиту (sync/async). Викликати до старту сервера.
+    void configureAuditLog(const AuditLogOptions& opts);
+    AuditLogMode auditLogMode() const noexcept { return auditOpts_.mode; }
+
+    // Дочекатись запису всіх рядків аудиту, поставлених у чергу
+    void flushLogs();
+
+    // Журнал зберігається помісячними партиціями logs_YYYYMM за view `logs`.
+    // Видаляє партиції, старші за auditLog retentionMonths; повертає їх кількість.
+    int dropExpiredLogPartitions();
+    std::vector<std::string> logPartitions();
+
+    // Кількість відкритих з'єднань у пулі (зайнятих + вільних)
+    std::size_t poolSize();
+
+    // Потік змін (insert/update/delete) з commit_seq, див. db/ChangeFeed.h.
+    // commitSeq() — версія даних: росте з кожним комітом, що змінив таблиці.
+    ChangeFeed& changes() noexcept { return changes_; }
+    std::uint64_t commitSeq() const noexcept { return changes_.commitSeq(); }
+
+    // Кеш prepared statements (див. db/Stmt.h)
+    StmtCacheStats stmtCacheStats();
+    void setStmtCacheEnabled(bool enabled) noexcept { stmtCacheEnabled_ = enabled; }
+
     Db(const Db&) = delete;
     Db& operator=(const Db&) = delete;
     Db(Db&&) = delete;
@@ -29,5 +83,80 @@ private:
     Db();
     ~Db();
 
-    sqlite3* db_{nullptr};
+    struct Connection;
+
+    friend struct ThreadConnection;
+    friend class Stmt;
+
+    std::unique_ptr<Connection> openConnection() const;
+    Connection* acquire();
+    void release(Connection* c);
+    Connection* current();
+
+    // Видати statement для SQL: з кешу з'єднання або щойно підготовлений.
+    // slot != nullptr означає, що statement належить кешу і повертається
+    // через giveBackStmt; інакше його треба фіналізувати.
+    sqlite3_stmt* takeStmt(sqlite3* db, const char* sql, bool*& slot);
+    static void giveBackStmt(sqlite3_stmt* st, bool* slot) noexcept;
+
+    // CDC: hooks з'єднання і публікація закомічених подій
+    void attachChangeHooks(Connection* c);
+    Connection* ownConnection(sqlite3* db) noexcept;
+    void publishChanges(sqlite3* db) noexcept;
+    void publishCommitted(Connection* c) noexcept;
+    void flushCommittedLogs(Connection* c) noexcept;
+
+    void writeLogRow(sqlite3* db, const LogRecord& r);
+    void ensureLogPartition(sqlite3* db, int month);
+    void writeLogBatch(std::vector<LogRecord>& rows);
+
+    DbOptions opts_;
+    std::string path_;               // фактичний шлях або URI для sqlite3_open_v2
+    sqlite3* db_{nullptr};           // основне з'єднання (міграції)
+
+    std::mutex poolMu_;
+    std::vector<Connection*> idle_;                   // вільні з'єднання
+    std::vector<std::unique_ptr<Connection>> conns_;  // усі відкриті з'єднання
+
+    std::atomic<bool> stmtCacheEnabled_{true};
+    std::atomic<std::uint64_t> stmtHits_{0};
+    std::atomic<std::uint64_t> stmtMisses_{0};
+    std::atomic<std::size_t>   stmtCached_{0};
+
+    ChangeFeed changes_;
+
+    AuditLogOptions auditOpts_;
+    std::atomic<int> logMonth_{0};   // YYYYMM партиції, що точно існує
+    std::mutex logPartitionMu_;
+    std::unique_ptr<AuditLogWriter> auditWriter_;
+};
+
+// Одиниця роботи (RAII).
+// Зовнішня транзакція — BEGIN IMMEDIATE (write-лок береться одразу, тож
+// перевірка-потім-запис не ловить SQLITE_BUSY посеред дії); вкладена —
+// SAVEPOINT, тож репозиторій може відкрити свою транзакцію і приєднатись
+// до транзакції контролера. Без commit() деструктор робить rollback.
+// Рядки аудиту (insertLog) всередині транзакції комітяться разом зі зміною
+// і зникають при rollback: у sync-режимі пишуться в неї ж, в async —
+// накопичуються на з'єднанні і йдуть у чергу писача після COMMIT.
+class Db::Transaction {
+public:
+    Transaction();                     // з'єднання поточного потоку
+    explicit Transaction(sqlite3* db); // явне з'єднання (DI, напр. PortsRepo)
+    ~Transaction();
+
+    void commit();
+    void rollback();
+
+    bool nested() const noexcept { return nested_; }
+
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+
+private:
+    sqlite3* db_;
+    bool nested_;
+    bool done_{false};
+    std::size_t changeMark_{0};  // скільки подій CDC було до savepoint
+    std::size_t logMark_{0};     // скільки рядків аудиту було до savepoint
 };
@@ -0,0 +1,35 @@
+﻿// include/db/DbOptions.h
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Параметри сховища SQLite.
+// Профілі:
+//   durable     — WAL + synchronous=FULL: жоден commit не губиться навіть при збої живлення
+//   balanced    — WAL + synchronous=NORMAL (за замовчуванням)
+//   bench       — in-memory БД, без журналу на диску: чиста вартість застосунку
+//   bench-tmpfs — файл у /dev/shm, WAL без fsync: файловий шлях без вартості диска
+struct DbOptions {
+    std::string  profile{"balanced"};
+    std::string  path;                 // порожній -> <проєкт>/data/app.db; ":memory:" -> in-memory
+    std::string  journalMode{"WAL"};   // DELETE | TRUNCATE | PERSIST | MEMORY | WAL | OFF
+    std::string  synchronous{"NORMAL"};// OFF | NORMAL | FULL | EXTRA
+    int          cacheSizeKb{65536};   // PRAGMA cache_size = -cacheSizeKb
+    std::int64_t mmapSize{0};          // PRAGMA mmap_size, байти
+
+    // Кидає std::invalid_argument для невідомого профілю
+    static DbOptions forProfile(const std::string& name);
+
+    // Профіль з OOP_DB_PROFILE (або defaultProfile) + перекриття з оточення
+    static DbOptions fromEnv(const std::string& defaultProfile);
+
+    // Перекриття окремих полів змінними оточення:
+    // OOP_DB_PATH, OOP_DB_JOURNAL_MODE, OOP_DB_SYNCHRONOUS, OOP_DB_CACHE_SIZE_KB, OOP_DB_MMAP_SIZE
+    void applyEnv();
+
+    // Перевіряє значення, що підставляються в PRAGMA; кидає std::invalid_argument
+    void validate() const;
+
+    bool inMemory() const noexcept { return path == ":memory:"; }
+};
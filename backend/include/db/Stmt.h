@@ -0,0 +1,27 @@
+﻿// include/db/Stmt.h
+#pragma once
+
+#include <sqlite3.h>
+
+#include <string>
+
+// RAII-обгортка над sqlite3_stmt.
+// Statement береться з кешу з'єднання в Db (ключ — текст SQL),
+// а в деструкторі скидається (reset + clear_bindings) і повертається в кеш.
+// Тож SQLite парсить і планує кожен запит лише раз на з'єднання.
+class Stmt {
+public:
+    Stmt(sqlite3* db, const char* sql);
+    Stmt(sqlite3* db, const std::string& sql) : Stmt(db, sql.c_str()) {}
+
+    ~Stmt();
+
+    sqlite3_stmt* get() const noexcept { return st_; }
+
+    Stmt(const Stmt&) = delete;
+    Stmt& operator=(const Stmt&) = delete;
+
+private:
+    sqlite3_stmt* st_{nullptr};
+    bool* slot_{nullptr};  // слот у кеші (nullptr — statement не закешований)
+};
@@ -0,0 +1,60 @@
+﻿// include/geo/DistanceMatrix.h
+#pragma once
+
+#include "models/Port.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace geo {
+
+// Щільна матриця відстаней порт-порт (км, float: ~1 м на 20000 км).
+// Будується паралельно на старті з PortsRepo::all(); зміна одного порту
+// перераховує лише його рядок і стовпець (O(ports) тригонометрії).
+// Видалений порт лишає «дірку»; дірки ущільнюються, коли матриці бракує
+// місця (reserveLocked) або при build().
+class DistanceMatrix {
+public:
+    static DistanceMatrix& instance();
+
+    // Повна перебудова; threads == 0 — за кількістю ядер
+    void build(const std::vector<Port>& ports, unsigned threads = 0);
+
+    // create/update порту: патч рядка і стовпця
+    void upsert(const Port& p);
+    void remove(std::int64_t portId);
+
+    std::optional<double> distanceKm(std::int64_t from, std::int64_t to) const;
+
+    struct Entry {
+        std::int64_t portId;
+        double distanceKm;
+    };
+
+    // Рядок порту: відстані до всіх інших портів. false — порт невідомий.
+    bool row(std::int64_t portId, std::vector<Entry>& out) const;
+
+    // Координати портів ids[0..n) під одним локом; невідомий порт — NaN.
+    // Повертає кількість знайдених.
+    std::size_t coordsOf(const std::int64_t* ids, std::size_t n, double* lat, double* lon) const;
+
+    std::size_t size() const;   // живі порти
+
+private:
+    void reserveLocked(std::size_t slots);
+    void patchLocked(std::size_t slot);
+
+    mutable std::shared_mutex mu_;
+
+    std::size_t stride_{0};             // місткість рядка (слотів)
+    std::vector<float> dist_;           // stride_ * stride_, рядок slot — з slot * stride_
+    std::vector<std::int64_t> ids_;     // id порту слота; 0 — видалений
+    std::vector<double> lat_, lon_;     // координати слотів (SoA для ядра)
+    std::unordered_map<std::int64_t, std::size_t> slotOf_;
+};
+
+} // namespace geo
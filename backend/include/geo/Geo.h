@@ -0,0 +1,71 @@
+﻿// include/geo/Geo.h
+#pragma once
+
+#include "models/Port.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Геометрія рейсів: відстань по великому колу (haversine) і ETA.
+// Координати — градуси, відстані — км, як у frontend (common.haversine_distance).
+namespace geo {
+
+constexpr double kEarthRadiusKm = 6371.0;
+constexpr double kKmPerNauticalMile = 1.852;   // 1 вузол = 1.852 км/год
+
+// Координати портів structure-of-arrays: lat[i], lon[i] — порт ids[i].
+// Пакетне ядро читає суцільні масиви, без Port з рядками посередині.
+struct PortCoords {
+    std::vector<std::int64_t> ids;
+    std::vector<double> lat;
+    std::vector<double> lon;
+
+    std::size_t size() const noexcept { return ids.size(); }
+    void reserve(std::size_t n);
+    void push_back(std::int64_t id, double latDeg, double lonDeg);
+};
+
+// Одна пара точок (скалярна формула, еталон для ядра)
+double haversineKm(double lat1, double lon1, double lat2, double lon2) noexcept;
+
+// Пакетне ядро: out[i] = haversineKm(lat1[i], lon1[i], lat2[i], lon2[i]).
+// AVX2+FMA, якщо процесор підтримує (перевірка один раз), інакше скалярне.
+// Результат AVX2 відрізняється від скалярного в межах ~1e-9 відносно.
+void haversineKm(const double* lat1, const double* lon1,
+                 const double* lat2, const double* lon2,
+                 double* out, std::size_t n) noexcept;
+
+// Одна точка до багатьох: out[i] = haversineKm(lat, lon, lat2[i], lon2[i])
+void haversineKm(double lat, double lon,
+                 const double* lat2, const double* lon2,
+                 double* out, std::size_t n) noexcept;
+
+// Точка на великому колі (slerp): частка frac[i] у [0, 1] шляху
+// від (lat1[i], lon1[i]) до (lat2[i], lon2[i]). Вихід — градуси, lon у [-180, 180].
+void interpolateGreatCircle(const double* lat1, const double* lon1,
+                            const double* lat2, const double* lon2,
+                            const double* frac,
+                            double* latOut, double* lonOut, std::size_t n) noexcept;
+
+// Відстані від точки до всіх портів; out.size() == ports.size()
+void distancesFromKm(double lat, double lon, const PortCoords& ports, std::vector<double>& out);
+
+// Обране ядро: "avx2" або "scalar".
+// OOP_GEO_KERNEL=scalar примусово вмикає скалярне (порівняння, діагностика).
+const char* kernelName() noexcept;
+
+// План рейсу між портами при сталій швидкості
+struct VoyagePlan {
+    double distanceKm{0.0};
+    std::int64_t etaMs{0};    // мс від epoch
+};
+
+// Тривалість проходження distanceKm зі швидкістю speedKnots, мс.
+// speedKnots <= 0 — 0 (рейс без відомої швидкості не планується).
+std::int64_t travelTimeMs(double distanceKm, double speedKnots) noexcept;
+
+VoyagePlan planVoyage(const Port& from, const Port& to,
+                      double speedKnots, std::int64_t departedAtMs) noexcept;
+
+} // namespace geo
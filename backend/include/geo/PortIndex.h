@@ -0,0 +1,62 @@
+﻿// include/geo/PortIndex.h
+#pragma once
+
+#include "models/Port.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace geo {
+
+// Просторовий індекс портів: k-d tree над одиничними векторами (x, y, z).
+// На сфері хорда монотонна з відстанню по великому колу, тож найближчі
+// за хордою — найближчі і на Землі, а антимеридіан і полюси не потребують
+// окремої обробки.
+// Дерево незмінне: запити читають знімок без блокувань. Зміна порту не
+// перебудовує дерево, а кладе порт у невеликий «хвіст» поверх нього
+// (запити перевіряють хвіст лінійно, а старий вузол приховують);
+// дерево перебудовується пачкою, коли хвіст переростає kMaxPending.
+class PortIndex {
+public:
+    static PortIndex& instance();
+
+    void build(const std::vector<Port>& ports);
+    void upsert(const Port& p);
+    void remove(std::int64_t portId);
+
+    struct Hit {
+        Port port;
+        double distanceKm;
+    };
+
+    // k найближчих портів, за зростанням відстані
+    std::vector<Hit> nearest(double lat, double lon, std::size_t k) const;
+
+    // Усі порти в радіусі radiusKm, за зростанням відстані
+    std::vector<Hit> within(double lat, double lon, double radiusKm) const;
+
+    std::size_t size() const;
+
+private:
+    struct Tree;
+    struct Snapshot;
+
+    std::shared_ptr<const Snapshot> snapshot() const;
+    void rebuildLocked();
+    void publishLocked();
+
+    mutable std::mutex snapMu_;             // лише на копію shared_ptr
+    std::shared_ptr<const Snapshot> snap_;
+
+    std::mutex writeMu_;                    // серіалізує зміни
+    std::unordered_map<std::int64_t, Port> ports_;
+    std::shared_ptr<const Tree> tree_;      // останнє побудоване дерево
+    std::unordered_set<std::int64_t> pending_;   // id, змінені/видалені після побудови
+};
+
+} // namespace geo
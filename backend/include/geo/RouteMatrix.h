@@ -0,0 +1,68 @@
+﻿// include/geo/RouteMatrix.h
+#pragma once
+
+#include "geo/RoutePlanner.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace geo {
+
+// Довжини найкоротших маршрутів між усіма парами портів (км по RouteGraph,
+// float; +inf — маршруту немає).
+// Рахується Dijkstra з кожного порту, джерела розбирають потоки: граф
+// розріджений (~maxNeighbors ребер на порт), тож n·E·log n значно менше за
+// n³ у Floyd–Warshall. Результат пишеться прямо у файл, відображений у
+// пам'ять; на старті файл лише відображається заново (mmap або
+// MapViewOfFile на Windows), без перерахунку.
+// Файл: заголовок (64 байти), id портів (int64 × n), матриця n × n рядками.
+class RouteMatrix {
+public:
+    static RouteMatrix& instance();
+
+    // Порахувати матрицю для g у path (через path.tmp + rename) і відкрити її.
+    // threads == 0 — за кількістю ядер. Кидає std::runtime_error.
+    void rebuild(const RouteGraph& g, const std::string& path, unsigned threads = 0);
+
+    // Відкрити збережену матрицю. false — файлу немає, він пошкоджений
+    // або порахований для іншого графа (fingerprint).
+    bool load(const std::string& path, std::uint64_t fingerprint);
+
+    // Лише обчислення: out — g.size() * g.size() float рядками
+    static void compute(const RouteGraph& g, float* out, unsigned threads = 0);
+
+    // nullopt — порт невідомий матриці; +inf — маршруту немає
+    std::optional<double> routeKm(std::int64_t from, std::int64_t to) const;
+
+    struct Entry {
+        std::int64_t portId;
+        double routeKm;
+    };
+
+    // Рядок порту: довжини маршрутів до всіх портів. false — порт невідомий.
+    bool row(std::int64_t portId, std::vector<Entry>& out) const;
+
+    struct Info {
+        bool loaded{false};
+        std::size_t ports{0};
+        std::uint64_t fingerprint{0};
+        std::int64_t computedAtMs{0};
+        double computeMs{0.0};
+    };
+    Info info() const;
+
+private:
+    struct Mapping;
+
+    std::shared_ptr<const Mapping> current() const;
+
+    mutable std::mutex mu_;
+    std::shared_ptr<const Mapping> map_;   // читачі тримають копію під час заміни
+};
+
+} // namespace geo
@@ -0,0 +1,102 @@
+﻿// include/geo/RoutePlanner.h
+#pragma once
+
+#include "models/Port.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace geo {
+
+struct RouteOptions {
+    double      maxLegKm{1500.0};   // ребро між портами не далі за це; 0 — лише коридори
+    std::size_t maxNeighbors{32};   // найближчих сусідів на порт (обмежує щільність графа)
+    std::size_t cacheSize{4096};    // маршрутів у LRU; 0 — без кешу
+};
+
+// Граф портів у CSR: сусіди вузла u — targets[offsets[u] .. offsets[u + 1]).
+// Незмінний після побудови; спільний для RoutePlanner і RouteMatrix.
+struct RouteGraph {
+    std::vector<Port> ports;                        // вузол i — ports[i]
+    std::unordered_map<std::int64_t, std::uint32_t> nodeOf;
+    std::vector<std::uint32_t> offsets;             // ports.size() + 1
+    std::vector<std::uint32_t> targets;
+    std::vector<double> weights;                    // км по великому колу
+    std::uint64_t fingerprint{0};                   // хеш id, координат і ребер
+
+    std::size_t size() const noexcept { return ports.size(); }
+};
+
+// Ребра: до maxNeighbors найближчих портів у межах maxLegKm плюс коридори lanes
+std::shared_ptr<const RouteGraph> buildRouteGraph(
+    const std::vector<Port>& ports,
+    const std::vector<std::pair<std::int64_t, std::int64_t>>& lanes,
+    const RouteOptions& opts);
+
+struct Route {
+    bool found{false};
+    double distanceKm{0.0};
+    std::vector<Port> ports;        // from ... to; порожній, якщо !found
+};
+
+// A* по графу портів (buildRouteGraph з коридорами sea_lanes).
+// Вага ребра — відстань по великому колу, евристика — haversine до цілі
+// (допустима і монотонна, тож A* дає найкоротший шлях).
+// Граф — незмінний знімок; зміна портів будує новий і скидає кеш.
+class RoutePlanner {
+public:
+    static RoutePlanner& instance();
+
+    void configure(const RouteOptions& opts);   // до build()
+    RouteOptions options() const;
+
+    void build(const std::vector<Port>& ports,
+               const std::vector<std::pair<std::int64_t, std::int64_t>>& lanes);
+
+    // Поточний знімок графа; nullptr — build() ще не викликано
+    std::shared_ptr<const RouteGraph> graph() const;
+
+    // nullptr — from або to не є портом. cached (якщо задано) — відповідь з LRU.
+    std::shared_ptr<const Route> plan(std::int64_t from, std::int64_t to, bool* cached = nullptr);
+
+    struct Stats {
+        std::size_t ports{0};
+        std::size_t edges{0};       // орієнтованих
+        std::size_t cached{0};
+        std::uint64_t hits{0};
+        std::uint64_t misses{0};
+    };
+    Stats stats() const;
+
+private:
+    using Key = std::pair<std::int64_t, std::int64_t>;
+    struct KeyHash {
+        std::size_t operator()(const Key& k) const noexcept;
+    };
+    struct CacheEntry {
+        Key key;
+        std::shared_ptr<const Route> route;
+    };
+
+    std::shared_ptr<const RouteGraph> snapshot(std::uint64_t& version) const;
+    std::shared_ptr<const Route> lookup(const Key& key);
+    void remember(const Key& key, std::shared_ptr<const Route> route, std::uint64_t version);
+
+    mutable std::mutex mu_;                 // знімок графа, опції, кеш
+    RouteOptions opts_;
+    std::shared_ptr<const RouteGraph> graph_;
+    std::uint64_t version_{0};              // росте з кожним build()
+
+    std::list<CacheEntry> lru_;             // спереду — найсвіжіші
+    std::unordered_map<Key, std::list<CacheEntry>::iterator, KeyHash> index_;
+    std::uint64_t hits_{0};
+    std::uint64_t misses_{0};
+};
+
+} // namespace geo
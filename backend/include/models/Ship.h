@@ -17,8 +17,8 @@ struct Ship {
     double       speed_knots{20.0}; // Швидкість у вузлах (за замовчуванням 20)
     
     // Voyage tracking
-    std::string  departed_at;     // ISO timestamp коли відплив
+    std::int64_t departed_at{0};  // коли відплив, мс від epoch (0 = не задано)
     std::int64_t destination_port_id{0}; // Порт призначення
-    std::string  eta;             // Estimated time of arrival (ISO timestamp)
+    std::int64_t eta{0};          // Estimated time of arrival, мс від epoch (0 = не задано)
     double       voyage_distance_km{0.0}; // Відстань рейсу в км
 };
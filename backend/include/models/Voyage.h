@@ -0,0 +1,16 @@
+﻿#pragma once
+
+#include <cstdint>
+
+// Рядок журналу рейсів (таблиця voyages)
+struct Voyage {
+    std::int64_t id{0};
+    std::int64_t ship_id{0};
+    std::int64_t origin_port_id{0};
+    std::int64_t destination_port_id{0};
+    std::int64_t departed_at{0};        // мс від epoch
+    std::int64_t planned_eta{0};        // ETA при відправленні; 0 — невідомо
+    std::int64_t arrived_at{0};         // 0 — ще в дорозі
+    double       distance_km{0.0};
+    double       speed_knots{0.0};
+};
@@ -4,6 +4,7 @@
 #include "models/Company.h"
 #include "models/Port.h"
 #include "models/Ship.h"
+#include "repos/Page.h"
 
 #include <vector>
 #include <optional>
@@ -14,7 +15,10 @@ class CompaniesRepo {
 public:
     // ---- CRUD companies ----
     std::vector<Company> all();
+    Page<Company> page(const PageRequest& req);
     std::optional<Company> byId(std::int64_t id);
+    std::optional<Company> byName(const std::string& name);   // UNIQUE-індекс
+    bool existsByName(const std::string& name);
 
     // старий API
     Company create(const std::string& name);
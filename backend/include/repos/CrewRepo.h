@@ -3,15 +3,14 @@
 
 #include <cstdint>
 #include <optional>
-#include <string>
 #include <vector>
 
 struct CrewAssignment {
     std::int64_t id{0};
     std::int64_t person_id{0};
     std::int64_t ship_id{0};
-    std::string start_utc{};
-    std::optional<std::string> end_utc{};
+    std::int64_t start_utc{0};                // мс від epoch
+    std::optional<std::int64_t> end_utc{};    // мс від epoch; nullopt — активне
 };
 
 class CrewRepo {
@@ -20,12 +19,12 @@ public:
 
     std::optional<CrewAssignment> assign(long long personId,
                                          long long shipId,
-                                         const std::string& startUtc);
+                                         std::int64_t startUtcMs);
 
     // для тестів
     bool end(long long assignmentId);
-    bool end(long long assignmentId, const std::string& endUtc);
+    bool end(long long assignmentId, std::int64_t endUtcMs);
 
     // те, що вже було
-    bool endActiveByPerson(long long personId, const std::string& endUtc);
+    bool endActiveByPerson(long long personId, std::int64_t endUtcMs);
 };
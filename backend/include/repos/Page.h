@@ -0,0 +1,44 @@
+﻿// include/repos/Page.h
+#pragma once
+
+#include "db/Stmt.h"
+
+#include <sqlite3.h>
+
+#include <cstdint>
+#include <vector>
+
+// Keyset-пагінація: WHERE id > after ORDER BY id LIMIT n.
+// На відміну від OFFSET, вартість сторінки не залежить від її глибини:
+// SQLite одразу стає на after у первинному ключі.
+struct PageRequest {
+    std::int64_t after{0};   // id останнього рядка попередньої сторінки
+    int          limit{100};
+};
+
+template <class T>
+struct Page {
+    std::vector<T> items;
+    bool hasMore{false};     // за останнім рядком є ще
+};
+
+// Спільна частина repo.page(): sql має два параметри — (after, limit).
+// Береться на один рядок більше: він лише сигналізує про наступну сторінку.
+template <class T, class Parse>
+Page<T> fetchPage(sqlite3* db, const char* sql, const PageRequest& req, Parse parse) {
+    Page<T> page;
+    page.items.reserve(static_cast<std::size_t>(req.limit));
+
+    Stmt st(db, sql);
+    sqlite3_bind_int64(st.get(), 1, req.after);
+    sqlite3_bind_int(st.get(), 2, req.limit + 1);
+
+    while (sqlite3_step(st.get()) == SQLITE_ROW) {
+        if (static_cast<int>(page.items.size()) == req.limit) {
+            page.hasMore = true;
+            break;
+        }
+        page.items.push_back(parse(st.get()));
+    }
+    return page;
+}
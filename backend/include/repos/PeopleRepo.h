@@ -1,5 +1,7 @@
 ﻿#pragma once
 
+#include "repos/Page.h"
+
 #include <string>
 #include <vector>
 #include <optional>
@@ -17,6 +19,7 @@ public:
     void createTable();
     Person create(const Person& p);
     std::vector<Person> all();
+    Page<Person> page(const PageRequest& req);
     std::optional<Person> byId(long long id);
     void update(const Person& p);
     void remove(long long id);
@@ -1,11 +1,15 @@
 ﻿// include/repos/PortsRepo.h
 #pragma once
 
+#include "geo/Geo.h"
 #include "models/Port.h"
+#include "repos/Page.h"
 
 #include <sqlite3.h>
 #include <cstdint>
 #include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
 class PortsRepo {
@@ -18,10 +22,22 @@ public:
 
     std::vector<Port> all() const;
 
+    Page<Port> page(const PageRequest& req) const;
+
+    // Лише id/lat/lon усіх портів, SoA для geo-ядра (у порядку id)
+    geo::PortCoords coords() const;
+
+    // Явні морські коридори (таблиця sea_lanes), пари (from, to)
+    std::vector<std::pair<std::int64_t, std::int64_t>> lanes() const;
+
     Port create(const Port& in) const;
 
     std::optional<Port> getById(std::int64_t id) const;
 
+    // За UNIQUE-індексом ports.name
+    std::optional<Port> byName(const std::string& name) const;
+    bool existsByName(const std::string& name) const;
+
     bool update(const Port& p) const;
 
     bool remove(std::int64_t id) const;
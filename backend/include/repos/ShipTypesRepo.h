@@ -2,6 +2,7 @@
 #pragma once
 
 #include "models/ShipType.h"
+#include "repos/Page.h"
 
 #include <optional>
 #include <string>
@@ -10,6 +11,7 @@
 class ShipTypesRepo {
 public:
     std::vector<ShipType> all();
+    Page<ShipType> page(const PageRequest& req);
 
     std::optional<ShipType> byId(long long id);
     std::optional<ShipType> byCode(const std::string& code);
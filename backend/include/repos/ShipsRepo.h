@@ -2,8 +2,12 @@
 #pragma once
 
 #include "models/Ship.h"
+#include "repos/Page.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
+#include <string>
 #include <vector>
 
 class ShipsRepo {
@@ -11,15 +15,59 @@ public:
     // Отримати всі кораблі
     std::vector<Ship> all();
 
+    // Сторінка кораблів за id (keyset, див. repos/Page.h)
+    Page<Ship> page(const PageRequest& req);
+
     // Отримати кораблі за портом
     std::vector<Ship> getByPortId(long long portId);
 
+    // Кораблі в дорозі (departed), чий eta вже настав: 0 < eta <= nowMs.
+    // Частковий індекс idx_ships_departed_eta, у порядку eta.
+    std::vector<Ship> departedDueBefore(std::int64_t nowMs);
+
+    // Кораблі в дорозі (для карти): лише поля рейсу, без повного Ship.
+    // Під час рейсу port_id — порт відправлення, прибуття міняє його на destination.
+    struct InFlight {
+        std::int64_t id{0};
+        std::string  name;
+        std::int64_t originPortId{0};
+        std::int64_t destinationPortId{0};
+        std::int64_t departedAt{0};   // мс від epoch; 0 — невідомо
+        std::int64_t eta{0};
+    };
+    std::vector<InFlight> inFlight();
+
+    // Пришвартувати всі кораблі, що прибули до nowMs: одна транзакція,
+    // один UPDATE за тим самим предикатом, рядки аудиту і закриття рейсів
+    // у журналі voyages (VoyagesRepo::closeDue) — в тому ж коміті.
+    // Повертає кораблі у стані до прибуття (destination_port_id — новий порт).
+    std::vector<Ship> dockDueArrivals(std::int64_t nowMs);
+
     // Отримати корабель за id
     std::optional<Ship> byId(long long id);
 
+    // Отримати корабель за назвою (UNIQUE-індекс)
+    std::optional<Ship> byName(const std::string& name);
+    bool existsByName(const std::string& name);
+
     // Створити корабель
     Ship create(const Ship& sIn);
 
+    // Масове створення: один prepared statement, одна транзакція,
+    // один підсумковий запис аудиту. Рядок, що порушив обмеження
+    // (UNIQUE name, FK port_id тощо), пропускається і потрапляє в errors;
+    // будь-яка інша помилка SQLite кидає виняток і відкочує всю пачку.
+    struct BulkError {
+        std::size_t index;      // позиція у вхідному векторі
+        std::string message;
+    };
+    struct BulkResult {
+        std::size_t inserted{0};
+        std::vector<std::int64_t> ids;   // id по позиціях; 0 — рядок відхилено
+        std::vector<BulkError> errors;
+    };
+    BulkResult createMany(const std::vector<Ship>& ships);
+
     // Оновити корабель
     void update(const Ship& s);
 
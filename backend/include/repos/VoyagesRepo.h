@@ -0,0 +1,64 @@
+﻿// include/repos/VoyagesRepo.h
+#pragma once
+
+#include "models/Ship.h"
+#include "models/Voyage.h"
+#include "repos/Page.h"
+
+#include <sqlite3.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Журнал рейсів: лише додавання. Рядок з'являється при відправленні,
+// прибуття один раз дописує arrived_at; завершені рядки не змінюються.
+// Викликати всередині транзакції, що змінює ships: рейс комітиться разом
+// зі зміною статусу корабля.
+class VoyagesRepo {
+public:
+    // За замовчуванням бере Db::instance().handle()
+    VoyagesRepo();
+    explicit VoyagesRepo(sqlite3* db);
+
+    // Відправлення s (status departed, port_id — порт відправлення).
+    // 0 — рейс не записано: невідомий порт відправлення чи призначення.
+    std::int64_t open(const Ship& s) const;
+
+    // Закрити відкритий рейс корабля (ручне прибуття чи скасування)
+    bool close(std::int64_t shipId, std::int64_t arrivedAt) const;
+
+    // Тік прибуттів: одним UPDATE закрити рейси всіх кораблів, які
+    // ShipsRepo::dockDueArrivals зараз пришвартує. Викликати до його UPDATE.
+    std::size_t closeDue(std::int64_t nowMs) const;
+
+    // Keyset-сторінка за id; shipId > 0 — лише рейси цього корабля
+    Page<Voyage> page(const PageRequest& req, std::int64_t shipId = 0) const;
+
+    // Рейси, що прибули в [sinceMs, untilMs), по маршрутах.
+    // originPortId/destinationPortId = 0 — без фільтра.
+    // Покривний індекс idx_voyages_route: таблиця не читається.
+    struct RouteStats {
+        std::int64_t originPortId{0};
+        std::int64_t destinationPortId{0};
+        std::int64_t voyages{0};
+        double       avgTransitMs{0.0};
+        double       avgDelayMs{0.0};      // arrived_at - planned_eta; > 0 — запізнення
+        std::int64_t onTime{0};            // arrived_at <= planned_eta
+    };
+    std::vector<RouteStats> routeStats(std::int64_t originPortId, std::int64_t destinationPortId,
+                                       std::int64_t sinceMs, std::int64_t untilMs) const;
+
+    // Час у морі кожного корабля у вікні [sinceMs, untilMs): рейси обрізаються
+    // вікном, незавершений рейс триває до min(untilMs, nowMs).
+    // shipId > 0 — лише цей корабель. Покривний індекс idx_voyages_ship.
+    struct ShipUtilization {
+        std::int64_t shipId{0};
+        std::int64_t voyages{0};
+        std::int64_t atSeaMs{0};
+    };
+    std::vector<ShipUtilization> shipUtilization(std::int64_t shipId, std::int64_t sinceMs,
+                                                 std::int64_t untilMs, std::int64_t nowMs) const;
+
+private:
+    sqlite3* db_{nullptr};
+};
@@ -0,0 +1,98 @@
+﻿// include/services/ArrivalScheduler.h
+#pragma once
+
+#include "models/Ship.h"
+#include "util/Time.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Планувальник прибуттів у процесі сервера.
+// Тримає min-heap (eta, ship_id) кораблів у дорозі; фоновий потік спить
+// рівно до найближчого eta і тоді викликає dock(now)
+// (за замовчуванням ShipsRepo::dockDueArrivals).
+// Джерело істини — БД: heap лише каже, коли прокинутись, тож застарілий
+// запис (корабель уже прибув вручну, eta змінено) нічого не ламає.
+class ArrivalScheduler {
+public:
+    // Пришвартувати все, що прибуло до nowMs; повертає кількість кораблів
+    using Dock = std::function<std::size_t(std::int64_t nowMs)>;
+
+    // Годинник eta: now() — мс від epoch; rate — мс цього годинника за
+    // мілісекунду реального часу (симуляція флоту прискорює час)
+    struct Clock {
+        std::function<std::int64_t()> now{util::nowMs};
+        double rate{1.0};
+    };
+
+    // Один тік: найраніший eta серед спрацьованих, момент спрацювання
+    // (обидва — за Clock), кількість пришвартованих і час dock
+    struct Tick {
+        std::int64_t dueMs{0};
+        std::int64_t firedMs{0};
+        std::size_t ships{0};
+        double dockMs{0.0};
+        bool ok{true};
+    };
+    using OnTick = std::function<void(const Tick&)>;
+
+    static ArrivalScheduler& instance();
+
+    explicit ArrivalScheduler(Dock dock);   // реальний час, без OnTick
+    ArrivalScheduler(Dock dock, Clock clock, OnTick onTick);
+    ~ArrivalScheduler();  // stop()
+
+    // Перебудувати heap з БД (усі departed з eta) і запустити потік.
+    // Прострочені за час простою кораблі пришвартовуються одразу.
+    void start();
+    void stop();
+
+    // Корабель departed з eta > 0 — (пере)запланувати, інакше прибрати.
+    // Викликати після коміту зміни status/eta/speed.
+    void track(const Ship& s);
+    void schedule(std::int64_t shipId, std::int64_t etaMs);
+    void cancel(std::int64_t shipId);
+
+    std::size_t pending();
+    std::int64_t nextDueMs();   // 0 — нічого не заплановано
+
+    ArrivalScheduler(const ArrivalScheduler&) = delete;
+    ArrivalScheduler& operator=(const ArrivalScheduler&) = delete;
+
+private:
+    struct Entry {
+        std::int64_t eta;
+        std::int64_t shipId;
+        bool operator>(const Entry& o) const noexcept {
+            return eta != o.eta ? eta > o.eta : shipId > o.shipId;
+        }
+    };
+
+    void run();
+    void dropStaleLocked();
+    void compactLocked();
+
+    // реальні мс до моменту dueMs за clock_, не більше за capMs
+    std::int64_t realDelayMs(std::int64_t dueMs, std::int64_t nowMs, std::int64_t capMs) const;
+
+    Dock dock_;
+    Clock clock_;
+    OnTick onTick_;
+
+    std::mutex mu_;
+    std::condition_variable wake_;
+
+    // Лінива інвалідація: актуальний eta — лише той, що в etaOf_
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> heap_;
+    std::unordered_map<std::int64_t, std::int64_t> etaOf_;
+
+    bool stop_{false};
+    std::thread thread_;
+};
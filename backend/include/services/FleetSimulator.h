@@ -0,0 +1,64 @@
+﻿// include/services/FleetSimulator.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct FleetSimOptions {
+    std::size_t   ships{1000};          // синтетичних кораблів
+    double        timeScale{3600.0};    // мс віртуального часу за мс реального
+    double        durationSec{60.0};    // реальна тривалість прогону
+    double        minSpeedKnots{10.0};
+    double        maxSpeedKnots{25.0};
+    std::uint64_t seed{42};
+    bool          keep{false};          // не видаляти кораблі і їхні рейси (voyages) після прогону
+};
+
+// Перцентилі вибірки, мс
+struct LatencySummary {
+    std::size_t count{0};
+    double p50{0.0}, p95{0.0}, p99{0.0}, max{0.0};
+};
+
+struct FleetSimReport {
+    std::size_t ports{0};
+    std::size_t ships{0};
+    double realSec{0.0};
+    double virtualHours{0.0};
+
+    std::size_t departures{0};
+    std::size_t arrivals{0};
+    std::size_t ticks{0};
+    std::size_t failedTicks{0};
+
+    LatencySummary departMs;        // транзакція відправлення (updateOne)
+    LatencySummary dockMs;          // dockDueArrivals за тік
+    LatencySummary tickLatencyMs;   // від найранішого eta тіку до кінця dock, реальні мс
+
+    std::uint64_t commits{0};       // Db::commitSeq() за прогін
+    std::size_t shipRowWrites{0};   // UPDATE ships: похідне, departures + arrivals
+    std::size_t auditRows{0};       // ship.update / ship.arrive — фактичні рядки logs
+    std::size_t voyageRows{0};      // voyages: INSERT при відправленні + arrived_at при прибутті (з БД)
+};
+
+// Симуляція флоту для навантаження рушія прибуттів.
+// Створює N кораблів у наявних портах, відправляє їх тим самим шляхом, що
+// PUT /api/ships/{id} (applyVoyagePlan + ShipsRepo::update + ArrivalScheduler),
+// а прибулих одразу відправляє далі. Годинник віртуальний: eta і dock
+// рахуються в часі, що йде в timeScale разів швидше за реальний.
+// Прискорений годинник пришвартував би й справжні кораблі в дорозі, тож
+// run() відмовляється працювати з БД, де такі є: запускати на копії.
+class FleetSimulator {
+public:
+    explicit FleetSimulator(FleetSimOptions opts);
+
+    // Кидає std::runtime_error, якщо портів менше двох або є кораблі в дорозі
+    FleetSimReport run();
+
+private:
+    FleetSimOptions opts_;
+};
+
+// Звіт у текстовому вигляді для CLI
+std::string formatReport(const FleetSimReport& r);
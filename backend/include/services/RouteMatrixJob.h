@@ -0,0 +1,63 @@
+﻿// include/services/RouteMatrixJob.h
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Фонове обчислення geo::RouteMatrix для поточного графа RoutePlanner.
+// start() відкриває збережений файл, якщо він порахований для цього графа,
+// інакше ставить перерахунок. requestRebuild() — після зміни портів;
+// запити протягом kDebounceMs склеюються в один прогін.
+// requestGraphRebuild() — зміна координат/складу портів: граф RoutePlanner
+// перебудовується тут же у фоні (з коротшим debounce), а за ним — матриця.
+class RouteMatrixJob {
+public:
+    static RouteMatrixJob& instance();
+
+    RouteMatrixJob() = default;
+    ~RouteMatrixJob();  // stop()
+
+    // threads == 0 — за кількістю ядер
+    void start(std::string path, unsigned threads = 0);
+    void stop();
+
+    void requestRebuild();
+    void requestGraphRebuild();
+
+    struct Status {
+        std::string path;
+        bool graphPending{false};   // граф маршрутів ще не перебудовано після зміни портів
+        bool pending{false};        // перерахунок запитано, ще не почато
+        bool computing{false};
+        bool stale{false};          // матриця не про поточний граф (або її немає)
+        std::int64_t lastErrorAtMs{0};
+        std::string lastError;
+    };
+    Status status();
+
+    RouteMatrixJob(const RouteMatrixJob&) = delete;
+    RouteMatrixJob& operator=(const RouteMatrixJob&) = delete;
+
+private:
+    void run();
+    void rebuildGraph(std::unique_lock<std::mutex>& lock);
+
+    std::mutex mu_;
+    std::condition_variable wake_;
+
+    std::string path_;
+    unsigned threads_{0};
+    bool pending_{false};
+    bool computing_{false};
+    std::int64_t requestedAtMs_{0};   // останній requestRebuild()
+    bool graphPending_{false};
+    std::int64_t graphRequestedAtMs_{0};
+    std::int64_t lastErrorAtMs_{0};
+    std::string lastError_;
+
+    bool stop_{false};
+    std::thread thread_;
+};
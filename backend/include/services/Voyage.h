@@ -0,0 +1,18 @@
+﻿// include/services/Voyage.h
+#pragma once
+
+#include "models/Ship.h"
+
+#include <cstdint>
+
+// Рейс рахує бекенд, а не клієнт: при відправленні (cur не departed,
+// s departed) — відстань між портами по великому колу і ETA зі speed_knots,
+// departed_at = nowMs, якщо не задано; зміна швидкості в дорозі — ETA від
+// departed_at заново. Якщо порти невідомі, лишаються значення з s.
+// Спільне для PUT /api/ships/{id} і симуляції флоту (services/FleetSimulator).
+void applyVoyagePlan(const Ship& cur, Ship& s, std::int64_t nowMs);
+
+// Журнал рейсів для переходу cur -> s (після ShipsRepo::update, у тій самій
+// транзакції): відправлення відкриває рейс, вихід зі стану departed не через
+// тік прибуттів (ручне прибуття, скасування) закриває його на nowMs.
+void recordVoyage(const Ship& cur, const Ship& s, std::int64_t nowMs);
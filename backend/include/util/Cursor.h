@@ -0,0 +1,21 @@
+﻿// include/util/Cursor.h
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Непрозорий курсор пагінації: ключі останнього рядка сторінки
+// (id, або ts+id для журналу), закодовані base64url з версією формату.
+// Клієнт передає його назад як ?after= і не повинен розбирати.
+namespace util {
+
+std::string encodeCursor(std::initializer_list<std::int64_t> keys);
+
+// nullopt — курсор пошкоджений або іншої версії
+std::optional<std::vector<std::int64_t>> decodeCursor(std::string_view cursor);
+
+} // namespace util
@@ -0,0 +1,260 @@
+﻿// include/util/Time.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Час у БД — int64 мілісекунди від Unix epoch (UTC).
+// ISO-8601 рядки існують лише на межі JSON: парсимо вхід, форматуємо вихід.
+// Розбір і форматування — constexpr, без алокацій і без libc (gmtime,
+// mktime, локальної зони): календарна арифметика H. Hinnant.
+namespace util {
+
+using EpochMs = std::int64_t;
+
+// Поточний час, мс від epoch
+EpochMs nowMs() noexcept;
+
+// Календарна дата/час UTC
+struct CivilTime {
+    int year{1970};
+    int month{1};    // 1..12
+    int day{1};      // 1..31
+    int hour{0};
+    int minute{0};
+    int second{0};
+    int millis{0};
+};
+
+namespace detail {
+
+constexpr EpochMs kMsPerDay = 86'400'000;
+
+// Дні від 1970-01-01 для дати григоріанського календаря (days_from_civil)
+constexpr std::int64_t daysFromCivil(int y, int m, int d) noexcept {
+    y -= m <= 2;
+    const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+constexpr int daysInMonth(int y, int m) noexcept {
+    constexpr int kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+    return (m == 2 && leap) ? 29 : kDays[m - 1];
+}
+
+// Рівно n цифр з позиції pos
+constexpr bool digits(std::string_view s, std::size_t pos, std::size_t n, int& out) noexcept {
+    if (pos + n > s.size()) return false;
+    int v = 0;
+    for (std::size_t i = pos; i < pos + n; ++i) {
+        if (s[i] < '0' || s[i] > '9') return false;
+        v = v * 10 + (s[i] - '0');
+    }
+    out = v;
+    return true;
+}
+
+// Рівно n цифр v (з провідними нулями) у out
+constexpr char* putDigits(char* out, unsigned v, int n) noexcept {
+    for (int i = n - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + v % 10);
+        v /= 10;
+    }
+    return out + n;
+}
+
+} // namespace detail
+
+constexpr CivilTime toCivil(EpochMs ms) noexcept {
+    std::int64_t days = ms / detail::kMsPerDay;
+    std::int64_t rem  = ms % detail::kMsPerDay;
+    if (rem < 0) {
+        rem += detail::kMsPerDay;
+        --days;
+    }
+
+    // civil_from_days
+    const std::int64_t z = days + 719468;
+    const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp  = (5 * doy + 2) / 153;
+
+    CivilTime t;
+    t.day    = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    t.month  = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    t.year   = static_cast<int>(yoe + era * 400 + (t.month <= 2));
+    t.hour   = static_cast<int>(rem / 3'600'000);
+    t.minute = static_cast<int>(rem / 60'000 % 60);
+    t.second = static_cast<int>(rem / 1000 % 60);
+    t.millis = static_cast<int>(rem % 1000);
+    return t;
+}
+
+constexpr EpochMs fromCivil(const CivilTime& t) noexcept {
+    return detail::daysFromCivil(t.year, t.month, t.day) * detail::kMsPerDay +
+           ((t.hour * 60LL + t.minute) * 60 + t.second) * 1000 + t.millis;
+}
+
+// Приймає "YYYY-MM-DD", "YYYY-MM-DDTHH:MM[:SS[.fff…]]" (або пробіл замість 'T')
+// з необов'язковим "Z" чи зсувом "+HH:MM"/"-HH:MM". Без зсуву — UTC.
+// Дробова частина обрізається до мілісекунд. nullopt — некоректний рядок.
+constexpr std::optional<EpochMs> parseIsoMs(std::string_view s) noexcept {
+    using detail::digits;
+
+    CivilTime t;
+    if (!digits(s, 0, 4, t.year) || s.size() < 10 || s[4] != '-' || s[7] != '-' ||
+        !digits(s, 5, 2, t.month) || !digits(s, 8, 2, t.day)) {
+        return std::nullopt;
+    }
+    if (t.month < 1 || t.month > 12 || t.day < 1 || t.day > detail::daysInMonth(t.year, t.month)) {
+        return std::nullopt;
+    }
+
+    std::size_t pos = 10;
+    if (pos < s.size() && (s[pos] == 'T' || s[pos] == 't' || s[pos] == ' ')) {
+        if (!digits(s, pos + 1, 2, t.hour) || pos + 3 >= s.size() || s[pos + 3] != ':' ||
+            !digits(s, pos + 4, 2, t.minute)) {
+            return std::nullopt;
+        }
+        pos += 6;
+        if (pos < s.size() && s[pos] == ':') {
+            if (!digits(s, pos + 1, 2, t.second)) return std::nullopt;
+            pos += 3;
+            if (pos < s.size() && (s[pos] == '.' || s[pos] == ',')) {
+                ++pos;
+                int scale = 100;
+                const std::size_t start = pos;
+                while (pos < s.size() && s[pos] >= '0' && s[pos] <= '9') {
+                    t.millis += (s[pos] - '0') * scale;
+                    scale /= 10;
+                    ++pos;
+                }
+                if (pos == start) return std::nullopt;
+            }
+        }
+        if (t.hour > 23 || t.minute > 59 || t.second > 60) return std::nullopt;
+    }
+
+    EpochMs offsetMs = 0;
+    if (pos < s.size()) {
+        if ((s[pos] == 'Z' || s[pos] == 'z') && pos + 1 == s.size()) {
+            pos += 1;
+        } else if (s[pos] == '+' || s[pos] == '-') {
+            int oh = 0, om = 0;
+            if (!digits(s, pos + 1, 2, oh)) return std::nullopt;
+            std::size_t next = pos + 3;
+            if (next < s.size() && s[next] == ':') ++next;
+            if (!digits(s, next, 2, om) || next + 2 != s.size() || oh > 23 || om > 59) {
+                return std::nullopt;
+            }
+            offsetMs = (oh * 60LL + om) * 60'000;
+            if (s[pos] == '-') offsetMs = -offsetMs;
+            pos = s.size();
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    // Секунда 60 (leap second) -> наступна хвилина, як у SQLite julianday()
+    return fromCivil(t) - offsetMs;
+}
+
+// Відформатований час у буфері фіксованого розміру (без алокацій)
+struct IsoString {
+    static constexpr std::size_t kCapacity = 32;   // рік до 9 цифр і знак
+
+    char data[kCapacity]{};
+    std::size_t size{0};
+
+    constexpr std::string_view view() const noexcept { return {data, size}; }
+    std::string str() const { return std::string(data, size); }
+};
+
+// "YYYY-MM-DDTHH:MM:SS" — спільний префікс усіх мілісекунд секунди
+constexpr IsoString formatIsoSecond(const CivilTime& t) noexcept {
+    IsoString out;
+    char* p = out.data;
+    int year = t.year;
+    if (year < 0) {
+        *p++ = '-';
+        year = -year;
+    }
+    int width = 4;
+    for (int y = year / 10000; y > 0; y /= 10) ++width;
+    p = detail::putDigits(p, static_cast<unsigned>(year), width);
+    *p++ = '-';
+    p = detail::putDigits(p, static_cast<unsigned>(t.month), 2);
+    *p++ = '-';
+    p = detail::putDigits(p, static_cast<unsigned>(t.day), 2);
+    *p++ = 'T';
+    p = detail::putDigits(p, static_cast<unsigned>(t.hour), 2);
+    *p++ = ':';
+    p = detail::putDigits(p, static_cast<unsigned>(t.minute), 2);
+    *p++ = ':';
+    p = detail::putDigits(p, static_cast<unsigned>(t.second), 2);
+    out.size = static_cast<std::size_t>(p - out.data);
+    return out;
+}
+
+// Дописати ".mmm" і "Z" до префікса секунди. Мілісекунди пишуться завжди:
+// одна форма для всіх міток, тож клієнт (pandas.to_datetime без format)
+// не спотикається на рядках рівно на секунді
+constexpr IsoString finishIso(IsoString out, int millis) noexcept {
+    char* p = out.data + out.size;
+    *p++ = '.';
+    p = detail::putDigits(p, static_cast<unsigned>(millis), 3);
+    *p++ = 'Z';
+    out.size = static_cast<std::size_t>(p - out.data);
+    return out;
+}
+
+// "YYYY-MM-DDTHH:MM:SS.mmmZ"
+constexpr IsoString formatIso(EpochMs ms) noexcept {
+    const CivilTime t = toCivil(ms);
+    return finishIso(formatIsoSecond(t), t.millis);
+}
+
+// Форматувальник з кешем останньої секунди: у пачці міток (журнал, CSV,
+// JSON-списки) секунда повторюється, тож календар рахується раз на секунду,
+// далі дописуються лише мілісекунди. Не потокобезпечний — один на потік.
+class IsoFormatter {
+public:
+    IsoString format(EpochMs ms) noexcept {
+        EpochMs second = ms / 1000;
+        int millis = static_cast<int>(ms % 1000);
+        if (millis < 0) {
+            millis += 1000;
+            --second;
+        }
+        if (second != second_) {
+            second_ = second;
+            prefix_ = formatIsoSecond(toCivil(second * 1000));
+        }
+        return finishIso(prefix_, millis);
+    }
+
+private:
+    EpochMs second_{std::numeric_limits<EpochMs>::min()};
+    IsoString prefix_;
+};
+
+// formatIso у std::string (для JSON); кеш секунди — свій на кожен потік
+std::string formatIsoMs(EpochMs ms);
+
+// YYYYMM місяця, що містить ms (ключ помісячних партицій)
+constexpr int monthKey(EpochMs ms) noexcept {
+    const CivilTime t = toCivil(ms);
+    return t.year * 100 + t.month;
+}
+
+} // namespace util
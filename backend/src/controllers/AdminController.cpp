@@ -0,0 +1,143 @@
+﻿// src/controllers/AdminController.cpp
+#include "controllers/AdminController.h"
+#include "db/Backup.h"
+#include "db/Db.h"
+
+#include <drogon/drogon.h>
+#include <json/json.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+namespace {
+
+using drogon::HttpRequestPtr;
+using drogon::HttpResponse;
+using drogon::HttpResponsePtr;
+using drogon::HttpStatusCode;
+
+HttpResponsePtr jsonError(const std::string& msg,
+                          HttpStatusCode code,
+                          const std::string& details = {}) {
+    Json::Value e;
+    e["error"] = msg;
+    if (!details.empty()) {
+        e["details"] = details;
+    }
+    auto r = HttpResponse::newHttpJsonResponse(e);
+    r->setStatusCode(code);
+    return r;
+}
+
+// Токен адміністратора — лише з OOP_ADMIN_TOKEN, без значення за замовчуванням:
+// поки його не задано, адмін-ендпоінти вимкнені
+const std::string& adminToken() {
+    static const std::string token = [] {
+        const char* env = std::getenv("OOP_ADMIN_TOKEN");
+        return (env && *env) ? std::string(env) : std::string();
+    }();
+    return token;
+}
+
+// nullptr — доступ дозволено; інакше відповідь з відмовою
+HttpResponsePtr checkAdminAuth(const HttpRequestPtr& req) {
+    const std::string& token = adminToken();
+    if (token.empty()) {
+        return jsonError("admin API is disabled: OOP_ADMIN_TOKEN is not configured",
+                         drogon::k503ServiceUnavailable);
+    }
+    const std::string authHeader = req->getHeader("Authorization");
+    const bool ok = authHeader.rfind("Bearer ", 0) == 0
+        ? authHeader.substr(7) == token
+        : req->getParameter("token") == token;
+    if (!ok) {
+        return jsonError("Unauthorized: missing or invalid token", drogon::k401Unauthorized);
+    }
+    return nullptr;
+}
+
+// Лише ім'я файлу в каталозі backups: шлях з HTTP не має виходити за його межі
+bool isSafeFileName(const std::string& name) {
+    if (name.empty() || name.size() > 128) return false;
+    if (name == "." || name == "..") return false;
+    for (char c : name) {
+        const bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                        (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.';
+        if (!ok) return false;
+    }
+    return true;
+}
+
+Json::Value statusToJson(const BackupStatus& s) {
+    Json::Value j;
+    j["state"]           = toString(s.state);
+    j["dest"]            = s.dest;
+    j["total_pages"]     = s.totalPages;
+    j["remaining_pages"] = s.remainingPages;
+    j["percent"]         = s.percent();
+    j["steps"]           = s.steps;
+    j["elapsed_ms"]      = s.elapsedMs;
+    if (!s.error.empty()) {
+        j["error"] = s.error;
+    }
+    return j;
+}
+
+} // namespace
+
+// POST /api/admin/backup
+// Тіло (необов'язкове): { "name": "nightly.db", "pages_per_step": 256, "pause_ms": 5 }
+void AdminController::startBackup(const HttpRequestPtr& req, Callback&& cb) {
+    try {
+        if (auto denied = checkAdminAuth(req)) {
+            return cb(denied);
+        }
+
+        std::string dest = BackupService::defaultDestination();
+        BackupOptions opts;
+
+        if (auto body = req->getJsonObject()) {
+            const Json::Value& j = *body;
+            if (j.isMember("name")) {
+                const std::string name = j["name"].asString();
+                if (!isSafeFileName(name)) {
+                    return cb(jsonError("invalid backup name", drogon::k400BadRequest,
+                                        "use letters, digits, '-', '_' and '.' only"));
+                }
+                dest = (std::filesystem::path(BackupService::backupDir()) / name).string();
+            }
+            opts.pagesPerStep = j.get("pages_per_step", opts.pagesPerStep).asInt();
+            opts.pauseMs      = j.get("pause_ms", opts.pauseMs).asInt();
+            if (opts.pagesPerStep <= 0 || opts.pauseMs < 0) {
+                return cb(jsonError("pages_per_step must be > 0 and pause_ms >= 0",
+                                    drogon::k400BadRequest));
+            }
+        }
+
+        if (!BackupService::instance().start(dest, opts)) {
+            auto r = HttpResponse::newHttpJsonResponse(statusToJson(BackupService::instance().status()));
+            r->setStatusCode(drogon::k409Conflict);
+            return cb(r);
+        }
+
+        try {
+            Db::instance().insertLog("INFO", "backup.started", "backup", 0, "system",
+                                     "Backup started: " + dest);
+        } catch (...) {}
+
+        auto r = HttpResponse::newHttpJsonResponse(statusToJson(BackupService::instance().status()));
+        r->setStatusCode(drogon::k202Accepted);
+        cb(r);
+    } catch (const std::exception& ex) {
+        cb(jsonError("backup failed", drogon::k500InternalServerError, ex.what()));
+    }
+}
+
+// GET /api/admin/backup — стан поточної або останньої копії
+void AdminController::backupStatus(const HttpRequestPtr& req, Callback&& cb) {
+    if (auto denied = checkAdminAuth(req)) {
+        return cb(denied);
+    }
+    cb(HttpResponse::newHttpJsonResponse(statusToJson(BackupService::instance().status())));
+}
@@ -1,11 +1,12 @@
 ﻿// src/controllers/CompaniesController.cpp
 #include "controllers/CompaniesController.h"
+#include "controllers/Pagination.h"
 #include "repos/CompaniesRepo.h"
+#include "db/Db.h"
 
 #include <drogon/drogon.h>
 #include <json/json.h>
 
-#include <algorithm>
 #include <cstdint>
 #include <string>
 
@@ -113,10 +114,23 @@ bool readIsMain(const Json::Value& j, bool& out) {
 
 // ================== LIST ==================
 
-void CompaniesController::list(const HttpRequestPtr&,
+void CompaniesController::list(const HttpRequestPtr& req,
                                std::function<void(const HttpResponsePtr&)>&& cb) {
     try {
         CompaniesRepo repo;
+
+        // ?limit=&after= — keyset-сторінка; без них — увесь список, як раніше
+        if (pagination::requested(req)) {
+            PageRequest page;
+            std::string err;
+            if (!pagination::parse(req, page, err)) {
+                cb(jsonError(err, drogon::k400BadRequest));
+                return;
+            }
+            cb(pagination::response(req, repo.page(page), page.limit, companyToJson));
+            return;
+        }
+
         const auto vec = repo.all();
 
         Json::Value arr(Json::arrayValue);
@@ -143,8 +157,16 @@ void CompaniesController::create(const HttpRequestPtr& req,
     const auto name = (*j)["name"].asString();
 
     try {
+        Db::Transaction tx;
         CompaniesRepo repo;
+
+        if (repo.existsByName(name)) {
+            cb(jsonError("name already exists", drogon::k409Conflict));
+            return;
+        }
+
         const auto c = repo.create(name);
+        tx.commit();
 
         auto resp = HttpResponse::newHttpJsonResponse(companyToJson(c));
         resp->setStatusCode(drogon::k201Created);
@@ -193,6 +215,7 @@ void CompaniesController::update(const HttpRequestPtr& req,
     const auto name = (*j)["name"].asString();
 
     try {
+        Db::Transaction tx;
         CompaniesRepo repo;
 
         // 1) 404 якщо компанії нема
@@ -208,15 +231,9 @@ void CompaniesController::update(const HttpRequestPtr& req,
             return;
         }
 
-        // 3) Додаткова перевірка на зайняте ім'я (без очікування на rc)
-        const auto allCompanies = repo.all();
-        const bool nameTaken =
-            std::any_of(allCompanies.begin(), allCompanies.end(),
-                        [&](const Company& c) {
-                            return c.id != id && c.name == name;
-                        });
-
-        if (nameTaken) {
+        // 3) Додаткова перевірка на зайняте ім'я (без очікування на rc).
+        // Власне ім'я вже відсічене в (2), тож будь-який збіг — інша компанія.
+        if (repo.existsByName(name)) {
             cb(jsonError("name already exists", drogon::k409Conflict));
             return;
         }
@@ -230,6 +247,7 @@ void CompaniesController::update(const HttpRequestPtr& req,
             return;
         }
 
+        tx.commit();
         cb(jsonOk("updated"));
     } catch (const std::exception& e) {
         LOG_ERROR << "CompaniesController::update failed id=" << id << ": " << e.what();
@@ -243,6 +261,7 @@ void CompaniesController::remove(const HttpRequestPtr&,
                                  std::function<void(const HttpResponsePtr&)>&& cb,
                                  std::int64_t id) {
     try {
+        Db::Transaction tx;
         CompaniesRepo repo;
 
         // 1) 404 якщо компанії нема
@@ -260,6 +279,7 @@ void CompaniesController::remove(const HttpRequestPtr&,
             return;
         }
 
+        tx.commit();
         auto r = HttpResponse::newHttpResponse();
         r->setStatusCode(drogon::k204NoContent);
         cb(r);
@@ -320,6 +340,7 @@ void CompaniesController::addPort(const HttpRequestPtr& req,
     }
 
     try {
+        Db::Transaction tx;
         CompaniesRepo repo;
 
         const auto c = repo.byId(id);
@@ -337,6 +358,7 @@ void CompaniesController::addPort(const HttpRequestPtr& req,
             return;
         }
 
+        tx.commit();
         cb(jsonOk("added"));
     } catch (const std::exception& e) {
         LOG_ERROR << "CompaniesController::addPort failed companyId=" << id
@@ -352,6 +374,7 @@ void CompaniesController::delPort(const HttpRequestPtr&,
                                   std::int64_t id,
                                   std::int64_t portId) {
     try {
+        Db::Transaction tx;
         CompaniesRepo repo;
 
         const auto c = repo.byId(id);
@@ -366,6 +389,7 @@ void CompaniesController::delPort(const HttpRequestPtr&,
             return;
         }
 
+        tx.commit();
         auto r = HttpResponse::newHttpResponse();
         r->setStatusCode(drogon::k204NoContent);
         cb(r);
@@ -1,14 +1,12 @@
 ﻿// src/controllers/CrewController.cpp
 #include "controllers/CrewController.h"
 #include "repos/CrewRepo.h"
+#include "util/Time.h"
 
 #include <drogon/drogon.h>
 #include <json/json.h>
 
 #include <cstdint>
-#include <ctime>
-#include <iomanip>
-#include <sstream>
 #include <string>
 
 namespace {
@@ -70,13 +68,15 @@ bool readPositiveInt64(const Json::Value& j, const char* key, std::int64_t& out)
     return out > 0;
 }
 
-// Якщо поле є — воно має бути string і не порожнє.
-// Якщо поля нема — повертаємо false.
-bool readNonEmptyStringIfPresent(const Json::Value& j, const char* key, std::string& out) {
+// Якщо поле є — воно має бути ISO-8601 рядком.
+// Якщо поля нема або рядок некоректний — повертаємо false.
+bool readIsoTimeIfPresent(const Json::Value& j, const char* key, std::int64_t& outMs) {
     if (!j.isMember(key)) return false;
     if (!j[key].isString()) return false;
-    out = j[key].asString();
-    return !out.empty();
+    const auto ms = util::parseIsoMs(j[key].asString());
+    if (!ms) return false;
+    outMs = *ms;
+    return true;
 }
 
 // ---------------- DTO -> JSON ----------------
@@ -86,30 +86,12 @@ Json::Value assignmentToJson(const CrewAssignment& a) {
     j["id"]        = Json::Int64(a.id);
     j["person_id"] = Json::Int64(a.person_id);
     j["ship_id"]   = Json::Int64(a.ship_id);
-    j["start_utc"] = a.start_utc;
-    j["end_utc"]   = a.end_utc ? Json::Value(*a.end_utc)
+    j["start_utc"] = util::formatIsoMs(a.start_utc);
+    j["end_utc"]   = a.end_utc ? Json::Value(util::formatIsoMs(*a.end_utc))
                                : Json::Value(Json::nullValue);
     return j;
 }
 
-// ---------------- Time helper ----------------
-// Thread-safe варіант для Windows/Linux.
-
-std::string nowUtcIso() {
-    std::time_t t = std::time(nullptr);
-
-    std::tm tm{};
-#if defined(_WIN32)
-    gmtime_s(&tm, &t);
-#else
-    gmtime_r(&t, &tm);
-#endif
-
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%SZ");
-    return oss.str();
-}
-
 } // namespace
 
 // ================== LIST BY SHIP ==================
@@ -161,22 +143,22 @@ void CrewController::assign(const HttpRequestPtr& req,
     }
 
     // start_utc:
-    // - якщо передали — має бути валідним непорожнім string
-    // - якщо не передали — ставимо nowUtcIso()
-    std::string startUtc;
+    // - якщо передали — має бути ISO-8601 рядком
+    // - якщо не передали — поточний час
+    std::int64_t startUtcMs = 0;
     if ((*j).isMember("start_utc")) {
-        if (!readNonEmptyStringIfPresent(*j, "start_utc", startUtc)) {
-            cb(jsonError("start_utc must be non-empty string",
+        if (!readIsoTimeIfPresent(*j, "start_utc", startUtcMs)) {
+            cb(jsonError("start_utc must be ISO-8601 string",
                          drogon::k400BadRequest));
             return;
         }
     } else {
-        startUtc = nowUtcIso();
+        startUtcMs = util::nowMs();
     }
 
     try {
         CrewRepo repo;
-        const auto created = repo.assign(personId, shipId, startUtc);
+        const auto created = repo.assign(personId, shipId, startUtcMs);
 
         if (!created) {
             // Бізнес-конфлікт:
@@ -220,22 +202,22 @@ void CrewController::endByPerson(const HttpRequestPtr& req,
     }
 
     // end_utc:
-    // - якщо передали — має бути валідним непорожнім string
-    // - якщо не передали — ставимо nowUtcIso()
-    std::string endUtc;
+    // - якщо передали — має бути ISO-8601 рядком
+    // - якщо не передали — поточний час
+    std::int64_t endUtcMs = 0;
     if ((*j).isMember("end_utc")) {
-        if (!readNonEmptyStringIfPresent(*j, "end_utc", endUtc)) {
-            cb(jsonError("end_utc must be non-empty string",
+        if (!readIsoTimeIfPresent(*j, "end_utc", endUtcMs)) {
+            cb(jsonError("end_utc must be ISO-8601 string",
                          drogon::k400BadRequest));
             return;
         }
     } else {
-        endUtc = nowUtcIso();
+        endUtcMs = util::nowMs();
     }
 
     try {
         CrewRepo repo;
-        const bool ok = repo.endActiveByPerson(personId, endUtc);
+        const bool ok = repo.endActiveByPerson(personId, endUtcMs);
 
         if (!ok) {
             cb(jsonError("no active assignment", drogon::k404NotFound));
@@ -243,7 +225,7 @@ void CrewController::endByPerson(const HttpRequestPtr& req,
         }
 
         LOG_INFO << "CrewController::endByPerson OK person_id=" << personId
-                 << " end_utc=" << endUtc;
+                 << " end_utc=" << util::formatIsoMs(endUtcMs);
 
         cb(jsonOk("ended"));
     } catch (const std::exception& e) {
@@ -1,10 +1,16 @@
 #include "controllers/LogsController.h"
+#include "controllers/Pagination.h"
 #include "db/Db.h"
+#include "db/Stmt.h"
+#include "util/Time.h"
 
 #include <drogon/drogon.h>
 #include <json/json.h>
 #include <sqlite3.h>
 
+#include <cstring>
+#include <optional>
+
 using drogon::HttpRequestPtr;
 using drogon::HttpResponse;
 using drogon::HttpResponsePtr;
@@ -40,20 +46,21 @@ bool checkExportAuth(const HttpRequestPtr& req) {
     return false;
 }
 
-// RAII for sqlite3_stmt
-class Stmt {
-public:
-    Stmt(sqlite3* db, const char* sql) : db_(db), st_(nullptr) {
-        if (sqlite3_prepare_v2(db_, sql, -1, &st_, nullptr) != SQLITE_OK) {
-            throw std::runtime_error(sqlite3_errmsg(db_));
-        }
+// Колонки часу зберігаються як мс від epoch; у JSON/CSV — ISO-8601
+bool isTimeColumn(const char* name) {
+    for (const char* c : {"ts", "departed_at", "eta", "start_utc", "end_utc"}) {
+        if (std::strcmp(name, c) == 0) return true;
     }
-    ~Stmt() { if (st_) sqlite3_finalize(st_); }
-    sqlite3_stmt* get() const noexcept { return st_; }
-private:
-    sqlite3* db_;
-    sqlite3_stmt* st_;
-};
+    return false;
+}
+
+// Фільтр since/until: ISO-8601 або мс від epoch
+std::optional<std::int64_t> parseTimeParam(const std::string& v) {
+    if (!v.empty() && v.find_first_not_of("0123456789") == std::string::npos) {
+        try { return std::stoll(v); } catch (...) { return std::nullopt; }
+    }
+    return util::parseIsoMs(v);
+}
 
 Json::Value rowToJson(sqlite3_stmt* st) {
     Json::Value obj(Json::objectValue);
@@ -61,7 +68,8 @@ Json::Value rowToJson(sqlite3_stmt* st) {
     for (int i = 0; i < cols; ++i) {
         const char* name = sqlite3_column_name(st, i);
         const int type = sqlite3_column_type(st, i);
-        if (type == SQLITE_INTEGER) obj[name] = (Json::Int64)sqlite3_column_int64(st, i);
+        if (type == SQLITE_INTEGER && isTimeColumn(name)) obj[name] = util::formatIsoMs(sqlite3_column_int64(st, i));
+        else if (type == SQLITE_INTEGER) obj[name] = (Json::Int64)sqlite3_column_int64(st, i);
         else if (type == SQLITE_FLOAT) obj[name] = sqlite3_column_double(st, i);
         else {
             const unsigned char* txt = sqlite3_column_text(st, i);
@@ -91,6 +99,8 @@ Json::Value exportTable(sqlite3* db, const std::string& tableName) {
 void LogsController::list(const HttpRequestPtr& req,
                           std::function<void(const HttpResponsePtr&)>&& cb) {
     try {
+        // async-аудит: показуємо і рядки, що ще в черзі
+        Db::instance().flushLogs();
         sqlite3* db = Db::instance().handle();
 
         // Collect filters from query params
@@ -101,9 +111,18 @@ void LogsController::list(const HttpRequestPtr& req,
         const auto entityId  = req->getParameter("entity_id");
         const auto since     = req->getParameter("since");
         const auto until     = req->getParameter("until");
-        int limit = 100;
-        if (req->getParameter("limit").size()) {
-            try { limit = std::stoi(req->getParameter("limit")); } catch(...) { }
+        const auto sinceMs   = parseTimeParam(since);
+        const auto untilMs   = parseTimeParam(until);
+        if ((!since.empty() && !sinceMs) || (!until.empty() && !untilMs)) {
+            return cb(jsonError("since/until must be ISO-8601 or epoch milliseconds", drogon::k400BadRequest));
+        }
+        // Курсор журналу — (ts, id) останнього рядка: порядок ts DESC, id DESC.
+        // offset лишився для старих клієнтів, з after він ігнорується.
+        int limit = pagination::kDefaultLimit;
+        std::vector<std::int64_t> after;
+        std::string pageErr;
+        if (!pagination::parse(req, limit, after, 2, pageErr)) {
+            return cb(jsonError(pageErr, drogon::k400BadRequest));
         }
 
         std::string sql =
@@ -116,7 +135,9 @@ void LogsController::list(const HttpRequestPtr& req,
         if (!entityId.empty())  sql += " AND entity_id = ?";
         if (!since.empty())     sql += " AND ts >= ?";
         if (!until.empty())     sql += " AND ts <= ?";
-        sql += " ORDER BY ts DESC LIMIT ? OFFSET ?";
+        // ts <= ? окремим термом — щоб SQLite стала на курсор в індексі ts
+        if (!after.empty())     sql += " AND ts <= ? AND (ts < ? OR id < ?)";
+        sql += " ORDER BY ts DESC, id DESC LIMIT ? OFFSET ?";
 
         Stmt st(db, sql.c_str());
         int idx = 1;
@@ -124,17 +145,31 @@ void LogsController::list(const HttpRequestPtr& req,
         if (!eventType.empty()) sqlite3_bind_text(st.get(), idx++, eventType.c_str(), -1, SQLITE_TRANSIENT);
         if (!entity.empty())    sqlite3_bind_text(st.get(), idx++, entity.c_str(), -1, SQLITE_TRANSIENT);
         if (!entityId.empty())  sqlite3_bind_int64(st.get(), idx++, static_cast<long long>(std::stoll(entityId)));
-        if (!since.empty())     sqlite3_bind_text(st.get(), idx++, since.c_str(), -1, SQLITE_TRANSIENT);
-        if (!until.empty())     sqlite3_bind_text(st.get(), idx++, until.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_int(st.get(), idx++, limit);
+        if (!since.empty())     sqlite3_bind_int64(st.get(), idx++, *sinceMs);
+        if (!until.empty())     sqlite3_bind_int64(st.get(), idx++, *untilMs);
+        if (!after.empty()) {
+            sqlite3_bind_int64(st.get(), idx++, after[0]);
+            sqlite3_bind_int64(st.get(), idx++, after[0]);
+            sqlite3_bind_int64(st.get(), idx++, after[1]);
+        }
+        // на рядок більше — ознака наступної сторінки
+        sqlite3_bind_int(st.get(), idx++, limit + 1);
         int offset = 0;
-        if (!offsetStr.empty()) {
+        if (!offsetStr.empty() && after.empty()) {
             try { offset = std::stoi(offsetStr); } catch(...) { offset = 0; }
         }
         sqlite3_bind_int(st.get(), idx++, offset);
 
         Json::Value arr(Json::arrayValue);
+        bool hasMore = false;
+        std::int64_t lastId = 0, lastTs = 0;
         while (sqlite3_step(st.get()) == SQLITE_ROW) {
+            if (static_cast<int>(arr.size()) == limit) {
+                hasMore = true;
+                break;
+            }
+            lastId = sqlite3_column_int64(st.get(), 0);
+            lastTs = sqlite3_column_int64(st.get(), 1);
             arr.append(rowToJson(st.get()));
         }
 
@@ -144,7 +179,11 @@ void LogsController::list(const HttpRequestPtr& req,
             Db::instance().insertLog("INFO", "logs.query", "logs", 0, "system", msg);
         } catch (...) {}
 
-        cb(HttpResponse::newHttpJsonResponse(arr));
+        auto resp = HttpResponse::newHttpJsonResponse(arr);
+        if (hasMore) {
+            pagination::setNext(req, resp, limit, util::encodeCursor({lastTs, lastId}));
+        }
+        cb(resp);
     }
     catch (const std::exception& e) {
         LOG_ERROR << "LogsController::list error: " << e.what();
@@ -159,6 +198,7 @@ void LogsController::exportData(const HttpRequestPtr& req, std::function<void(co
             return cb(jsonError("Unauthorized: missing or invalid token", drogon::k401Unauthorized));
         }
 
+        Db::instance().flushLogs();
         sqlite3* db = Db::instance().handle();
 
         Json::Value root(Json::objectValue);
@@ -188,6 +228,7 @@ void LogsController::exportCsv(const HttpRequestPtr& req, std::function<void(con
             return cb(jsonError("Unauthorized: missing or invalid token", drogon::k401Unauthorized));
         }
 
+        Db::instance().flushLogs();
         sqlite3* db = Db::instance().handle();
 
         // reuse filters from query params similar to list()
@@ -196,6 +237,11 @@ void LogsController::exportCsv(const HttpRequestPtr& req, std::function<void(con
         const auto entityId  = req->getParameter("entity_id");
         const auto since     = req->getParameter("since");
         const auto until     = req->getParameter("until");
+        const auto sinceMs   = parseTimeParam(since);
+        const auto untilMs   = parseTimeParam(until);
+        if ((!since.empty() && !sinceMs) || (!until.empty() && !untilMs)) {
+            return cb(jsonError("since/until must be ISO-8601 or epoch milliseconds", drogon::k400BadRequest));
+        }
 
         std::string sql =
             "SELECT id, ts, level, event_type, entity, entity_id, user, message "
@@ -213,15 +259,16 @@ void LogsController::exportCsv(const HttpRequestPtr& req, std::function<void(con
         if (!eventType.empty()) sqlite3_bind_text(st.get(), idx++, eventType.c_str(), -1, SQLITE_TRANSIENT);
         if (!entity.empty())    sqlite3_bind_text(st.get(), idx++, entity.c_str(), -1, SQLITE_TRANSIENT);
         if (!entityId.empty())  sqlite3_bind_int64(st.get(), idx++, static_cast<long long>(std::stoll(entityId)));
-        if (!since.empty())     sqlite3_bind_text(st.get(), idx++, since.c_str(), -1, SQLITE_TRANSIENT);
-        if (!until.empty())     sqlite3_bind_text(st.get(), idx++, until.c_str(), -1, SQLITE_TRANSIENT);
+        if (!since.empty())     sqlite3_bind_int64(st.get(), idx++, *sinceMs);
+        if (!until.empty())     sqlite3_bind_int64(st.get(), idx++, *untilMs);
 
         // build CSV
         std::string csv = "id,ts,level,event_type,entity,entity_id,user,message\n";
+        util::IsoFormatter isoTs;   // рядки йдуть за ts, секунда часто повторюється
         while (sqlite3_step(st.get()) == SQLITE_ROW) {
             // get columns
             long long id = sqlite3_column_int64(st.get(), 0);
-            const unsigned char* ts = sqlite3_column_text(st.get(), 1);
+            const util::IsoString ts = isoTs.format(sqlite3_column_int64(st.get(), 1));
             const unsigned char* level = sqlite3_column_text(st.get(), 2);
             const unsigned char* ev = sqlite3_column_text(st.get(), 3);
             const unsigned char* en = sqlite3_column_text(st.get(), 4);
@@ -231,7 +278,10 @@ void LogsController::exportCsv(const HttpRequestPtr& req, std::function<void(con
 
             auto esc = [](const unsigned char* s){ if(!s) return std::string(); std::string t = reinterpret_cast<const char*>(s); for(auto &c:t){ if(c=='\n') c=' '; if(c=='\r') c=' '; } return t; };
 
-            csv += std::to_string(id) + "," + (ts?esc(ts):std::string()) + "," + (level?esc(level):std::string()) + "," + (ev?esc(ev):std::string()) + "," + (en?esc(en):std::string()) + "," + std::to_string(eid) + "," + (user?esc(user):std::string()) + ",\"" + (msg?esc(msg):std::string()) + "\"\n";
+            csv += std::to_string(id);
+            csv += ',';
+            csv += ts.view();
+            csv += "," + (level?esc(level):std::string()) + "," + (ev?esc(ev):std::string()) + "," + (en?esc(en):std::string()) + "," + std::to_string(eid) + "," + (user?esc(user):std::string()) + ",\"" + (msg?esc(msg):std::string()) + "\"\n";
         }
 
         // log the export action
@@ -1,5 +1,7 @@
 ﻿#include "controllers/PeopleController.h"
+#include "controllers/Pagination.h"
 #include "repos/PeopleRepo.h"
+#include "db/Db.h"
 #include <drogon/drogon.h>
 #include <json/json.h>
 
@@ -35,10 +37,23 @@ bool hasString(const Json::Value& j, const char* key) {
 } // namespace
 
 // ================== LIST ==================
-void PeopleController::list(const HttpRequestPtr&,
+void PeopleController::list(const HttpRequestPtr& req,
                             std::function<void(const HttpResponsePtr&)>&& cb) {
     try {
         PeopleRepo repo;
+
+        // ?limit=&after= — keyset-сторінка; без них — увесь список, як раніше
+        if (pagination::requested(req)) {
+            PageRequest page;
+            std::string err;
+            if (!pagination::parse(req, page, err)) {
+                cb(jsonError(err, drogon::k400BadRequest));
+                return;
+            }
+            cb(pagination::response(req, repo.page(page), page.limit, personToJson));
+            return;
+        }
+
         auto all = repo.all();
 
         Json::Value arr(Json::arrayValue);
@@ -119,6 +134,8 @@ void PeopleController::updateOne(const HttpRequestPtr& req,
     const auto& j = *jsonPtr;
 
     try {
+        // перевірка + оновлення + аудит — один коміт
+        Db::Transaction tx;
         PeopleRepo repo;
         auto pOpt = repo.byId(id);
         if (!pOpt) {
@@ -131,6 +148,7 @@ void PeopleController::updateOne(const HttpRequestPtr& req,
         if (hasString(j, "rank"))      p.rank      = j["rank"].asString();
 
         repo.update(p);
+        tx.commit();
         
         // Повертаємо оновлений об'єкт
         cb(HttpResponse::newHttpJsonResponse(personToJson(p)));
@@ -146,6 +164,7 @@ void PeopleController::deleteOne(const HttpRequestPtr&,
                                  std::function<void(const HttpResponsePtr&)>&& cb,
                                  std::int64_t id) {
     try {
+        Db::Transaction tx;
         PeopleRepo repo;
         // Перевіряємо, чи існує людина перед видаленням 
         if (!repo.byId(id)) {
@@ -154,6 +173,7 @@ void PeopleController::deleteOne(const HttpRequestPtr&,
         }
 
         repo.remove(id);
+        tx.commit();
 
         auto resp = HttpResponse::newHttpResponse();
         resp->setStatusCode(drogon::k204NoContent);
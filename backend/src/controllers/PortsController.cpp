@@ -1,12 +1,22 @@
 ﻿// src/controllers/PortsController.cpp
 #include "controllers/PortsController.h"
+#include "controllers/Pagination.h"
+#include "geo/DistanceMatrix.h"
+#include "geo/PortIndex.h"
 #include "repos/PortsRepo.h"
+#include "services/RouteMatrixJob.h"
+#include "db/Db.h"
 
 #include <drogon/drogon.h>
 #include <json/json.h>
 
+#include <cmath>
 #include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -61,14 +71,79 @@ HttpStatusCode mapDbErrorToHttp(const std::string& msg) {
     return drogon::k500InternalServerError;
 }
 
+// Число з query-параметра; nullopt — відсутнє або не число
+std::optional<double> queryDouble(const HttpRequestPtr& req, const std::string& key) {
+    const auto& s = req->getParameter(key);
+    if (s.empty()) return std::nullopt;
+    char* end = nullptr;
+    const double v = std::strtod(s.c_str(), &end);
+    if (end != s.c_str() + s.size() || !std::isfinite(v)) return std::nullopt;
+    return v;
+}
+
+// lat/lon точки запиту; false — відповідь з помилкою вже надіслано
+bool parseQueryPoint(const HttpRequestPtr& req,
+                     std::function<void(const HttpResponsePtr&)>& cb,
+                     double& lat, double& lon) {
+    const auto latOpt = queryDouble(req, "lat");
+    const auto lonOpt = queryDouble(req, "lon");
+    if (!latOpt || !lonOpt) {
+        cb(jsonError("lat and lon query parameters are required numbers", drogon::k400BadRequest));
+        return false;
+    }
+    if (*latOpt < -90.0 || *latOpt > 90.0) {
+        cb(jsonError("lat must be between -90 and 90", drogon::k400BadRequest));
+        return false;
+    }
+    if (*lonOpt < -180.0 || *lonOpt > 180.0) {
+        cb(jsonError("lon must be between -180 and 180", drogon::k400BadRequest));
+        return false;
+    }
+    lat = *latOpt;
+    lon = *lonOpt;
+    return true;
+}
+
+Json::Value hitsToJson(double lat, double lon, const std::vector<geo::PortIndex::Hit>& hits) {
+    Json::Value arr(Json::arrayValue);
+    for (const auto& h : hits) {
+        Json::Value j = portToJson(h.port);
+        j["distance_km"] = h.distanceKm;
+        arr.append(std::move(j));
+    }
+
+    Json::Value out;
+    out["lat"]   = lat;
+    out["lon"]   = lon;
+    out["count"] = static_cast<Json::UInt64>(hits.size());
+    out["ports"] = std::move(arr);
+    return out;
+}
+
+constexpr std::size_t kDefaultNearest = 5;
+constexpr std::size_t kMaxNearest = 1000;
+
 } // namespace
 
 // ================== LIST ==================
 
-void PortsController::list(const HttpRequestPtr&,
+void PortsController::list(const HttpRequestPtr& req,
                            std::function<void(const HttpResponsePtr&)>&& cb) {
     try {
         PortsRepo repo;
+
+        // ?limit=&after= — keyset-сторінка; без них — увесь список, як раніше
+        if (pagination::requested(req)) {
+            PageRequest page;
+            std::string err;
+            if (!pagination::parse(req, page, err)) {
+                cb(jsonError(err, drogon::k400BadRequest));
+                return;
+            }
+            cb(pagination::response(req, repo.page(page), page.limit, portToJson));
+            return;
+        }
+
         const auto ports = repo.all();
 
         Json::Value arr(Json::arrayValue);
@@ -125,8 +200,21 @@ void PortsController::create(const HttpRequestPtr& req,
     }
 
     try {
+        Db::Transaction tx;
         PortsRepo repo;
+
+        if (repo.existsByName(p.name)) {
+            cb(jsonError("name already exists", drogon::k409Conflict));
+            return;
+        }
+
         const auto created = repo.create(p);
+        tx.commit();
+
+        geo::DistanceMatrix::instance().upsert(created);
+        geo::PortIndex::instance().upsert(created);
+        // граф маршрутів (і матрицю всіх пар) перебудовує фонова задача
+        RouteMatrixJob::instance().requestGraphRebuild();
 
         auto resp = HttpResponse::newHttpJsonResponse(portToJson(created));
         resp->setStatusCode(drogon::k201Created);
@@ -174,6 +262,7 @@ void PortsController::update(const HttpRequestPtr& req,
     const auto& body = *json;
 
     try {
+        Db::Transaction tx;
         PortsRepo repo;
         const auto portOpt = repo.getById(id);
 
@@ -190,6 +279,12 @@ void PortsController::update(const HttpRequestPtr& req,
                 return;
             }
             p.name = body["name"].asString();
+
+            // нове ім'я зайняте іншим портом
+            if (p.name != portOpt->name && repo.existsByName(p.name)) {
+                cb(jsonError("name already exists", drogon::k409Conflict));
+                return;
+            }
         }
 
         if (body.isMember("region")) {
@@ -231,6 +326,15 @@ void PortsController::update(const HttpRequestPtr& req,
         // - кидає exception при помилці
         // - повертає true навіть якщо значення ті самі
         repo.update(p);
+        tx.commit();
+
+        // перераховує рядок/стовпець, лише якщо змінились координати
+        geo::DistanceMatrix::instance().upsert(p);
+        geo::PortIndex::instance().upsert(p);
+        // назва/регіон на ребра графа не впливають
+        if (p.lat != portOpt->lat || p.lon != portOpt->lon) {
+            RouteMatrixJob::instance().requestGraphRebuild();
+        }
 
         cb(HttpResponse::newHttpJsonResponse(portToJson(p)));
     } catch (const std::exception& e) {
@@ -246,6 +350,7 @@ void PortsController::remove(const HttpRequestPtr&,
                              std::function<void(const HttpResponsePtr&)>&& cb,
                              int64_t id) {
     try {
+        Db::Transaction tx;
         PortsRepo repo;
 
         // Явно перевіряємо існування
@@ -264,6 +369,12 @@ void PortsController::remove(const HttpRequestPtr&,
             return;
         }
 
+        tx.commit();
+
+        geo::DistanceMatrix::instance().remove(id);
+        geo::PortIndex::instance().remove(id);
+        RouteMatrixJob::instance().requestGraphRebuild();
+
         auto resp = HttpResponse::newHttpResponse();
         resp->setStatusCode(drogon::k204NoContent);
         cb(resp);
@@ -273,3 +384,92 @@ void PortsController::remove(const HttpRequestPtr&,
         cb(jsonError("remove failed", mapDbErrorToHttp(e.what()), e.what()));
     }
 }
+
+// ================== DISTANCES ==================
+
+void PortsController::distances(const HttpRequestPtr&,
+                                std::function<void(const HttpResponsePtr&)>&& cb,
+                                int64_t id) {
+    try {
+        auto& matrix = geo::DistanceMatrix::instance();
+        std::vector<geo::DistanceMatrix::Entry> row;
+
+        if (!matrix.row(id, row)) {
+            // порт міг з'явитись в обхід контролера — довантажуємо з БД
+            const auto portOpt = PortsRepo{}.getById(id);
+            if (!portOpt) {
+                cb(jsonError("not found", drogon::k404NotFound));
+                return;
+            }
+            matrix.upsert(*portOpt);
+            matrix.row(id, row);
+        }
+
+        Json::Value arr(Json::arrayValue);
+        for (const auto& e : row) {
+            Json::Value j;
+            j["port_id"]     = Json::Int64(e.portId);
+            j["distance_km"] = e.distanceKm;
+            arr.append(std::move(j));
+        }
+
+        Json::Value out;
+        out["port_id"]   = Json::Int64(id);
+        out["count"]     = static_cast<Json::UInt64>(row.size());
+        out["distances"] = std::move(arr);
+        cb(HttpResponse::newHttpJsonResponse(out));
+    } catch (const std::exception& e) {
+        LOG_ERROR << "PortsController::distances failed id=" << id
+                  << ": " << e.what();
+        cb(jsonError("distances failed", drogon::k500InternalServerError, e.what()));
+    }
+}
+
+// ================== NEAREST / WITHIN ==================
+
+void PortsController::nearest(const HttpRequestPtr& req,
+                              std::function<void(const HttpResponsePtr&)>&& cb) {
+    double lat = 0.0, lon = 0.0;
+    if (!parseQueryPoint(req, cb, lat, lon)) return;
+
+    std::size_t k = kDefaultNearest;
+    if (!req->getParameter("k").empty()) {
+        const auto kOpt = queryDouble(req, "k");
+        if (!kOpt || *kOpt < 1 || *kOpt > static_cast<double>(kMaxNearest) || std::floor(*kOpt) != *kOpt) {
+            cb(jsonError("k must be integer between 1 and " + std::to_string(kMaxNearest),
+                         drogon::k400BadRequest));
+            return;
+        }
+        k = static_cast<std::size_t>(*kOpt);
+    }
+
+    try {
+        const auto hits = geo::PortIndex::instance().nearest(lat, lon, k);
+        cb(HttpResponse::newHttpJsonResponse(hitsToJson(lat, lon, hits)));
+    } catch (const std::exception& e) {
+        LOG_ERROR << "PortsController::nearest failed: " << e.what();
+        cb(jsonError("nearest failed", drogon::k500InternalServerError, e.what()));
+    }
+}
+
+void PortsController::within(const HttpRequestPtr& req,
+                             std::function<void(const HttpResponsePtr&)>&& cb) {
+    double lat = 0.0, lon = 0.0;
+    if (!parseQueryPoint(req, cb, lat, lon)) return;
+
+    const auto radius = queryDouble(req, "radius_km");
+    if (!radius || *radius < 0.0) {
+        cb(jsonError("radius_km must be non-negative number", drogon::k400BadRequest));
+        return;
+    }
+
+    try {
+        const auto hits = geo::PortIndex::instance().within(lat, lon, *radius);
+        Json::Value out = hitsToJson(lat, lon, hits);
+        out["radius_km"] = *radius;
+        cb(HttpResponse::newHttpJsonResponse(out));
+    } catch (const std::exception& e) {
+        LOG_ERROR << "PortsController::within failed: " << e.what();
+        cb(jsonError("within failed", drogon::k500InternalServerError, e.what()));
+    }
+}
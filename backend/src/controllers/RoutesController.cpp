@@ -0,0 +1,174 @@
+﻿// src/controllers/RoutesController.cpp
+#include "controllers/RoutesController.h"
+#include "geo/RouteMatrix.h"
+#include "geo/RoutePlanner.h"
+#include "services/RouteMatrixJob.h"
+#include "util/Time.h"
+
+#include <drogon/drogon.h>
+#include <json/json.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace {
+
+using drogon::HttpRequestPtr;
+using drogon::HttpResponse;
+using drogon::HttpResponsePtr;
+using drogon::HttpStatusCode;
+
+HttpResponsePtr jsonError(const std::string& msg,
+                          HttpStatusCode code,
+                          const std::string& details = {}) {
+    Json::Value e;
+    e["error"] = msg;
+    if (!details.empty()) {
+        e["details"] = details;
+    }
+    auto r = HttpResponse::newHttpJsonResponse(e);
+    r->setStatusCode(code);
+    return r;
+}
+
+// Додатній id з query-параметра; nullopt — відсутній або не число
+std::optional<std::int64_t> queryId(const HttpRequestPtr& req, const std::string& key) {
+    const auto& s = req->getParameter(key);
+    if (s.empty()) return std::nullopt;
+    char* end = nullptr;
+    const long long v = std::strtoll(s.c_str(), &end, 10);
+    if (end != s.c_str() + s.size() || v <= 0) return std::nullopt;
+    return static_cast<std::int64_t>(v);
+}
+
+Json::Value routeToJson(std::int64_t from, std::int64_t to,
+                        const geo::Route& route, bool cached) {
+    Json::Value ports(Json::arrayValue);
+    for (const auto& p : route.ports) {
+        Json::Value j;
+        j["id"]   = Json::Int64(p.id);
+        j["name"] = p.name;
+        j["lat"]  = p.lat;
+        j["lon"]  = p.lon;
+        ports.append(std::move(j));
+    }
+
+    Json::Value out;
+    out["from"]        = Json::Int64(from);
+    out["to"]          = Json::Int64(to);
+    out["distance_km"] = route.distanceKm;
+    out["legs"]        = static_cast<Json::UInt64>(route.ports.empty() ? 0 : route.ports.size() - 1);
+    out["ports"]       = std::move(ports);
+    out["cached"]      = cached;
+    return out;
+}
+
+} // namespace
+
+// ================== PLAN ==================
+
+void RoutesController::plan(const HttpRequestPtr& req,
+                            std::function<void(const HttpResponsePtr&)>&& cb) {
+    const auto from = queryId(req, "from");
+    const auto to = queryId(req, "to");
+    if (!from || !to) {
+        cb(jsonError("from and to query parameters are required port ids", drogon::k400BadRequest));
+        return;
+    }
+
+    try {
+        bool cached = false;
+        const auto route = geo::RoutePlanner::instance().plan(*from, *to, &cached);
+        if (!route) {
+            cb(jsonError("port not found", drogon::k404NotFound));
+            return;
+        }
+        if (!route->found) {
+            cb(jsonError("no route", drogon::k404NotFound,
+                         "ports are not connected by legs within the configured max_leg_km or sea lanes"));
+            return;
+        }
+
+        cb(HttpResponse::newHttpJsonResponse(routeToJson(*from, *to, *route, cached)));
+    } catch (const std::exception& e) {
+        LOG_ERROR << "RoutesController::plan failed from=" << *from << " to=" << *to
+                  << ": " << e.what();
+        cb(jsonError("route planning failed", drogon::k500InternalServerError, e.what()));
+    }
+}
+
+// ================== MATRIX ==================
+
+void RoutesController::matrixStatus(const HttpRequestPtr&,
+                                    std::function<void(const HttpResponsePtr&)>&& cb) {
+    try {
+        const auto job = RouteMatrixJob::instance().status();
+        const auto info = geo::RouteMatrix::instance().info();
+
+        Json::Value out;
+        out["loaded"]    = info.loaded;
+        out["ports"]     = static_cast<Json::UInt64>(info.ports);
+        out["stale"]     = job.stale;
+        out["graph_pending"] = job.graphPending;
+        out["pending"]   = job.pending;
+        out["computing"] = job.computing;
+        out["path"]      = job.path;
+        if (info.loaded) {
+            out["computed_at"] = util::formatIsoMs(info.computedAtMs);
+            out["compute_ms"]  = info.computeMs;
+        }
+        if (!job.lastError.empty()) {
+            out["last_error"]    = job.lastError;
+            out["last_error_at"] = util::formatIsoMs(job.lastErrorAtMs);
+        }
+        cb(HttpResponse::newHttpJsonResponse(out));
+    } catch (const std::exception& e) {
+        LOG_ERROR << "RoutesController::matrixStatus failed: " << e.what();
+        cb(jsonError("matrix status failed", drogon::k500InternalServerError, e.what()));
+    }
+}
+
+void RoutesController::matrixRow(const HttpRequestPtr&,
+                                 std::function<void(const HttpResponsePtr&)>&& cb,
+                                 std::int64_t id) {
+    try {
+        const auto& matrix = geo::RouteMatrix::instance();
+        if (!matrix.info().loaded) {
+            cb(jsonError("route matrix is not ready", drogon::k503ServiceUnavailable,
+                         "see GET /api/routes/matrix"));
+            return;
+        }
+
+        std::vector<geo::RouteMatrix::Entry> row;
+        if (!matrix.row(id, row)) {
+            cb(jsonError("port not found", drogon::k404NotFound,
+                         "port is unknown or newer than the route matrix"));
+            return;
+        }
+
+        Json::Value arr(Json::arrayValue);
+        for (const auto& e : row) {
+            if (e.portId == id) continue;
+            Json::Value j;
+            j["id"] = Json::Int64(e.portId);
+            // недосяжний порт — null
+            j["route_km"] = std::isfinite(e.routeKm) ? Json::Value(e.routeKm) : Json::Value();
+            arr.append(std::move(j));
+        }
+
+        Json::Value out;
+        out["from"]  = Json::Int64(id);
+        out["stale"] = RouteMatrixJob::instance().status().stale;
+        out["count"] = arr.size();
+        out["ports"] = std::move(arr);
+        cb(HttpResponse::newHttpJsonResponse(out));
+    } catch (const std::exception& e) {
+        LOG_ERROR << "RoutesController::matrixRow failed id=" << id << ": " << e.what();
+        cb(jsonError("matrix row failed", drogon::k500InternalServerError, e.what()));
+    }
+}
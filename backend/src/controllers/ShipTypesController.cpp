@@ -1,5 +1,7 @@
 ﻿#include "controllers/ShipTypesController.h"
+#include "controllers/Pagination.h"
 #include "repos/ShipTypesRepo.h"
+#include "db/Db.h"
 
 #include <drogon/drogon.h>
 #include <json/json.h>
@@ -75,10 +77,23 @@ bool isStringOrNull(const Json::Value& v, const char* key) {
 
 // ================== LIST ==================
 
-void ShipTypesController::list(const HttpRequestPtr&,
+void ShipTypesController::list(const HttpRequestPtr& req,
                                std::function<void(const HttpResponsePtr&)>&& cb) {
     try {
         ShipTypesRepo repo;
+
+        // ?limit=&after= — keyset-сторінка; без них — увесь список, як раніше
+        if (pagination::requested(req)) {
+            PageRequest page;
+            std::string err;
+            if (!pagination::parse(req, page, err)) {
+                cb(jsonError(err, drogon::k400BadRequest));
+                return;
+            }
+            cb(pagination::response(req, repo.page(page), page.limit, shipTypeToJson));
+            return;
+        }
+
         const auto vec = repo.all();
 
         Json::Value arr(Json::arrayValue);
@@ -177,6 +192,7 @@ void ShipTypesController::updateOne(const HttpRequestPtr& req,
     }
 
     try {
+        Db::Transaction tx;
         ShipTypesRepo repo;
         const auto cur = repo.byCode(code);
 
@@ -210,6 +226,7 @@ void ShipTypesController::updateOne(const HttpRequestPtr& req,
         }
 
         repo.update(t);
+        tx.commit();
 
         cb(jsonOk("updated"));
     } catch (const std::exception& ex) {
@@ -225,6 +242,7 @@ void ShipTypesController::deleteOne(const HttpRequestPtr&,
                                     std::function<void(const HttpResponsePtr&)>&& cb,
                                     const std::string& code) {
     try {
+        Db::Transaction tx;
         ShipTypesRepo repo;
 
         const auto cur = repo.byCode(code);
@@ -234,6 +252,7 @@ void ShipTypesController::deleteOne(const HttpRequestPtr&,
         }
 
         repo.remove(cur->id);
+        tx.commit();
 
         auto r = HttpResponse::newHttpResponse();
         r->setStatusCode(drogon::k204NoContent);
@@ -1,7 +1,15 @@
 ﻿// src/controllers/ShipsController.cpp
 #include "controllers/ShipsController.h"
+#include "controllers/Pagination.h"
+#include "geo/DistanceMatrix.h"
+#include "geo/Geo.h"
+#include "repos/PortsRepo.h"
 #include "repos/ShipsRepo.h"
+#include "services/ArrivalScheduler.h"
+#include "services/Voyage.h"
 #include "db/Db.h"
+#include "db/Stmt.h"
+#include "util/Time.h"
 
 #include <drogon/drogon.h>
 #include <json/json.h>
@@ -10,13 +18,15 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
-#include <ctime>
-#include <iomanip>
-#include <sstream>
+#include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <stdexcept>
+#include <vector>
 
 namespace {
 
@@ -77,18 +87,35 @@ Json::Value shipToJson(const Ship& s) {
     j["speed_knots"] = s.speed_knots;
 
     // Voyage tracking fields
-    j["departed_at"] = s.departed_at.empty() ? Json::Value(Json::nullValue) : s.departed_at;
+    // Час у БД — мс від epoch; назовні — ISO-8601 UTC
+    j["departed_at"] = s.departed_at > 0 ? Json::Value(util::formatIsoMs(s.departed_at))
+                                         : Json::Value(Json::nullValue);
     
     j["destination_port_id"] =
         (s.destination_port_id > 0) ? Json::Value(Json::Int64(s.destination_port_id))
                                     : Json::Value(Json::nullValue);
     
-    j["eta"] = s.eta.empty() ? Json::Value(Json::nullValue) : s.eta;
+    j["eta"] = s.eta > 0 ? Json::Value(util::formatIsoMs(s.eta))
+                         : Json::Value(Json::nullValue);
     j["voyage_distance_km"] = s.voyage_distance_km;
 
     return j;
 }
 
+// ISO-8601 рядок або null -> мс від epoch (0 = не задано).
+// false — значення не рядок або не розпізнається як дата.
+bool readOptionalIsoTime(const Json::Value& v, std::int64_t& outMs) {
+    if (v.isNull()) {
+        outMs = 0;
+        return true;
+    }
+    if (!v.isString()) return false;
+    const auto ms = util::parseIsoMs(v.asString());
+    if (!ms) return false;
+    outMs = *ms;
+    return true;
+}
+
 // ---------------- Status rules ----------------
 
 constexpr std::array<std::string_view, 4> kShipStatuses = {
@@ -130,7 +157,6 @@ int countActiveCrewWithRank2(sqlite3* db,
                              std::int64_t shipId,
                              std::string_view rank1,
                              std::string_view rank2) {
-    sqlite3_stmt* st = nullptr;
     const char* sql =
         "SELECT COUNT(*) "
         "FROM crew_assignments c "
@@ -139,26 +165,22 @@ int countActiveCrewWithRank2(sqlite3* db,
         "  AND c.end_utc IS NULL "
         "  AND (p.rank = ? COLLATE NOCASE OR p.rank = ? COLLATE NOCASE);";
 
-    if (sqlite3_prepare_v2(db, sql, -1, &st, nullptr) != SQLITE_OK) {
-        LOG_ERROR << "Failed to prepare SQL: " << sqlite3_errmsg(db);
-        throw std::runtime_error(sqlite3_errmsg(db));
-    }
+    Stmt st(db, sql);
 
-    sqlite3_bind_int64(st, 1, shipId);
-    sqlite3_bind_text(st, 2, rank1.data(), static_cast<int>(rank1.size()), SQLITE_TRANSIENT);
-    sqlite3_bind_text(st, 3, rank2.data(), static_cast<int>(rank2.size()), SQLITE_TRANSIENT);
+    sqlite3_bind_int64(st.get(), 1, shipId);
+    sqlite3_bind_text(st.get(), 2, rank1.data(), static_cast<int>(rank1.size()), SQLITE_TRANSIENT);
+    sqlite3_bind_text(st.get(), 3, rank2.data(), static_cast<int>(rank2.size()), SQLITE_TRANSIENT);
 
     LOG_DEBUG << "Searching for captain on ship " << shipId 
               << " with ranks: '" << rank1 << "' or '" << rank2 << "'";
 
     int cnt = 0;
-    if (sqlite3_step(st) == SQLITE_ROW) {
-        cnt = sqlite3_column_int(st, 0);
+    if (sqlite3_step(st.get()) == SQLITE_ROW) {
+        cnt = sqlite3_column_int(st.get(), 0);
     }
 
     LOG_DEBUG << "Found " << cnt << " active captains";
 
-    sqlite3_finalize(st);
     return cnt;
 }
 
@@ -183,86 +205,59 @@ bool canShipDepart(sqlite3* db, const Ship& ship, std::string& reasonOut) {
     return true;
 }
 
-// ---------------- Error mapping helper ----------------
+// ---------------- Voyage planning ----------------
 
-HttpStatusCode mapDbErrorToHttp(const std::string& msg) {
-    if (msg.find("UNIQUE") != std::string::npos ||
-        msg.find("unique") != std::string::npos) {
-        return drogon::k409Conflict;
-    }
-    if (msg.find("FOREIGN KEY") != std::string::npos ||
-        msg.find("foreign key") != std::string::npos) {
-        return drogon::k409Conflict;
-    }
-    if (msg.find("NOT NULL") != std::string::npos ||
-        msg.find("not null") != std::string::npos) {
-        return drogon::k400BadRequest;
-    }
-    return drogon::k500InternalServerError;
+// Пройдена частка рейсу в [0, 1] на момент nowMs
+double voyageProgress(std::int64_t departedAt, std::int64_t eta, std::int64_t nowMs) {
+    if (departedAt <= 0 || nowMs <= departedAt) return 0.0;
+    if (eta <= departedAt || nowMs >= eta) return 1.0;
+    return static_cast<double>(nowMs - departedAt) / static_cast<double>(eta - departedAt);
 }
 
-} // namespace
-
-// ================== LIST ==================
-
-void ShipsController::list(const HttpRequestPtr&,
-                           std::function<void(const HttpResponsePtr&)>&& cb) {
-    try {
-        ShipsRepo repo;
-        const auto ships = repo.all();
+// ---------------- Create validation ----------------
 
-        Json::Value arr(Json::arrayValue);
-        for (const auto& s : ships) {
-            arr.append(shipToJson(s));
-        }
+// Помилка у тілі create; invalidStatus — віддати invalidStatusResponse
+struct ShipInputError {
+    std::string message;
+    HttpStatusCode code{drogon::k400BadRequest};
+    std::string details;
+    bool invalidStatus{false};
+};
 
-        cb(HttpResponse::newHttpJsonResponse(arr));
-    } catch (const std::exception& ex) {
-        LOG_ERROR << "ShipsController::list failed: " << ex.what();
-        cb(jsonError("list failed", drogon::k500InternalServerError, ex.what()));
-    }
+ShipInputError inputError(std::string message,
+                          HttpStatusCode code = drogon::k400BadRequest,
+                          std::string details = {}) {
+    return ShipInputError{std::move(message), code, std::move(details), false};
 }
 
-// ================== CREATE ==================
-
-void ShipsController::create(const HttpRequestPtr& req,
-                             std::function<void(const HttpResponsePtr&)>&& cb) {
-    const auto j = req->getJsonObject();
-    if (!j) {
-        cb(jsonError("json body required", drogon::k400BadRequest));
-        return;
+// Правила POST /api/ships, спільні для create і bulk.
+// nullopt — s заповнено і готово до вставки.
+std::optional<ShipInputError> parseNewShip(const Json::Value& body, Ship& s) {
+    if (!body.isObject()) {
+        return inputError("json object required");
     }
 
-    const auto& body = *j;
-
     if (!hasNonEmptyString(body, "name")) {
-        cb(jsonError("name is required", drogon::k400BadRequest));
-        return;
+        return inputError("name is required");
     }
 
     if (body.isMember("type") && !body["type"].isString()) {
-        cb(jsonError("type must be string", drogon::k400BadRequest));
-        return;
+        return inputError("type must be string");
     }
     if (body.isMember("country") && !body["country"].isString()) {
-        cb(jsonError("country must be string", drogon::k400BadRequest));
-        return;
+        return inputError("country must be string");
     }
     if (body.isMember("status") && !body["status"].isString()) {
-        cb(jsonError("status must be string", drogon::k400BadRequest));
-        return;
+        return inputError("status must be string");
     }
 
     if (body.isMember("port_id") && !body["port_id"].isNull() && !isIntegral(body["port_id"])) {
-        cb(jsonError("port_id must be integer or null", drogon::k400BadRequest));
-        return;
+        return inputError("port_id must be integer or null");
     }
     if (body.isMember("company_id") && !body["company_id"].isNull() && !isIntegral(body["company_id"])) {
-        cb(jsonError("company_id must be integer or null", drogon::k400BadRequest));
-        return;
+        return inputError("company_id must be integer or null");
     }
 
-    Ship s;
     s.name       = body["name"].asString();
     s.type       = body.isMember("type")    ? body["type"].asString()    : "cargo";
     s.country    = body.isMember("country") ? body["country"].asString() : "Unknown";
@@ -282,58 +277,206 @@ void ShipsController::create(const HttpRequestPtr& req,
                     : 20.0;
 
     // Voyage tracking fields
-    s.departed_at = (body.isMember("departed_at") && !body["departed_at"].isNull())
-                    ? body["departed_at"].asString()
-                    : "";
+    if (body.isMember("departed_at") && !readOptionalIsoTime(body["departed_at"], s.departed_at)) {
+        return inputError("departed_at must be ISO-8601 string or null");
+    }
     
     s.destination_port_id = (body.isMember("destination_port_id") && !body["destination_port_id"].isNull())
                             ? body["destination_port_id"].asInt64()
                             : 0;
     
-    s.eta = (body.isMember("eta") && !body["eta"].isNull())
-            ? body["eta"].asString()
-            : "";
+    if (body.isMember("eta") && !readOptionalIsoTime(body["eta"], s.eta)) {
+        return inputError("eta must be ISO-8601 string or null");
+    }
     
     s.voyage_distance_km = (body.isMember("voyage_distance_km") && !body["voyage_distance_km"].isNull())
                            ? body["voyage_distance_km"].asDouble()
                            : 0.0;
 
     if (s.port_id < 0 || s.company_id < 0) {
-        cb(jsonError("port_id/company_id cannot be negative", drogon::k400BadRequest));
-        return;
+        return inputError("port_id/company_id cannot be negative");
     }
 
     if (!isValidStatus(s.status)) {
-        cb(invalidStatusResponse(s.status));
-        return;
+        ShipInputError e = inputError("invalid status");
+        e.invalidStatus = true;
+        return e;
+    }
+
+    // ✅ не дозволяємо створювати departed напряму
+    if (s.status == "departed") {
+        return inputError("cannot create ship with status 'departed'",
+                          drogon::k409Conflict,
+                          "Set status later via update with captain check.");
+    }
+
+    return std::nullopt;
+}
+
+// ---------------- Bulk import ----------------
+
+constexpr std::size_t kBulkMaxRows   = 100000; // більше — 413
+constexpr std::size_t kBulkMaxErrors = 1000;   // у відповіді, решта лише рахується
+
+// Рядок імпорту: розібраний JSON або помилка парсингу
+struct BulkRow {
+    Json::Value value;
+    std::string parseError;
+};
+
+bool parseJsonText(const char* begin, const char* end, Json::Value& out, std::string& err) {
+    static const Json::CharReaderBuilder builder;
+    const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    return reader->parse(begin, end, &out, &err);
+}
+
+bool isNdjson(const HttpRequestPtr& req, std::string_view body) {
+    const auto& ct = req->getHeader("content-type");
+    if (ct.find("ndjson") != std::string::npos) return true;
+    if (ct.find("json-seq") != std::string::npos) return true;
+
+    const auto first = body.find_first_not_of(" \t\r\n");
+    return first != std::string_view::npos && body[first] != '[';
+}
+
+// Розбирає тіло у рядки. false — тіло непридатне загалом (err заповнено)
+bool splitBulkBody(const HttpRequestPtr& req, std::vector<BulkRow>& rows, std::string& err) {
+    const std::string_view body = req->getBody();
+
+    if (!isNdjson(req, body)) {
+        Json::Value arr;
+        if (!parseJsonText(body.data(), body.data() + body.size(), arr, err)) return false;
+        if (!arr.isArray()) {
+            err = "json array required";
+            return false;
+        }
+        if (arr.size() > kBulkMaxRows) return true; // перевіряє викликач
+        rows.reserve(arr.size());
+        for (auto& v : arr) {
+            rows.push_back(BulkRow{std::move(v), {}});
+        }
+        return true;
     }
 
-    // ✅ Check for duplicate ship name
+    // NDJSON: кожен непорожній рядок — окремий об'єкт; зламаний рядок
+    // стає помилкою цього рядка, а не всього запиту
+    std::size_t pos = 0;
+    while (pos < body.size() && rows.size() <= kBulkMaxRows) {
+        auto eol = body.find('\n', pos);
+        if (eol == std::string_view::npos) eol = body.size();
+        std::string_view line = body.substr(pos, eol - pos);
+        pos = eol + 1;
+
+        const auto first = line.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos) continue;
+        line.remove_prefix(first);
+
+        BulkRow row;
+        std::string lineErr;
+        if (!parseJsonText(line.data(), line.data() + line.size(), row.value, lineErr)) {
+            row.parseError = "invalid json";
+        }
+        rows.push_back(std::move(row));
+    }
+    return true;
+}
+
+Json::Value bulkRowError(std::size_t row, const std::string& error, const Json::Value& input) {
+    Json::Value e;
+    e["row"] = static_cast<Json::UInt64>(row);
+    e["error"] = error;
+    if (input.isObject() && input["name"].isString()) {
+        e["name"] = input["name"].asString();
+    }
+    return e;
+}
+
+// ---------------- Error mapping helper ----------------
+
+HttpStatusCode mapDbErrorToHttp(const std::string& msg) {
+    if (msg.find("UNIQUE") != std::string::npos ||
+        msg.find("unique") != std::string::npos) {
+        return drogon::k409Conflict;
+    }
+    if (msg.find("FOREIGN KEY") != std::string::npos ||
+        msg.find("foreign key") != std::string::npos) {
+        return drogon::k409Conflict;
+    }
+    if (msg.find("NOT NULL") != std::string::npos ||
+        msg.find("not null") != std::string::npos) {
+        return drogon::k400BadRequest;
+    }
+    return drogon::k500InternalServerError;
+}
+
+} // namespace
+
+// ================== LIST ==================
+
+void ShipsController::list(const HttpRequestPtr& req,
+                           std::function<void(const HttpResponsePtr&)>&& cb) {
     try {
         ShipsRepo repo;
-        const auto existing = repo.all();
-        for (const auto& ship : existing) {
-            if (ship.name == s.name) {
-                cb(jsonError("ship name already exists", drogon::k409Conflict,
-                             "Ship names must be unique. '" + s.name + "' is already in use."));
+
+        // ?limit=&after= — keyset-сторінка; без них — увесь список, як раніше
+        if (pagination::requested(req)) {
+            PageRequest page;
+            std::string err;
+            if (!pagination::parse(req, page, err)) {
+                cb(jsonError(err, drogon::k400BadRequest));
                 return;
             }
+            cb(pagination::response(req, repo.page(page), page.limit, shipToJson));
+            return;
+        }
+
+        const auto ships = repo.all();
+
+        Json::Value arr(Json::arrayValue);
+        for (const auto& s : ships) {
+            arr.append(shipToJson(s));
         }
-    } catch (...) {
-        // Proceed without duplicate check if query fails
+
+        cb(HttpResponse::newHttpJsonResponse(arr));
+    } catch (const std::exception& ex) {
+        LOG_ERROR << "ShipsController::list failed: " << ex.what();
+        cb(jsonError("list failed", drogon::k500InternalServerError, ex.what()));
     }
+}
 
-    // ✅ не дозволяємо створювати departed напряму
-    if (s.status == "departed") {
-        cb(jsonError("cannot create ship with status 'departed'",
-                     drogon::k409Conflict,
-                     "Set status later via update with captain check."));
+// ================== CREATE ==================
+
+void ShipsController::create(const HttpRequestPtr& req,
+                             std::function<void(const HttpResponsePtr&)>&& cb) {
+    const auto j = req->getJsonObject();
+    if (!j) {
+        cb(jsonError("json body required", drogon::k400BadRequest));
+        return;
+    }
+
+    const auto& body = *j;
+
+    Ship s;
+    if (const auto err = parseNewShip(body, s)) {
+        cb(err->invalidStatus ? invalidStatusResponse(s.status)
+                              : jsonError(err->message, err->code, err->details));
         return;
     }
 
     try {
+        // перевірка імені і вставка — в одній транзакції
+        Db::Transaction tx;
         ShipsRepo repo;
+
+        // ✅ Check for duplicate ship name (UNIQUE-індекс, не скан флоту)
+        if (repo.existsByName(s.name)) {
+            cb(jsonError("ship name already exists", drogon::k409Conflict,
+                         "Ship names must be unique. '" + s.name + "' is already in use."));
+            return;
+        }
+
         const Ship created = repo.create(s);
+        tx.commit();
 
         auto resp = HttpResponse::newHttpJsonResponse(shipToJson(created));
         resp->setStatusCode(drogon::k201Created);
@@ -347,6 +490,158 @@ void ShipsController::create(const HttpRequestPtr& req,
     }
 }
 
+// ================== BULK CREATE ==================
+
+// POST /api/ships/bulk
+// Правила ті самі, що в create; вставка — одним prepared statement в одній
+// транзакції (ShipsRepo::createMany) і один підсумковий запис аудиту.
+// Непридатні рядки не зупиняють імпорт, а повертаються в errors.
+void ShipsController::bulkCreate(const HttpRequestPtr& req,
+                                 std::function<void(const HttpResponsePtr&)>&& cb) {
+    std::vector<BulkRow> rows;
+    std::string err;
+    if (!splitBulkBody(req, rows, err)) {
+        cb(jsonError("json array or ndjson body required", drogon::k400BadRequest, err));
+        return;
+    }
+    if (rows.size() > kBulkMaxRows) {
+        cb(jsonError("too many rows", drogon::k413RequestEntityTooLarge,
+                     "At most " + std::to_string(kBulkMaxRows) + " ships per request."));
+        return;
+    }
+
+    Json::Value errors(Json::arrayValue);
+    std::size_t failed = 0;
+    auto addError = [&](std::size_t row, const std::string& msg) {
+        ++failed;
+        if (errors.size() < kBulkMaxErrors) {
+            errors.append(bulkRowError(row, msg, rows[row].value));
+        }
+    };
+
+    std::vector<Ship> ships;
+    std::vector<std::size_t> rowOf; // індекс у ships -> номер рядка у запиті
+    ships.reserve(rows.size());
+    rowOf.reserve(rows.size());
+
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        if (!rows[i].parseError.empty()) {
+            addError(i, rows[i].parseError);
+            continue;
+        }
+        Ship s;
+        if (const auto e = parseNewShip(rows[i].value, s)) {
+            addError(i, e->invalidStatus ? "invalid status" : e->message);
+            continue;
+        }
+        ships.push_back(std::move(s));
+        rowOf.push_back(i);
+    }
+
+    ShipsRepo::BulkResult result;
+    try {
+        result = ShipsRepo{}.createMany(ships);
+    } catch (const std::exception& ex) {
+        LOG_ERROR << "ShipsController::bulkCreate failed rows=" << rows.size()
+                  << ": " << ex.what();
+        cb(jsonError("failed to import", mapDbErrorToHttp(ex.what()), ex.what()));
+        return;
+    }
+
+    for (const auto& e : result.errors) {
+        const bool dup = e.message.find("UNIQUE") != std::string::npos;
+        addError(rowOf[e.index], dup ? "ship name already exists" : e.message);
+    }
+
+    // помилки у порядку рядків запиту
+    if (!result.errors.empty()) {
+        std::vector<Json::Value> sorted(errors.begin(), errors.end());
+        std::stable_sort(sorted.begin(), sorted.end(), [](const Json::Value& a, const Json::Value& b) {
+            return a["row"].asUInt64() < b["row"].asUInt64();
+        });
+        errors = Json::Value(Json::arrayValue);
+        for (auto& v : sorted) errors.append(std::move(v));
+    }
+
+    Json::Value out;
+    out["received"] = static_cast<Json::UInt64>(rows.size());
+    out["inserted"] = static_cast<Json::UInt64>(result.inserted);
+    out["failed"]   = static_cast<Json::UInt64>(failed);
+    out["errors"]   = std::move(errors);
+    if (failed > kBulkMaxErrors) out["errors_truncated"] = true;
+
+    auto resp = HttpResponse::newHttpJsonResponse(out);
+    resp->setStatusCode(failed == 0 ? drogon::k201Created : drogon::k200OK);
+    cb(resp);
+}
+
+// ================== POSITIONS ==================
+
+// GET /api/ships/positions
+// Усі кораблі в дорозі одним пакетом: координати портів з кешу
+// geo::DistanceMatrix, точка на великому колі за пройденою часткою
+// часу — одним векторизованим проходом geo::interpolateGreatCircle.
+void ShipsController::positions(const HttpRequestPtr&,
+                                std::function<void(const HttpResponsePtr&)>&& cb) {
+    try {
+        const auto started = std::chrono::steady_clock::now();
+        const std::int64_t nowMs = util::nowMs();
+
+        const auto ships = ShipsRepo{}.inFlight();
+        const std::size_t n = ships.size();
+
+        // [0, n) — порти відправлення, [n, 2n) — призначення
+        std::vector<std::int64_t> portIds(2 * n);
+        std::vector<double> frac(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            portIds[i]     = ships[i].originPortId;
+            portIds[n + i] = ships[i].destinationPortId;
+            frac[i] = voyageProgress(ships[i].departedAt, ships[i].eta, nowMs);
+        }
+
+        std::vector<double> lat(2 * n), lon(2 * n);
+        geo::DistanceMatrix::instance().coordsOf(portIds.data(), 2 * n, lat.data(), lon.data());
+
+        std::vector<double> posLat(n), posLon(n);
+        geo::interpolateGreatCircle(lat.data(), lon.data(), lat.data() + n, lon.data() + n,
+                                    frac.data(), posLat.data(), posLon.data(), n);
+
+        Json::Value arr(Json::arrayValue);
+        std::size_t unplaced = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            // порт невідомий (NaN) — позицію не вигадуємо
+            if (std::isnan(posLat[i]) || std::isnan(posLon[i])) {
+                ++unplaced;
+                continue;
+            }
+            const auto& s = ships[i];
+            Json::Value j;
+            j["id"]                  = Json::Int64(s.id);
+            j["name"]                = s.name;
+            j["lat"]                 = posLat[i];
+            j["lon"]                 = posLon[i];
+            j["progress"]            = frac[i];
+            j["origin_port_id"]      = Json::Int64(s.originPortId);
+            j["destination_port_id"] = Json::Int64(s.destinationPortId);
+            j["eta"]                 = util::formatIsoMs(s.eta);
+            arr.append(std::move(j));
+        }
+
+        Json::Value out;
+        out["ts"]       = util::formatIsoMs(nowMs);
+        out["count"]    = static_cast<Json::UInt64>(arr.size());
+        out["unplaced"] = static_cast<Json::UInt64>(unplaced);
+        out["ships"]    = std::move(arr);
+        out["elapsed_ms"] = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - started).count();
+
+        cb(HttpResponse::newHttpJsonResponse(out));
+    } catch (const std::exception& ex) {
+        LOG_ERROR << "ShipsController::positions failed: " << ex.what();
+        cb(jsonError("failed to compute positions", drogon::k500InternalServerError, ex.what()));
+    }
+}
+
 // ================== GET ONE ==================
 
 void ShipsController::getOne(const HttpRequestPtr&,
@@ -381,6 +676,8 @@ void ShipsController::updateOne(const HttpRequestPtr& req,
     const auto& body = *j;
 
     try {
+        // перевірка canShipDepart і оновлення бачать один знімок
+        Db::Transaction tx;
         ShipsRepo repo;
         const auto curOpt = repo.byId(id);
         if (!curOpt) {
@@ -494,15 +791,9 @@ void ShipsController::updateOne(const HttpRequestPtr& req,
         }
 
         // Voyage tracking fields
-        if (body.isMember("departed_at")) {
-            if (body["departed_at"].isNull()) {
-                s.departed_at = "";
-            } else if (body["departed_at"].isString()) {
-                s.departed_at = body["departed_at"].asString();
-            } else {
-                cb(jsonError("departed_at must be string or null", drogon::k400BadRequest));
-                return;
-            }
+        if (body.isMember("departed_at") && !readOptionalIsoTime(body["departed_at"], s.departed_at)) {
+            cb(jsonError("departed_at must be ISO-8601 string or null", drogon::k400BadRequest));
+            return;
         }
 
         if (body.isMember("destination_port_id")) {
@@ -520,15 +811,9 @@ void ShipsController::updateOne(const HttpRequestPtr& req,
             }
         }
 
-        if (body.isMember("eta")) {
-            if (body["eta"].isNull()) {
-                s.eta = "";
-            } else if (body["eta"].isString()) {
-                s.eta = body["eta"].asString();
-            } else {
-                cb(jsonError("eta must be string or null", drogon::k400BadRequest));
-                return;
-            }
+        if (body.isMember("eta") && !readOptionalIsoTime(body["eta"], s.eta)) {
+            cb(jsonError("eta must be ISO-8601 string or null", drogon::k400BadRequest));
+            return;
         }
 
         if (body.isMember("voyage_distance_km")) {
@@ -546,7 +831,15 @@ void ShipsController::updateOne(const HttpRequestPtr& req,
             }
         }
 
+        const std::int64_t nowMs = util::nowMs();
+        applyVoyagePlan(*curOpt, s, nowMs);
+
         repo.update(s);
+        recordVoyage(*curOpt, s, nowMs);
+        tx.commit();
+
+        // status/eta/speed могли змінитись — переплановуємо прибуття
+        ArrivalScheduler::instance().track(s);
 
         cb(jsonOk("updated"));
     } catch (const std::exception& ex) {
@@ -564,6 +857,7 @@ void ShipsController::deleteOne(const HttpRequestPtr&,
                                 std::function<void(const HttpResponsePtr&)>&& cb,
                                 std::int64_t id) {
     try {
+        Db::Transaction tx;
         ShipsRepo repo;
 
         const auto curOpt = repo.byId(id);
@@ -573,6 +867,9 @@ void ShipsController::deleteOne(const HttpRequestPtr&,
         }
 
         repo.remove(id);
+        tx.commit();
+
+        ArrivalScheduler::instance().cancel(id);
 
         auto r = HttpResponse::newHttpResponse();
         r->setStatusCode(drogon::k204NoContent);
@@ -591,58 +888,26 @@ void ShipsController::deleteOne(const HttpRequestPtr&,
 void ShipsController::processArrivals(const HttpRequestPtr&,
                                       std::function<void(const HttpResponsePtr&)>&& cb) {
     try {
-        ShipsRepo repo;
-        const auto ships = repo.all();
-
-        // Поточний час в UTC
-        auto now = std::chrono::system_clock::now();
-        auto now_time_t = std::chrono::system_clock::to_time_t(now);
-        
-        int arrivedCount = 0;
+        const auto started = std::chrono::steady_clock::now();
 
-        for (const auto& ship : ships) {
-            // Перевіряємо тільки кораблі в статусі departed
-            if (ship.status != "departed") {
-                continue;
-            }
+        // Поточний час, мс від epoch
+        const std::int64_t nowMs = util::nowMs();
 
-            // Якщо немає ETA, пропускаємо
-            if (ship.eta.empty()) {
-                continue;
-            }
+        // усі прибуття тіку — один UPDATE і один коміт разом з аудитом
+        const auto arrived = ShipsRepo{}.dockDueArrivals(nowMs);
+        const int arrivedCount = static_cast<int>(arrived.size());
 
-            // Парсимо ETA (формат ISO 8601: 2025-12-21T10:02:00)
-            std::tm eta_tm = {};
-            std::istringstream ss(ship.eta);
-            ss >> std::get_time(&eta_tm, "%Y-%m-%dT%H:%M:%S");
-            
-            if (ss.fail()) {
-                LOG_WARN << "Failed to parse ETA for ship " << ship.id << ": " << ship.eta;
-                continue;
-            }
+        const double elapsedMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - started).count();
 
-            auto eta_time_t = std::mktime(&eta_tm);
-            
-            // Якщо поточний час >= ETA, корабель прибув
-            if (now_time_t >= eta_time_t) {
-                Ship updatedShip = ship;
-                updatedShip.status = "docked";
-                updatedShip.port_id = ship.destination_port_id;
-                updatedShip.destination_port_id = 0;
-                updatedShip.departed_at = "";
-                updatedShip.eta = "";
-                updatedShip.voyage_distance_km = 0.0;
-
-                repo.update(updatedShip);
-                arrivedCount++;
-
-                LOG_INFO << "Ship " << ship.id << " (" << ship.name 
-                         << ") arrived at port " << updatedShip.port_id;
-            }
+        for (const auto& ship : arrived) {
+            LOG_INFO << "Ship " << ship.id << " (" << ship.name 
+                     << ") arrived at port " << ship.destination_port_id;
         }
 
         Json::Value result;
         result["processed"] = arrivedCount;
+        result["elapsed_ms"] = elapsedMs;
         result["message"] = arrivedCount > 0 
             ? "Ships arrived and docked successfully"
             : "No ships ready to arrive";
@@ -0,0 +1,208 @@
+﻿// src/controllers/VoyagesController.cpp
+#include "controllers/VoyagesController.h"
+#include "controllers/Pagination.h"
+#include "repos/VoyagesRepo.h"
+#include "util/Time.h"
+
+#include <drogon/drogon.h>
+#include <json/json.h>
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+
+namespace {
+
+using drogon::HttpRequestPtr;
+using drogon::HttpResponse;
+using drogon::HttpResponsePtr;
+using drogon::HttpStatusCode;
+
+// Вікно аналітики за замовчуванням: останні 30 днів
+constexpr std::int64_t kDefaultWindowMs = 30LL * 24 * 3600 * 1000;
+
+constexpr double kMsPerHour = 3600.0 * 1000.0;
+
+HttpResponsePtr jsonError(const std::string& msg,
+                          HttpStatusCode code,
+                          const std::string& details = {}) {
+    Json::Value e;
+    e["error"] = msg;
+    if (!details.empty()) {
+        e["details"] = details;
+    }
+    auto r = HttpResponse::newHttpJsonResponse(e);
+    r->setStatusCode(code);
+    return r;
+}
+
+Json::Value isoOrNull(std::int64_t ms) {
+    return ms > 0 ? Json::Value(util::formatIsoMs(ms)) : Json::Value();
+}
+
+Json::Value voyageToJson(const Voyage& v) {
+    Json::Value j;
+    j["id"]                  = Json::Int64(v.id);
+    j["ship_id"]             = Json::Int64(v.ship_id);
+    j["origin_port_id"]      = Json::Int64(v.origin_port_id);
+    j["destination_port_id"] = Json::Int64(v.destination_port_id);
+    j["departed_at"]         = isoOrNull(v.departed_at);
+    j["planned_eta"]         = isoOrNull(v.planned_eta);
+    j["arrived_at"]          = isoOrNull(v.arrived_at);
+    j["distance_km"]         = v.distance_km;
+    j["speed_knots"]         = v.speed_knots;
+    // > 0 — запізнення, мс
+    j["delay_ms"] = v.arrived_at > 0 && v.planned_eta > 0
+        ? Json::Value(Json::Int64(v.arrived_at - v.planned_eta)) : Json::Value();
+    return j;
+}
+
+// Додатній id з query-параметра в out (0 — відсутній); false — некоректний
+bool queryId(const HttpRequestPtr& req, const std::string& key, std::int64_t& out) {
+    out = 0;
+    const auto& s = req->getParameter(key);
+    if (s.empty()) return true;
+    if (s.size() > 18 || s.find_first_not_of("0123456789") != std::string::npos) return false;
+    out = std::stoll(s);
+    return out > 0;
+}
+
+// Фільтр since/until: ISO-8601 або мс від epoch
+std::optional<std::int64_t> parseTimeParam(const std::string& v) {
+    if (!v.empty() && v.find_first_not_of("0123456789") == std::string::npos) {
+        try { return std::stoll(v); } catch (...) { return std::nullopt; }
+    }
+    return util::parseIsoMs(v);
+}
+
+// Вікно [since, until); false — відповідь з помилкою вже надіслано
+bool parseWindow(const HttpRequestPtr& req,
+                 std::function<void(const HttpResponsePtr&)>& cb,
+                 std::int64_t nowMs, std::int64_t& sinceMs, std::int64_t& untilMs) {
+    const auto& since = req->getParameter("since");
+    const auto& until = req->getParameter("until");
+    const auto sinceOpt = since.empty() ? std::nullopt : parseTimeParam(since);
+    const auto untilOpt = until.empty() ? std::nullopt : parseTimeParam(until);
+    if ((!since.empty() && !sinceOpt) || (!until.empty() && !untilOpt)) {
+        cb(jsonError("since/until must be ISO-8601 or epoch milliseconds", drogon::k400BadRequest));
+        return false;
+    }
+
+    untilMs = untilOpt.value_or(nowMs);
+    sinceMs = sinceOpt.value_or(untilMs - kDefaultWindowMs);
+    if (sinceMs >= untilMs) {
+        cb(jsonError("since must be earlier than until", drogon::k400BadRequest));
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// ================== LIST ==================
+
+void VoyagesController::list(const HttpRequestPtr& req,
+                             std::function<void(const HttpResponsePtr&)>&& cb) {
+    std::int64_t shipId = 0;
+    if (!queryId(req, "ship_id", shipId)) {
+        cb(jsonError("ship_id must be a positive integer", drogon::k400BadRequest));
+        return;
+    }
+
+    // журнал лише росте — тут завжди сторінки (limit за замовчуванням)
+    PageRequest page;
+    std::string err;
+    if (!pagination::parse(req, page, err)) {
+        cb(jsonError(err, drogon::k400BadRequest));
+        return;
+    }
+
+    try {
+        const auto result = VoyagesRepo{}.page(page, shipId);
+        cb(pagination::response(req, result, page.limit, voyageToJson));
+    } catch (const std::exception& e) {
+        LOG_ERROR << "VoyagesController::list failed: " << e.what();
+        cb(jsonError("failed to list voyages", drogon::k500InternalServerError, e.what()));
+    }
+}
+
+// ================== STATS ==================
+
+void VoyagesController::routeStats(const HttpRequestPtr& req,
+                                   std::function<void(const HttpResponsePtr&)>&& cb) {
+    std::int64_t origin = 0;
+    std::int64_t destination = 0;
+    if (!queryId(req, "origin", origin) || !queryId(req, "destination", destination)) {
+        cb(jsonError("origin and destination must be positive port ids", drogon::k400BadRequest));
+        return;
+    }
+
+    std::int64_t sinceMs = 0;
+    std::int64_t untilMs = 0;
+    if (!parseWindow(req, cb, util::nowMs(), sinceMs, untilMs)) return;
+
+    try {
+        const auto stats = VoyagesRepo{}.routeStats(origin, destination, sinceMs, untilMs);
+
+        Json::Value routes(Json::arrayValue);
+        for (const auto& r : stats) {
+            Json::Value j;
+            j["origin_port_id"]      = Json::Int64(r.originPortId);
+            j["destination_port_id"] = Json::Int64(r.destinationPortId);
+            j["voyages"]             = Json::Int64(r.voyages);
+            j["avg_transit_hours"]   = r.avgTransitMs / kMsPerHour;
+            j["avg_delay_minutes"]   = r.avgDelayMs / 60000.0;
+            j["on_time"]             = Json::Int64(r.onTime);
+            routes.append(std::move(j));
+        }
+
+        Json::Value out;
+        out["since"]  = util::formatIsoMs(sinceMs);
+        out["until"]  = util::formatIsoMs(untilMs);
+        out["routes"] = std::move(routes);
+        cb(HttpResponse::newHttpJsonResponse(out));
+    } catch (const std::exception& e) {
+        LOG_ERROR << "VoyagesController::routeStats failed: " << e.what();
+        cb(jsonError("failed to compute route stats", drogon::k500InternalServerError, e.what()));
+    }
+}
+
+void VoyagesController::shipStats(const HttpRequestPtr& req,
+                                  std::function<void(const HttpResponsePtr&)>&& cb) {
+    std::int64_t shipId = 0;
+    if (!queryId(req, "ship_id", shipId)) {
+        cb(jsonError("ship_id must be a positive integer", drogon::k400BadRequest));
+        return;
+    }
+
+    const std::int64_t nowMs = util::nowMs();
+    std::int64_t sinceMs = 0;
+    std::int64_t untilMs = 0;
+    if (!parseWindow(req, cb, nowMs, sinceMs, untilMs)) return;
+
+    try {
+        const auto stats = VoyagesRepo{}.shipUtilization(shipId, sinceMs, untilMs, nowMs);
+        const double windowMs = static_cast<double>(untilMs - sinceMs);
+
+        Json::Value ships(Json::arrayValue);
+        for (const auto& u : stats) {
+            Json::Value j;
+            j["ship_id"]      = Json::Int64(u.shipId);
+            j["voyages"]      = Json::Int64(u.voyages);
+            j["at_sea_hours"] = static_cast<double>(u.atSeaMs) / kMsPerHour;
+            // частка вікна в морі
+            j["utilization"]  = static_cast<double>(u.atSeaMs) / windowMs;
+            ships.append(std::move(j));
+        }
+
+        Json::Value out;
+        out["since"] = util::formatIsoMs(sinceMs);
+        out["until"] = util::formatIsoMs(untilMs);
+        out["ships"] = std::move(ships);
+        cb(HttpResponse::newHttpJsonResponse(out));
+    } catch (const std::exception& e) {
+        LOG_ERROR << "VoyagesController::shipStats failed: " << e.what();
+        cb(jsonError("failed to compute ship stats", drogon::k500InternalServerError, e.what()));
+    }
+}
@@ -0,0 +1,127 @@
+﻿// src/db/AuditLog.cpp
+#include "db/AuditLog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <thread>
+#include <utility>
+
+namespace {
+
+// Повтори пачки при збої (SQLITE_BUSY після busy_timeout, диск):
+// пауза подвоюється від kRetryFirstMs, усього kRetryAttempts спроб
+constexpr int kRetryAttempts = 5;
+constexpr int kRetryFirstMs = 100;
+
+} // namespace
+
+AuditLogWriter::AuditLogWriter(const AuditLogOptions& opts, Sink sink)
+    : opts_(opts),
+      sink_(std::move(sink)),
+      ring_(opts.capacity > 0 ? opts.capacity : 1) {
+    if (opts_.batchRows == 0) opts_.batchRows = 1;
+    thread_ = std::thread([this] { run(); });
+}
+
+AuditLogWriter::~AuditLogWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) thread_.join();
+}
+
+bool AuditLogWriter::enqueue(LogRecord&& r) {
+    bool wakeWriter = false;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (stop_ || size_ == ring_.size()) {
+            return false;
+        }
+        ring_[(head_ + size_) % ring_.size()] = std::move(r);
+        ++size_;
+        ++enqueued_;
+        wakeWriter = (size_ == opts_.batchRows);
+    }
+    if (wakeWriter) wake_.notify_one();
+    return true;
+}
+
+void AuditLogWriter::flush() {
+    std::unique_lock<std::mutex> lock(mu_);
+    const std::uint64_t target = enqueued_;
+    if (written_ >= target) return;
+
+    if (flushTarget_ < target) flushTarget_ = target;
+    wake_.notify_one();
+    done_.wait(lock, [&] { return written_ >= target; });
+}
+
+void AuditLogWriter::run() {
+    const auto interval = std::chrono::milliseconds(opts_.flushIntervalMs);
+    std::vector<LogRecord> batch;
+    batch.reserve(opts_.batchRows);
+
+    std::unique_lock<std::mutex> lock(mu_);
+    for (;;) {
+        wake_.wait_for(lock, interval, [&] {
+            return stop_ || size_ >= opts_.batchRows || flushTarget_ > written_;
+        });
+
+        if (size_ == 0) {
+            if (stop_) break;
+            continue;
+        }
+
+        // Забираємо все, що накопичилось (але не більше кількох пачок за раз)
+        const std::size_t n = std::min(size_, opts_.batchRows * 4);
+        batch.clear();
+        for (std::size_t i = 0; i < n; ++i) {
+            batch.push_back(std::move(ring_[head_]));
+            head_ = (head_ + 1) % ring_.size();
+        }
+        size_ -= n;
+
+        lock.unlock();
+        writeBatch(batch);
+        lock.lock();
+
+        written_ += n;
+        done_.notify_all();
+    }
+}
+
+// Пачка йде однією транзакцією з повторами; якщо не вдається й так —
+// рядки пишуться поодинці, щоб один поганий рядок не забрав решту
+void AuditLogWriter::writeBatch(std::vector<LogRecord>& batch) {
+    std::string error;
+    int delayMs = kRetryFirstMs;
+    for (int attempt = 1; attempt <= kRetryAttempts; ++attempt) {
+        try {
+            sink_(batch);
+            return;
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        if (attempt < kRetryAttempts) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+            delayMs *= 2;
+        }
+    }
+
+    std::cerr << "[AuditLog] batch of " << batch.size() << " rows failed (" << error
+              << "), writing rows one by one\n";
+    std::vector<LogRecord> one(1);
+    for (auto& r : batch) {
+        one[0] = std::move(r);
+        try {
+            sink_(one);
+        } catch (const std::exception& e) {
+            std::cerr << "[AuditLog] dropped row " << one[0].event_type << " "
+                      << one[0].entity << "#" << one[0].entity_id << ": " << e.what() << "\n";
+        }
+    }
+}
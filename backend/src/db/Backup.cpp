@@ -0,0 +1,219 @@
+﻿// src/db/Backup.cpp
+#include "db/Backup.h"
+#include "db/Db.h"
+#include "util/Time.h"
+
+#include <sqlite3.h>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kMaxRestarts = 3;
+
+double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+std::string journalMode(sqlite3* db) {
+    std::string mode;
+    sqlite3_stmt* st = nullptr;
+    if (sqlite3_prepare_v2(db, "PRAGMA journal_mode;", -1, &st, nullptr) == SQLITE_OK &&
+        sqlite3_step(st) == SQLITE_ROW) {
+        const unsigned char* txt = sqlite3_column_text(st, 0);
+        if (txt) mode = reinterpret_cast<const char*>(txt);
+    }
+    sqlite3_finalize(st);
+    return mode;
+}
+
+// Відкриває read-транзакцію і фіксує знімок першим читанням
+bool beginSnapshot(sqlite3* db) {
+    if (sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr) != SQLITE_OK) return false;
+    if (sqlite3_exec(db, "SELECT count(*) FROM sqlite_master;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+const char* toString(BackupState s) noexcept {
+    switch (s) {
+        case BackupState::Idle:      return "idle";
+        case BackupState::Running:   return "running";
+        case BackupState::Done:      return "done";
+        case BackupState::Failed:    return "failed";
+        case BackupState::Cancelled: return "cancelled";
+    }
+    return "unknown";
+}
+
+BackupStatus runBackup(sqlite3* src,
+                       const std::string& dest,
+                       const BackupOptions& opts,
+                       const std::function<bool(const BackupStatus&)>& progress) {
+    namespace fs = std::filesystem;
+    const auto t0 = Clock::now();
+
+    BackupStatus s;
+    s.state = BackupState::Running;
+    s.dest  = dest;
+
+    const fs::path destPath(dest);
+    if (destPath.has_parent_path()) {
+        fs::create_directories(destPath.parent_path());
+    }
+    const std::string tmp = dest + ".part";
+    fs::remove(tmp);
+
+    sqlite3* dst = nullptr;
+    if (sqlite3_open_v2(tmp.c_str(), &dst, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK) {
+        std::string msg = dst ? sqlite3_errmsg(dst) : "sqlite open failed";
+        sqlite3_close(dst);
+        throw std::runtime_error("backup: cannot open " + tmp + ": " + msg);
+    }
+
+    // Без знімка (rollback-журнал) read-транзакція блокувала б писачів,
+    // тож там покладаємося на перезапуск копії самою SQLite.
+    const bool snapshot = journalMode(src) == "wal" && beginSnapshot(src);
+
+    sqlite3_backup* b = sqlite3_backup_init(dst, "main", src, "main");
+    if (!b) {
+        std::string msg = sqlite3_errmsg(dst);
+        if (snapshot) sqlite3_exec(src, "COMMIT;", nullptr, nullptr, nullptr);
+        sqlite3_close(dst);
+        fs::remove(tmp);
+        throw std::runtime_error("backup: init failed: " + msg);
+    }
+
+    int pages = opts.pagesPerStep > 0 ? opts.pagesPerStep : -1;
+    int restarts = 0;
+    bool cancelled = false;
+    int rc = SQLITE_OK;
+    do {
+        rc = sqlite3_backup_step(b, pages);
+        ++s.steps;
+
+        // Без знімка кожен сторонній запис перезапускає копію. При постійних
+        // записах вона б ніколи не завершилась — тож після kMaxRestarts
+        // дописуємо решту одним кроком (коротко блокуючи писачів).
+        const int remaining = sqlite3_backup_remaining(b);
+        if (s.steps > 1 && remaining > s.remainingPages && ++restarts >= kMaxRestarts) {
+            pages = -1;
+        }
+        s.totalPages     = sqlite3_backup_pagecount(b);
+        s.remainingPages = remaining;
+        s.elapsedMs      = msSince(t0);
+
+        if (progress && !progress(s)) {
+            cancelled = true;
+            break;
+        }
+        if (rc != SQLITE_DONE && opts.pauseMs > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(opts.pauseMs));
+        }
+    } while (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED);
+
+    sqlite3_backup_finish(b);
+    if (snapshot) sqlite3_exec(src, "COMMIT;", nullptr, nullptr, nullptr);
+    sqlite3_close(dst);
+
+    if (cancelled) {
+        fs::remove(tmp);
+        s.state = BackupState::Cancelled;
+        return s;
+    }
+    if (rc != SQLITE_DONE) {
+        fs::remove(tmp);
+        throw std::runtime_error(std::string("backup: step failed: ") + sqlite3_errstr(rc));
+    }
+
+    fs::rename(tmp, destPath);
+    s.state     = BackupState::Done;
+    s.elapsedMs = msSince(t0);
+    return s;
+}
+
+BackupService& BackupService::instance() {
+    static BackupService inst;
+    return inst;
+}
+
+BackupService::~BackupService() {
+    stop_ = true;
+    if (worker_.joinable()) worker_.join();
+}
+
+bool BackupService::start(const std::string& dest, const BackupOptions& opts) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (status_.state == BackupState::Running) return false;
+    if (worker_.joinable()) worker_.join();   // попередня копія вже завершилась
+
+    status_ = BackupStatus{};
+    status_.state = BackupState::Running;
+    status_.dest  = dest;
+    stop_ = false;
+
+    worker_ = std::thread([this, dest, opts] {
+        BackupStatus result;
+        try {
+            // Власне з'єднання пулу: знімок не заважає IO-потокам
+            sqlite3* src = Db::instance().handle();
+            result = runBackup(src, dest, opts, [this](const BackupStatus& s) {
+                std::lock_guard<std::mutex> lock(mu_);
+                status_ = s;
+                return !stop_.load();
+            });
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(mu_);
+            result = status_;
+            result.state = BackupState::Failed;
+            result.error = e.what();
+        }
+
+        try {
+            const std::string msg = std::string("Backup ") + toString(result.state) + ": " + dest +
+                " (" + std::to_string(result.totalPages) + " pages, " +
+                std::to_string(static_cast<long long>(result.elapsedMs)) + " ms)" +
+                (result.error.empty() ? "" : " error=" + result.error);
+            Db::instance().insertLog(result.state == BackupState::Done ? "INFO" : "ERROR",
+                                     "backup.finished", "backup", 0, "system", msg);
+        } catch (...) {}
+
+        std::lock_guard<std::mutex> lock(mu_);
+        status_ = result;
+    });
+    return true;
+}
+
+BackupStatus BackupService::status() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return status_;
+}
+
+std::string BackupService::backupDir() {
+    namespace fs = std::filesystem;
+    const Db& db = Db::instance();
+    if (db.options().inMemory()) {
+        return (fs::current_path() / "backups").string();
+    }
+    fs::path p = fs::absolute(db.path());
+    return (p.parent_path() / "backups").string();
+}
+
+std::string BackupService::defaultDestination() {
+    // UTC без gmtime: той самий календар, що й у мітках часу БД
+    const util::CivilTime t = util::toCivil(util::nowMs());
+    char name[48];
+    std::snprintf(name, sizeof(name), "app-%04d%02d%02d-%02d%02d%02d.db",
+                  t.year, t.month, t.day, t.hour, t.minute, t.second);
+    return (std::filesystem::path(backupDir()) / name).string();
+}
@@ -0,0 +1,156 @@
+﻿// src/db/ChangeFeed.cpp
+#include "db/ChangeFeed.h"
+
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+void storeMax(std::atomic<std::uint64_t>& a, std::uint64_t v) noexcept {
+    std::uint64_t cur = a.load(std::memory_order_relaxed);
+    while (cur < v && !a.compare_exchange_weak(cur, v, std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+ChangeTable changeTableFromName(std::string_view name) noexcept {
+    if (name == "ships")            return ChangeTable::Ships;
+    if (name == "ports")            return ChangeTable::Ports;
+    if (name == "crew_assignments") return ChangeTable::CrewAssignments;
+    if (name == "people")           return ChangeTable::People;
+    if (name == "companies")        return ChangeTable::Companies;
+    if (name == "company_ports")    return ChangeTable::CompanyPorts;
+    if (name == "ship_types")       return ChangeTable::ShipTypes;
+    return ChangeTable::Count_;
+}
+
+const char* toString(ChangeTable t) noexcept {
+    switch (t) {
+        case ChangeTable::Ports:           return "ports";
+        case ChangeTable::ShipTypes:       return "ship_types";
+        case ChangeTable::People:          return "people";
+        case ChangeTable::Companies:       return "companies";
+        case ChangeTable::Ships:           return "ships";
+        case ChangeTable::CompanyPorts:    return "company_ports";
+        case ChangeTable::CrewAssignments: return "crew_assignments";
+        case ChangeTable::Count_:          break;
+    }
+    return "unknown";
+}
+
+const char* toString(ChangeOp op) noexcept {
+    switch (op) {
+        case ChangeOp::Insert: return "insert";
+        case ChangeOp::Update: return "update";
+        case ChangeOp::Delete: return "delete";
+    }
+    return "unknown";
+}
+
+ChangeFeed::ChangeFeed(std::size_t capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        throw std::invalid_argument("ChangeFeed capacity must be a power of two");
+    }
+    slots_ = std::make_unique<Slot[]>(capacity);
+    mask_ = capacity - 1;
+}
+
+void ChangeFeed::publish(std::uint64_t first, const ChangeEvent* events, std::size_t n) noexcept {
+    if (n == 0) return;
+
+    std::uint64_t maxSeq = 0;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const ChangeEvent& e = events[i];
+        const std::uint64_t pos = first + i;
+        Slot& s = slots_[pos & mask_];
+
+        // Захопити слот: попереднє коло -> kWriting. Якщо слот уже пише
+        // інший публікатор — чекаємо; якщо він уже з новішого кола —
+        // наша подія для підписників однаково втрачена, не затираємо.
+        bool claimed = false;
+        std::uint64_t cur = s.seq.load(std::memory_order_relaxed);
+        for (;;) {
+            if (cur == kWriting) {
+                std::this_thread::yield();
+                cur = s.seq.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (cur > pos) break;
+            if (s.seq.compare_exchange_weak(cur, kWriting, std::memory_order_relaxed,
+                                            std::memory_order_relaxed)) {
+                claimed = true;
+                break;
+            }
+        }
+
+        if (claimed) {
+            // seqlock: kWriting -> дані -> pos+1
+            std::atomic_thread_fence(std::memory_order_release);
+            s.kind.store(static_cast<std::uint64_t>(e.table) |
+                         (static_cast<std::uint64_t>(e.op) << 8), std::memory_order_relaxed);
+            s.rowid.store(e.rowid, std::memory_order_relaxed);
+            s.commitSeq.store(e.commitSeq, std::memory_order_relaxed);
+            s.seq.store(pos + 1, std::memory_order_release);
+        }
+
+        if (e.table != ChangeTable::Count_) {
+            storeMax(tableSeq_[static_cast<std::size_t>(e.table)], e.commitSeq);
+        }
+        if (e.commitSeq > maxSeq) maxSeq = e.commitSeq;
+    }
+
+    storeMax(lastSeq_, maxSeq);
+}
+
+ChangeFeed::Subscriber::Subscriber(const ChangeFeed& feed) noexcept
+    : feed_(&feed), cursor_(feed.head_.load(std::memory_order_acquire)) {}
+
+std::size_t ChangeFeed::Subscriber::poll(std::vector<ChangeEvent>& out, std::size_t max) {
+    const std::size_t capacity = feed_->mask_ + 1;
+    std::size_t got = 0;
+
+    while (got < max) {
+        const std::uint64_t head = feed_->head_.load(std::memory_order_acquire);
+        if (cursor_ >= head) break;
+
+        // кільце вже перезаписало непрочитане
+        if (head - cursor_ > capacity) {
+            lost_ = true;
+            cursor_ = head - capacity;
+            continue;
+        }
+
+        const Slot& s = feed_->slots_[cursor_ & feed_->mask_];
+        const std::uint64_t want = cursor_ + 1;
+
+        const std::uint64_t s1 = s.seq.load(std::memory_order_acquire);
+        if (s1 != want) {
+            if (s1 > want && s1 != kWriting) {  // слот уже належить наступному колу
+                lost_ = true;
+                cursor_ = head > capacity ? head - capacity : 0;
+                continue;
+            }
+            break;                     // слот зарезервовано, але ще не записано
+        }
+
+        ChangeEvent e;
+        const std::uint64_t kind = s.kind.load(std::memory_order_relaxed);
+        e.table     = static_cast<ChangeTable>(kind & 0xff);
+        e.op        = static_cast<ChangeOp>((kind >> 8) & 0xff);
+        e.rowid     = s.rowid.load(std::memory_order_relaxed);
+        e.commitSeq = s.commitSeq.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.seq.load(std::memory_order_relaxed) != want) {
+            continue;                  // перезаписали під час читання — перевіримо ще раз
+        }
+
+        out.push_back(e);
+        ++cursor_;
+        ++got;
+    }
+    return got;
+}
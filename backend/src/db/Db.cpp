@@ -1,11 +1,19 @@
 ﻿#include "db/Db.h"
+#include "db/Stmt.h"
+#include "util/Time.h"
 
 #include <sqlite3.h>
+#include <atomic>
 #include <filesystem>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <iostream>
 #include <ctime>
+#include <cstdlib>
+#include <chrono>
+#include <iterator>
 
 namespace {
 
@@ -117,39 +125,17 @@ void seedShipsIfEmpty(sqlite3* db) {
     }
 }
 
-} // namespace
-
-Db& Db::instance() {
-    static Db inst;
-    return inst;
-}
-
-Db::Db() {
-    namespace fs = std::filesystem;
-
-    fs::path dbPath = fs::current_path().parent_path().parent_path() / "data" / "app.db";
-    fs::create_directories(dbPath.parent_path());
-
-    if (sqlite3_open(dbPath.string().c_str(), &db_) != SQLITE_OK) {
-        std::string msg = db_ ? sqlite3_errmsg(db_) : "sqlite open failed";
-        throw std::runtime_error(msg);
-    }
+// ---------- versioned migrations ----------
+// Кожна міграція застосовується рівно один раз, у порядку номерів,
+// і записується в schema_version. Нові зміни схеми — лише новою міграцією
+// в кінці kMigrations, ніколи не редагуючи вже випущені.
 
-    execOrThrow(db_, "PRAGMA foreign_keys = ON;");
-
-    runMigrations();
-}
-
-Db::~Db() {
-    if (db_) {
-        sqlite3_close(db_);
-        db_ = nullptr;
-    }
-}
-
-void Db::runMigrations() {
+// v1: схема, що існувала до введення версій.
+// IF NOT EXISTS / ensureColumn лишаються, бо старі app.db без schema_version
+// можуть мати будь-яку проміжну версію цієї схеми.
+void migrateBaseline(sqlite3* db) {
     // --- PORTS ---
-    execOrThrow(db_,
+    execOrThrow(db,
         "CREATE TABLE IF NOT EXISTS ports ("
         "  id     INTEGER PRIMARY KEY AUTOINCREMENT,"
         "  name   TEXT    NOT NULL UNIQUE,"
@@ -160,7 +146,7 @@ void Db::runMigrations() {
     );
 
     // --- SHIP TYPES ---
-    execOrThrow(db_,
+    execOrThrow(db,
         "CREATE TABLE IF NOT EXISTS ship_types ("
         "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
         "  code TEXT UNIQUE NOT NULL,"
@@ -170,7 +156,7 @@ void Db::runMigrations() {
     );
 
     // --- PEOPLE ---
-    execOrThrow(db_,
+    execOrThrow(db,
         "CREATE TABLE IF NOT EXISTS people ("
         "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
         "  full_name TEXT NOT NULL,"
@@ -179,11 +165,11 @@ void Db::runMigrations() {
         ");"
     );
 
-    ensureColumn(db_, "people", "rank", "TEXT");
-    ensureColumn(db_, "people", "active", "INTEGER DEFAULT 1");
+    ensureColumn(db, "people", "rank", "TEXT");
+    ensureColumn(db, "people", "active", "INTEGER DEFAULT 1");
 
     // --- COMPANIES ---
-    execOrThrow(db_,
+    execOrThrow(db,
         "CREATE TABLE IF NOT EXISTS companies ("
         "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
         "  name    TEXT UNIQUE NOT NULL,"
@@ -194,12 +180,12 @@ void Db::runMigrations() {
     );
 
     // апгрейди companies для старих БД
-    ensureColumn(db_, "companies", "country", "TEXT");
-    ensureColumn(db_, "companies", "port_id", "INTEGER");
+    ensureColumn(db, "companies", "country", "TEXT");
+    ensureColumn(db, "companies", "port_id", "INTEGER");
 
     // --- SHIPS ---
     // ВАЖЛИВО: одразу включаємо company_id в базову схему
-    execOrThrow(db_,
+    execOrThrow(db,
         "CREATE TABLE IF NOT EXISTS ships ("
         "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
         "  name TEXT NOT NULL UNIQUE,"
@@ -214,24 +200,24 @@ void Db::runMigrations() {
     );
 
     // --- ships schema upgrades for older app.db versions ---
-    ensureColumn(db_, "ships", "type", "TEXT NOT NULL DEFAULT 'cargo'");
-    ensureColumn(db_, "ships", "country", "TEXT NOT NULL DEFAULT 'Unknown'");
-    ensureColumn(db_, "ships", "port_id", "INTEGER");
-    ensureColumn(db_, "ships", "status", "TEXT NOT NULL DEFAULT 'docked'");
-    ensureColumn(db_, "ships", "company_id", "INTEGER");
-    ensureColumn(db_, "ships", "speed_knots", "REAL NOT NULL DEFAULT 20.0");
+    ensureColumn(db, "ships", "type", "TEXT NOT NULL DEFAULT 'cargo'");
+    ensureColumn(db, "ships", "country", "TEXT NOT NULL DEFAULT 'Unknown'");
+    ensureColumn(db, "ships", "port_id", "INTEGER");
+    ensureColumn(db, "ships", "status", "TEXT NOT NULL DEFAULT 'docked'");
+    ensureColumn(db, "ships", "company_id", "INTEGER");
+    ensureColumn(db, "ships", "speed_knots", "REAL NOT NULL DEFAULT 20.0");
     
     // Voyage tracking columns
-    ensureColumn(db_, "ships", "departed_at", "TEXT");
-    ensureColumn(db_, "ships", "destination_port_id", "INTEGER");
-    ensureColumn(db_, "ships", "eta", "TEXT");
-    ensureColumn(db_, "ships", "voyage_distance_km", "REAL");
+    ensureColumn(db, "ships", "departed_at", "TEXT");
+    ensureColumn(db, "ships", "destination_port_id", "INTEGER");
+    ensureColumn(db, "ships", "eta", "TEXT");
+    ensureColumn(db, "ships", "voyage_distance_km", "REAL");
 
-    execOrThrow(db_, "CREATE INDEX IF NOT EXISTS idx_ships_company ON ships(company_id);");
-    execOrThrow(db_, "CREATE INDEX IF NOT EXISTS idx_ships_port ON ships(port_id);");
+    execOrThrow(db, "CREATE INDEX IF NOT EXISTS idx_ships_company ON ships(company_id);");
+    execOrThrow(db, "CREATE INDEX IF NOT EXISTS idx_ships_port ON ships(port_id);");
 
     // --- COMPANY_PORTS ---
-    execOrThrow(db_,
+    execOrThrow(db,
         "CREATE TABLE IF NOT EXISTS company_ports ("
         "  company_id INTEGER NOT NULL,"
         "  port_id    INTEGER NOT NULL,"
@@ -242,23 +228,23 @@ void Db::runMigrations() {
         ");"
     );
 
-    execOrThrow(db_,
+    execOrThrow(db,
         "CREATE UNIQUE INDEX IF NOT EXISTS ux_company_main_port "
         "ON company_ports(company_id) WHERE is_main=1;"
     );
 
-    execOrThrow(db_,
+    execOrThrow(db,
         "CREATE INDEX IF NOT EXISTS idx_company_ports_port "
         "ON company_ports(port_id);"
     );
 
-    execOrThrow(db_,
+    execOrThrow(db,
         "CREATE INDEX IF NOT EXISTS idx_company_ports_company "
         "ON company_ports(company_id);"
     );
 
     // --- CREW ASSIGNMENTS ---
-    execOrThrow(db_,
+    execOrThrow(db,
         "CREATE TABLE IF NOT EXISTS crew_assignments ("
         "  id        INTEGER PRIMARY KEY AUTOINCREMENT,"
         "  person_id INTEGER NOT NULL,"
@@ -271,31 +257,25 @@ void Db::runMigrations() {
     );
 
     // Якщо раніше був не-unique індекс
-    execOrThrow(db_, "DROP INDEX IF EXISTS idx_crew_ship_active;");
+    execOrThrow(db, "DROP INDEX IF EXISTS idx_crew_ship_active;");
 
     // 1 активне призначення на корабель
-    execOrThrow(db_,
+    execOrThrow(db,
         "CREATE UNIQUE INDEX IF NOT EXISTS ux_crew_ship_active "
         "ON crew_assignments(ship_id) WHERE end_utc IS NULL;"
     );
 
     // 1 активне призначення на людину
-    execOrThrow(db_,
+    execOrThrow(db,
         "CREATE UNIQUE INDEX IF NOT EXISTS ux_crew_person_active "
         "ON crew_assignments(person_id) WHERE end_utc IS NULL;"
     );
 
-    execOrThrow(db_, "CREATE INDEX IF NOT EXISTS crew_ship_idx ON crew_assignments(ship_id);");
-    execOrThrow(db_, "CREATE INDEX IF NOT EXISTS crew_person_idx ON crew_assignments(person_id);");
-
-    // --- AUTO-SEEDING DISABLED ---
-    if (kEnableSeeding) {
-        seedPortsIfEmpty(db_);
-        seedShipsIfEmpty(db_);
-    }
+    execOrThrow(db, "CREATE INDEX IF NOT EXISTS crew_ship_idx ON crew_assignments(ship_id);");
+    execOrThrow(db, "CREATE INDEX IF NOT EXISTS crew_person_idx ON crew_assignments(person_id);");
 
     // --- LOGS ---
-    execOrThrow(db_,
+    execOrThrow(db,
         "CREATE TABLE IF NOT EXISTS logs ("
         "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
         "  ts TEXT NOT NULL,"
@@ -308,8 +288,826 @@ void Db::runMigrations() {
         ");"
     );
 
-    execOrThrow(db_, "CREATE INDEX IF NOT EXISTS idx_logs_event_type ON logs(event_type);");
-    execOrThrow(db_, "CREATE INDEX IF NOT EXISTS idx_logs_ts ON logs(ts);");
+    execOrThrow(db, "CREATE INDEX IF NOT EXISTS idx_logs_event_type ON logs(event_type);");
+    execOrThrow(db, "CREATE INDEX IF NOT EXISTS idx_logs_ts ON logs(ts);");
+}
+
+// ---------------- партиції журналу ----------------
+//
+// Журнал зберігається помісячно: таблиці logs_YYYYMM з власними індексами,
+// реєстр у log_partitions і view `logs` = UNION ALL усіх партицій.
+// Читачі (LogsController, експорт) працюють з view як з таблицею;
+// запис іде прямо в партицію місяця події; retention — DROP TABLE цілої партиції.
+
+// Ключ місяця: 202610 = жовтень 2026
+int monthKeyNow() {
+    return util::monthKey(util::nowMs());
+}
+
+// "YYYY-MM-..." -> YYYYMM; 0 для нерозпізнаного формату (рядки до міграції v3)
+int monthKeyFromIso(std::string_view ts) {
+    if (ts.size() < 7 || ts[4] != '-') return 0;
+    int key = 0;
+    for (std::size_t i : {0u, 1u, 2u, 3u, 5u, 6u}) {
+        if (ts[i] < '0' || ts[i] > '9') return 0;
+        key = key * 10 + (ts[i] - '0');
+    }
+    const int month = key % 100;
+    return (month >= 1 && month <= 12) ? key : 0;
+}
+
+int addMonths(int key, int delta) {
+    const int idx = (key / 100) * 12 + (key % 100 - 1) + delta;
+    return (idx / 12) * 100 + (idx % 12 + 1);
+}
+
+std::string logPartitionName(int key) {
+    return "logs_" + std::to_string(key);
+}
+
+// Id журналу глобальні для всіх партицій: наступний = найбільший seq серед
+// партицій + 1. Обчислюється в тій самій INSERT під write-локом SQLite,
+// тож не дублюється навіть при кількох процесах-писачах.
+// AUTOINCREMENT тримає seq партиції на рівні останнього виданого id.
+constexpr const char* kNextLogIdSql =
+    "(SELECT COALESCE(MAX(seq), 0) + 1 FROM sqlite_sequence WHERE name LIKE 'logs\\_%' ESCAPE '\\')";
+
+// Створює партицію, якщо її нема. true — якщо створено.
+// Нова партиція отримує seq = найбільший виданий id, щоб він пережив
+// видалення старих партицій.
+bool createLogPartition(sqlite3* db, int key) {
+    const std::string name = logPartitionName(key);
+    if (scalarInt(db, "SELECT COUNT(*) FROM log_partitions WHERE month = " + std::to_string(key) + ";") != 0) {
+        return false;
+    }
+
+    execOrThrow(db,
+        "CREATE TABLE IF NOT EXISTS " + name + " ("
+        "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+        "  ts INTEGER NOT NULL,"
+        "  level TEXT NOT NULL,"
+        "  event_type TEXT NOT NULL,"
+        "  entity TEXT,"
+        "  entity_id INTEGER,"
+        "  user TEXT,"
+        "  message TEXT"
+        ");"
+    );
+    execOrThrow(db, "CREATE INDEX IF NOT EXISTS idx_" + name + "_ts ON " + name + "(ts);");
+    execOrThrow(db, "CREATE INDEX IF NOT EXISTS idx_" + name + "_event_type ON " + name + "(event_type);");
+
+    execOrThrow(db,
+        "INSERT INTO sqlite_sequence(name, seq) "
+        "SELECT '" + name + "', COALESCE(MAX(seq), 0) FROM sqlite_sequence "
+        "WHERE name = 'logs' OR name LIKE 'logs\\_%' ESCAPE '\\' "
+        "HAVING NOT EXISTS (SELECT 1 FROM sqlite_sequence WHERE name = '" + name + "');"
+    );
+    execOrThrow(db,
+        "INSERT INTO log_partitions(name, month) VALUES ('" + name + "', " + std::to_string(key) + ");"
+    );
+    return true;
+}
+
+std::vector<std::string> logPartitionNames(sqlite3* db, const char* where = "1=1") {
+    std::vector<std::string> names;
+    sqlite3_stmt* st = nullptr;
+    const std::string sql = std::string("SELECT name FROM log_partitions WHERE ") + where + " ORDER BY month;";
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &st, nullptr) != SQLITE_OK) {
+        throw std::runtime_error(sqlite3_errmsg(db));
+    }
+    while (sqlite3_step(st) == SQLITE_ROW) {
+        names.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(st, 0)));
+    }
+    sqlite3_finalize(st);
+    return names;
+}
+
+void rebuildLogsView(sqlite3* db) {
+    const auto names = logPartitionNames(db);
+    std::string sql = "CREATE VIEW logs AS ";
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        if (i) sql += " UNION ALL ";
+        sql += "SELECT id, ts, level, event_type, entity, entity_id, user, message FROM " + names[i];
+    }
+    execOrThrow(db, "DROP VIEW IF EXISTS logs;");
+    if (!names.empty()) execOrThrow(db, sql + ";");
+}
+
+// Видаляє партиції, старші за retentionMonths (рахуючи поточний місяць).
+// Повертає кількість видалених. Звільнені сторінки йдуть у freelist
+// і повторно використовуються новими записами.
+int dropLogPartitionsBefore(sqlite3* db, int cutoffKey) {
+    const auto names = logPartitionNames(db, ("month < " + std::to_string(cutoffKey)).c_str());
+    for (const auto& name : names) {
+        execOrThrow(db, "DROP TABLE IF EXISTS " + name + ";");
+        execOrThrow(db, "DELETE FROM log_partitions WHERE name = '" + name + "';");
+    }
+    if (!names.empty()) {
+        rebuildLogsView(db);
+    }
+    return static_cast<int>(names.size());
+}
+
+// v2: таблиця logs -> помісячні партиції + view logs
+void migrateLogPartitions(sqlite3* db) {
+    execOrThrow(db,
+        "CREATE TABLE IF NOT EXISTS log_partitions ("
+        "  name TEXT PRIMARY KEY,"
+        "  month INTEGER NOT NULL UNIQUE,"
+        "  created_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP"
+        ");"
+    );
+
+    const int current = monthKeyNow();
+    const bool legacy = scalarInt(db,
+        "SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name = 'logs';") != 0;
+
+    if (legacy) {
+        // Розкладаємо наявні рядки по місяцях, зберігаючи id
+        std::vector<std::string> prefixes;
+        sqlite3_stmt* st = nullptr;
+        if (sqlite3_prepare_v2(db, "SELECT DISTINCT substr(ts, 1, 7) FROM logs;", -1, &st, nullptr) != SQLITE_OK) {
+            throw std::runtime_error(sqlite3_errmsg(db));
+        }
+        while (sqlite3_step(st) == SQLITE_ROW) {
+            const unsigned char* txt = sqlite3_column_text(st, 0);
+            prefixes.emplace_back(txt ? reinterpret_cast<const char*>(txt) : "");
+        }
+        sqlite3_finalize(st);
+
+        for (const auto& prefix : prefixes) {
+            int key = monthKeyFromIso(prefix);
+            if (key == 0) key = current;  // некоректний ts -> поточний місяць
+            createLogPartition(db, key);
+
+            sqlite3_stmt* ins = nullptr;
+            const std::string sql =
+                "INSERT INTO " + logPartitionName(key) +
+                "(id, ts, level, event_type, entity, entity_id, user, message) "
+                "SELECT id, ts, level, event_type, entity, entity_id, user, message "
+                "FROM logs WHERE substr(ts, 1, 7) IS ?;";
+            if (sqlite3_prepare_v2(db, sql.c_str(), -1, &ins, nullptr) != SQLITE_OK) {
+                throw std::runtime_error(sqlite3_errmsg(db));
+            }
+            sqlite3_bind_text(ins, 1, prefix.c_str(), -1, SQLITE_TRANSIENT);
+            const int rc = sqlite3_step(ins);
+            sqlite3_finalize(ins);
+            if (rc != SQLITE_DONE) {
+                throw std::runtime_error(std::string("log partition copy failed: ") + sqlite3_errmsg(db));
+            }
+        }
+    }
+
+    createLogPartition(db, current);
+    createLogPartition(db, addMonths(current, 1));
+
+    if (legacy) {
+        // Переносимо останній виданий id старої таблиці (DROP прибере її seq)
+        execOrThrow(db,
+            "UPDATE sqlite_sequence SET seq = MAX(seq, COALESCE((SELECT seq FROM sqlite_sequence WHERE name = 'logs'), 0)) "
+            "WHERE name = '" + logPartitionName(current) + "';"
+        );
+        execOrThrow(db, "DROP TABLE logs;");
+    }
+    rebuildLogsView(db);
+}
+
+// ---------------- v3: час як int64 мс від epoch ----------------
+
+// ISO-текст -> мс від epoch (UTC). julianday() розуміє і "T", і пробіл,
+// і суфікси Z/±HH:MM; некоректний рядок дає NULL. Не-текст лишаємо як є.
+std::string isoToMsSql(const std::string& col) {
+    return "CASE WHEN typeof(" + col + ") = 'text' "
+           "THEN CAST(ROUND((julianday(" + col + ") - 2440587.5) * 86400000.0) AS INTEGER) "
+           "ELSE " + col + " END";
+}
+
+// ALTER TABLE не змінює тип колонки, а TEXT-affinity перетворила б int64 на
+// текст, тож таблицю перебудовуємо: нова -> копія з перетворенням -> DROP ->
+// RENAME. Лічильник AUTOINCREMENT переноситься. Потрібні вимкнені foreign_keys.
+void rebuildTable(sqlite3* db,
+                  const std::string& name,
+                  const std::string& columnsDdl,
+                  const std::string& columns,
+                  const std::string& selectExprs) {
+    const std::string tmp = name + "_v3";
+
+    execOrThrow(db, "CREATE TABLE " + tmp + " (" + columnsDdl + ");");
+    execOrThrow(db, "INSERT INTO " + tmp + "(" + columns + ") SELECT " + selectExprs + " FROM " + name + ";");
+
+    // seq старої таблиці зникне разом з нею — переносимо заздалегідь
+    execOrThrow(db,
+        "INSERT INTO sqlite_sequence(name, seq) "
+        "SELECT '" + tmp + "', seq FROM sqlite_sequence WHERE name = '" + name + "' "
+        "AND NOT EXISTS (SELECT 1 FROM sqlite_sequence WHERE name = '" + tmp + "');"
+    );
+    execOrThrow(db,
+        "UPDATE sqlite_sequence SET seq = MAX(seq, COALESCE("
+        "(SELECT seq FROM sqlite_sequence WHERE name = '" + name + "'), 0)) "
+        "WHERE name = '" + tmp + "';"
+    );
+
+    execOrThrow(db, "DROP TABLE " + name + ";");
+    execOrThrow(db, "ALTER TABLE " + tmp + " RENAME TO " + name + ";");
+}
+
+void migrateEpochTimestamps(sqlite3* db) {
+    // --- ships.departed_at / eta ---
+    rebuildTable(db, "ships",
+        "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+        "  name TEXT NOT NULL UNIQUE,"
+        "  type TEXT NOT NULL DEFAULT 'cargo',"
+        "  country TEXT NOT NULL DEFAULT 'Unknown',"
+        "  port_id INTEGER,"
+        "  status TEXT NOT NULL DEFAULT 'docked',"
+        "  company_id INTEGER,"
+        "  speed_knots REAL NOT NULL DEFAULT 20.0,"
+        "  departed_at INTEGER,"          // мс від epoch
+        "  destination_port_id INTEGER,"
+        "  eta INTEGER,"                  // мс від epoch
+        "  voyage_distance_km REAL,"
+        "  FOREIGN KEY(port_id) REFERENCES ports(id),"
+        "  FOREIGN KEY(company_id) REFERENCES companies(id)",
+        "id, name, type, country, port_id, status, company_id, speed_knots, "
+        "departed_at, destination_port_id, eta, voyage_distance_km",
+        "id, name, type, country, port_id, COALESCE(status, 'docked'), company_id, "
+        "COALESCE(speed_knots, 20.0), " + isoToMsSql("departed_at") + ", destination_port_id, " +
+        isoToMsSql("eta") + ", voyage_distance_km"
+    );
+    execOrThrow(db, "CREATE INDEX IF NOT EXISTS idx_ships_company ON ships(company_id);");
+    execOrThrow(db, "CREATE INDEX IF NOT EXISTS idx_ships_port ON ships(port_id);");
+
+    // --- crew_assignments.start_utc / end_utc ---
+    rebuildTable(db, "crew_assignments",
+        "  id        INTEGER PRIMARY KEY AUTOINCREMENT,"
+        "  person_id INTEGER NOT NULL,"
+        "  ship_id   INTEGER NOT NULL,"
+        "  start_utc INTEGER NOT NULL,"   // мс від epoch
+        "  end_utc   INTEGER,"            // мс від epoch; NULL — активне
+        "  FOREIGN KEY(person_id) REFERENCES people(id),"
+        "  FOREIGN KEY(ship_id)   REFERENCES ships(id)",
+        "id, person_id, ship_id, start_utc, end_utc",
+        "id, person_id, ship_id, COALESCE(" + isoToMsSql("start_utc") + ", 0), " + isoToMsSql("end_utc")
+    );
+    execOrThrow(db,
+        "CREATE UNIQUE INDEX IF NOT EXISTS ux_crew_ship_active "
+        "ON crew_assignments(ship_id) WHERE end_utc IS NULL;"
+    );
+    execOrThrow(db,
+        "CREATE UNIQUE INDEX IF NOT EXISTS ux_crew_person_active "
+        "ON crew_assignments(person_id) WHERE end_utc IS NULL;"
+    );
+    execOrThrow(db, "CREATE INDEX IF NOT EXISTS crew_ship_idx ON crew_assignments(ship_id);");
+    execOrThrow(db, "CREATE INDEX IF NOT EXISTS crew_person_idx ON crew_assignments(person_id);");
+
+    // --- logs_YYYYMM.ts ---
+    // view посилається на партиції: прибираємо його на час перебудови
+    execOrThrow(db, "DROP VIEW IF EXISTS logs;");
+    for (const auto& name : logPartitionNames(db)) {
+        rebuildTable(db, name,
+            "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+            "  ts INTEGER NOT NULL,"
+            "  level TEXT NOT NULL,"
+            "  event_type TEXT NOT NULL,"
+            "  entity TEXT,"
+            "  entity_id INTEGER,"
+            "  user TEXT,"
+            "  message TEXT",
+            "id, ts, level, event_type, entity, entity_id, user, message",
+            "id, COALESCE(" + isoToMsSql("ts") + ", 0), level, event_type, entity, entity_id, user, message"
+        );
+        execOrThrow(db, "CREATE INDEX IF NOT EXISTS idx_" + name + "_ts ON " + name + "(ts);");
+        execOrThrow(db, "CREATE INDEX IF NOT EXISTS idx_" + name + "_event_type ON " + name + "(event_type);");
+    }
+    rebuildLogsView(db);
+}
+
+// v4: прибуття шукаються лише серед departed за eta.
+// Частковий індекс містить тільки кораблі в дорозі, тож тік processArrivals
+// читає кілька записів замість усього флоту, а docked-кораблі індекс не пухнуть.
+void migrateDepartedEtaIndex(sqlite3* db) {
+    execOrThrow(db,
+        "CREATE INDEX IF NOT EXISTS idx_ships_departed_eta "
+        "ON ships(eta) WHERE status = 'departed';"
+    );
+}
+
+// v5: явні морські коридори для планувальника маршрутів (geo::RoutePlanner).
+// Коридор неорієнтований; порт зникає — зникають і його коридори.
+void migrateSeaLanes(sqlite3* db) {
+    execOrThrow(db,
+        "CREATE TABLE IF NOT EXISTS sea_lanes ("
+        "  from_port_id INTEGER NOT NULL REFERENCES ports(id) ON DELETE CASCADE,"
+        "  to_port_id   INTEGER NOT NULL REFERENCES ports(id) ON DELETE CASCADE,"
+        "  PRIMARY KEY (from_port_id, to_port_id),"
+        "  CHECK (from_port_id <> to_port_id)"
+        ") WITHOUT ROWID;"
+    );
+    execOrThrow(db, "CREATE INDEX IF NOT EXISTS idx_sea_lanes_to ON sea_lanes(to_port_id);");
+}
+
+// v6: журнал рейсів. Рядок додається при відправленні, прибуття лише
+// дописує arrived_at; ships.* рейсу очищаються, а історія лишається тут.
+// Без FK: історія переживає видалення корабля чи порту.
+// Індекси покривні для аналітики (VoyagesRepo::routeStats / shipUtilization).
+void migrateVoyages(sqlite3* db) {
+    execOrThrow(db,
+        "CREATE TABLE IF NOT EXISTS voyages ("
+        "  id                  INTEGER PRIMARY KEY AUTOINCREMENT,"
+        "  ship_id             INTEGER NOT NULL,"
+        "  origin_port_id      INTEGER NOT NULL,"
+        "  destination_port_id INTEGER NOT NULL,"
+        "  departed_at         INTEGER NOT NULL,"   // мс від epoch
+        "  planned_eta         INTEGER,"            // ETA на момент відправлення
+        "  arrived_at          INTEGER,"            // NULL — ще в дорозі
+        "  distance_km         REAL NOT NULL DEFAULT 0,"
+        "  speed_knots         REAL NOT NULL DEFAULT 0"
+        ");"
+    );
+    execOrThrow(db,
+        "CREATE INDEX IF NOT EXISTS idx_voyages_ship "
+        "ON voyages(ship_id, departed_at, arrived_at);"
+    );
+    execOrThrow(db,
+        "CREATE INDEX IF NOT EXISTS idx_voyages_route "
+        "ON voyages(origin_port_id, destination_port_id, arrived_at, departed_at, planned_eta);"
+    );
+    execOrThrow(db,
+        "CREATE INDEX IF NOT EXISTS idx_voyages_departed ON voyages(departed_at);"
+    );
+
+    // рейси, що вже в дорозі: прибуття закриє їх, як і нові.
+    // Старий фронтенд при відправленні ставив port_id = пункт призначення —
+    // порт відправлення таких рейсів невідомий, тож їх не переносимо
+    // (інакше в статистиці маршрутів з'явились би петлі A -> A)
+    execOrThrow(db,
+        "INSERT INTO voyages (ship_id, origin_port_id, destination_port_id, departed_at, "
+        "                     planned_eta, distance_km, speed_knots) "
+        "SELECT id, port_id, destination_port_id, departed_at, NULLIF(eta, 0), "
+        "       IFNULL(voyage_distance_km, 0), IFNULL(speed_knots, 0) "
+        "FROM ships "
+        "WHERE status = 'departed' AND port_id > 0 AND destination_port_id > 0 "
+        "  AND port_id <> destination_port_id AND departed_at > 0;"
+    );
+}
+
+struct Migration {
+    int version;
+    const char* name;
+    void (*apply)(sqlite3* db);
+};
+
+constexpr Migration kMigrations[] = {
+    {1, "baseline schema", &migrateBaseline},
+    {2, "monthly log partitions", &migrateLogPartitions},
+    {3, "epoch millisecond timestamps", &migrateEpochTimestamps},
+    {4, "departed ships eta index", &migrateDepartedEtaIndex},
+    {5, "sea lanes", &migrateSeaLanes},
+    {6, "voyages ledger", &migrateVoyages},
+};
+
+constexpr int kLatestSchemaVersion = kMigrations[std::size(kMigrations) - 1].version;
+
+// Один запит: нема таблиці schema_version -> версія 0
+int currentSchemaVersion(sqlite3* db) {
+    sqlite3_stmt* st = nullptr;
+    if (sqlite3_prepare_v2(db, "SELECT MAX(version) FROM schema_version;", -1, &st, nullptr) != SQLITE_OK) {
+        return 0;
+    }
+    int version = 0;
+    if (sqlite3_step(st) == SQLITE_ROW) {
+        version = sqlite3_column_int(st, 0);
+    }
+    sqlite3_finalize(st);
+    return version;
+}
+
+} // namespace
+
+namespace {
+
+std::string upperAscii(std::string s) {
+    for (char& c : s) {
+        if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+    }
+    return s;
+}
+
+// Параметри для ще не створеного Db; за замовчуванням — з оточення
+DbOptions& pendingOptions() {
+    static DbOptions opts = DbOptions::fromEnv("balanced");
+    return opts;
+}
+
+std::atomic<bool>& dbCreated() {
+    static std::atomic<bool> created{false};
+    return created;
+}
+
+} // namespace
+
+void Db::configure(const DbOptions& opts) {
+    if (dbCreated().load()) {
+        throw std::logic_error("Db::configure() called after Db::instance()");
+    }
+    opts.validate();
+    pendingOptions() = opts;
+}
+
+Db& Db::instance() {
+    static Db inst;
+    return inst;
+}
+
+// З'єднання пулу разом з його кешем prepared statements.
+// Кеш належить з'єднанню, тож потік-власник працює з ним без блокувань.
+struct Db::Connection {
+    struct SqlHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const noexcept {
+            return std::hash<std::string_view>{}(s);
+        }
+    };
+
+    struct CachedStmt {
+        sqlite3_stmt* st{nullptr};
+        bool inUse{false};
+    };
+
+    sqlite3* db{nullptr};
+    std::unordered_map<std::string, CachedStmt, SqlHash, std::equal_to<>> stmts;
+
+    // CDC: події відкритої транзакції і закомічені, але ще не опубліковані.
+    // Події кожного коміту мають зарезервовані позиції кільця ChangeFeed.
+    struct CommitBatch {
+        std::uint64_t ringPos{0};
+        std::size_t   count{0};
+    };
+    std::vector<ChangeEvent> pendingChanges;
+    std::vector<ChangeEvent> committedChanges;
+    std::vector<CommitBatch> committedBatches;
+
+    // Аудит async-режиму: рядки відкритої транзакції і закомічені, ще не в черзі
+    std::vector<LogRecord> pendingLogs;
+    std::vector<LogRecord> committedLogs;
+
+    ~Connection() {
+        for (auto& [sql, e] : stmts) {
+            sqlite3_finalize(e.st);
+        }
+        if (db) sqlite3_close(db);
+    }
+};
+
+// Тримає з'єднання потоку і повертає його в пул, коли потік завершується
+struct ThreadConnection {
+    Db::Connection* conn{nullptr};
+
+    ~ThreadConnection() {
+        if (conn) Db::instance().release(conn);
+    }
+};
+
+namespace {
+
+thread_local ThreadConnection tlsConnection;
+
+// Верхня межа кешу на одне з'єднання (динамічні SQL у LogsController)
+constexpr std::size_t kMaxCachedStmts = 256;
+
+sqlite3_stmt* prepareOrThrow(sqlite3* db, const char* sql) {
+    sqlite3_stmt* st = nullptr;
+    if (sqlite3_prepare_v2(db, sql, -1, &st, nullptr) != SQLITE_OK) {
+        throw std::runtime_error(sqlite3_errmsg(db));
+    }
+    return st;
+}
+
+} // namespace
+
+Db::Db() : opts_(pendingOptions()) {
+    namespace fs = std::filesystem;
+
+    opts_.validate();
+    dbCreated().store(true);
+
+    if (opts_.inMemory()) {
+        // memdb VFS: одна іменована БД у пам'яті, спільна для всіх з'єднань пулу.
+        // Живе, доки відкрите хоч одне з'єднання (основне тримаємо до кінця).
+        path_ = "file:/oop?vfs=memdb";
+        if (upperAscii(opts_.journalMode) == "WAL") {
+            std::cerr << "[Db] WAL is not supported in memory, using journal_mode=MEMORY\n";
+            opts_.journalMode = "MEMORY";
+        }
+    } else {
+        fs::path dbPath = opts_.path.empty()
+            ? fs::current_path().parent_path().parent_path() / "data" / "app.db"
+            : fs::path(opts_.path);
+        if (dbPath.has_parent_path()) {
+            fs::create_directories(dbPath.parent_path());
+        }
+        path_ = dbPath.string();
+    }
+
+    auto primary = openConnection();
+    db_ = primary->db;
+
+    // Діє лише для нової (порожньої) БД: дає змогу повертати місце
+    // після видалення партицій журналу через incremental_vacuum
+    execOrThrow(db_, "PRAGMA auto_vacuum = INCREMENTAL;");
+
+    runMigrations();
+
+    // після міграцій: перебудова таблиць схеми — не зміни даних
+    attachChangeHooks(primary.get());
+
+    idle_.push_back(primary.get());
+    conns_.push_back(std::move(primary));
+
+    std::cerr << "[Db] profile=" << opts_.profile << " path=" << path_
+              << " journal_mode=" << opts_.journalMode
+              << " synchronous=" << opts_.synchronous << "\n";
+}
+
+Db::~Db() {
+    // Спершу дописуємо чергу аудиту — писач ще користується своїм з'єднанням
+    auditWriter_.reset();
+
+    std::lock_guard<std::mutex> lock(poolMu_);
+    idle_.clear();
+    conns_.clear();
+    db_ = nullptr;
+}
+
+std::unique_ptr<Db::Connection> Db::openConnection() const {
+    auto c = std::make_unique<Connection>();
+    // NOMUTEX: з'єднання використовує лише один потік одночасно
+    int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX;
+    if (opts_.inMemory()) flags |= SQLITE_OPEN_URI;
+    if (sqlite3_open_v2(path_.c_str(), &c->db, flags, nullptr) != SQLITE_OK) {
+        std::string msg = c->db ? sqlite3_errmsg(c->db) : "sqlite open failed";
+        throw std::runtime_error(msg);
+    }
+
+    // Писачі з різних потоків чекають на WAL-лок замість SQLITE_BUSY
+    sqlite3_busy_timeout(c->db, 5000);
+
+    // Значення перевірені DbOptions::validate(), тож підстановка безпечна.
+    // WAL зберігається у файлі БД: читачі не блокують писача і навпаки;
+    // інші режими журналу діють на рівні з'єднання, тому ставимо на кожному.
+    execOrThrow(c->db, "PRAGMA foreign_keys = ON;");
+    execOrThrow(c->db, "PRAGMA journal_mode = " + opts_.journalMode + ";");
+    execOrThrow(c->db, "PRAGMA synchronous = " + opts_.synchronous + ";");
+    execOrThrow(c->db, "PRAGMA cache_size = -" + std::to_string(opts_.cacheSizeKb) + ";");
+    execOrThrow(c->db, "PRAGMA mmap_size = " + std::to_string(opts_.mmapSize) + ";");
+
+    return c;
+}
+
+Db::Connection* Db::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(poolMu_);
+        if (!idle_.empty()) {
+            Connection* c = idle_.back();
+            idle_.pop_back();
+            return c;
+        }
+    }
+
+    auto c = openConnection();
+    Connection* raw = c.get();
+    attachChangeHooks(raw);
+    std::lock_guard<std::mutex> lock(poolMu_);
+    conns_.push_back(std::move(c));
+    return raw;
+}
+
+void Db::release(Connection* c) {
+    std::lock_guard<std::mutex> lock(poolMu_);
+    idle_.push_back(c);
+}
+
+Db::Connection* Db::current() {
+    if (!tlsConnection.conn) {
+        tlsConnection.conn = acquire();
+    }
+    return tlsConnection.conn;
+}
+
+sqlite3* Db::handle() {
+    return current()->db;
+}
+
+std::size_t Db::poolSize() {
+    std::lock_guard<std::mutex> lock(poolMu_);
+    return conns_.size();
+}
+
+// ------------------ change feed ------------------
+
+void Db::attachChangeHooks(Connection* c) {
+    // update_hook: рядок змінено (у межах відкритої транзакції)
+    sqlite3_update_hook(c->db, [](void* ctx, int op, const char*, const char* table, sqlite3_int64 rowid) {
+        const ChangeTable t = changeTableFromName(table);
+        if (t == ChangeTable::Count_) return;
+        const ChangeOp o = op == SQLITE_INSERT ? ChangeOp::Insert
+                         : op == SQLITE_DELETE ? ChangeOp::Delete
+                                               : ChangeOp::Update;
+        static_cast<Connection*>(ctx)->pendingChanges.push_back({t, o, rowid, 0});
+    }, c);
+
+    // commit_hook: викликається під write-локом, тож seq і позиції кільця
+    // йдуть в порядку комітів. Публікуємо ж лише після успішного COMMIT
+    // (publishChanges).
+    sqlite3_commit_hook(c->db, [](void* ctx) -> int {
+        auto* conn = static_cast<Connection*>(ctx);
+        for (auto& r : conn->pendingLogs) conn->committedLogs.push_back(std::move(r));
+        conn->pendingLogs.clear();
+        if (conn->pendingChanges.empty()) return 0;
+        ChangeFeed& feed = Db::instance().changes_;
+        const std::uint64_t seq = feed.nextCommitSeq();
+        const std::size_t n = conn->pendingChanges.size();
+        conn->committedBatches.push_back({feed.reserve(n), n});
+        for (auto& e : conn->pendingChanges) {
+            e.commitSeq = seq;
+            conn->committedChanges.push_back(e);
+        }
+        conn->pendingChanges.clear();
+        return 0;
+    }, c);
+
+    // rollback_hook: транзакцію відкочено (у т.ч. невдалий COMMIT).
+    // Зарезервовані слоти все одно заповнюємо — інакше підписники на них
+    // зупиняться; зайва подія допустима («хоча б раз»).
+    sqlite3_rollback_hook(c->db, [](void* ctx) {
+        auto* conn = static_cast<Connection*>(ctx);
+        conn->pendingChanges.clear();
+        conn->pendingLogs.clear();
+        Db::instance().publishCommitted(conn);
+    }, c);
+}
+
+// Hooks прив'язані до з'єднання потоку; чуже з'єднання (DI) подій не має
+Db::Connection* Db::ownConnection(sqlite3* db) noexcept {
+    Connection* c = tlsConnection.conn;
+    return c && c->db == db ? c : nullptr;
+}
+
+void Db::publishChanges(sqlite3* db) noexcept {
+    Connection* c = ownConnection(db);
+    if (!c || !sqlite3_get_autocommit(db)) return;
+    publishCommitted(c);
+    if (!c->committedLogs.empty()) {
+        flushCommittedLogs(c);
+    }
+}
+
+void Db::publishCommitted(Connection* c) noexcept {
+    const ChangeEvent* e = c->committedChanges.data();
+    for (const auto& b : c->committedBatches) {
+        changes_.publish(b.ringPos, e, b.count);
+        e += b.count;
+    }
+    c->committedBatches.clear();
+    c->committedChanges.clear();
+}
+
+// Закомічені рядки аудиту -> черга писача; якщо черга повна, дописуємо
+// самі (вже в autocommit, тож кожен рядок — окремий commit)
+void Db::flushCommittedLogs(Connection* c) noexcept {
+    std::vector<LogRecord> rows;
+    rows.swap(c->committedLogs);
+    for (auto& r : rows) {
+        if (auditWriter_ && auditWriter_->enqueue(std::move(r))) continue;
+        try {
+            writeLogRow(c->db, r);
+        } catch (const std::exception& e) {
+            std::cerr << "[Db] audit row lost after commit: " << e.what() << "\n";
+        }
+    }
+}
+
+// ------------------ statement cache ------------------
+
+sqlite3_stmt* Db::takeStmt(sqlite3* db, const char* sql, bool*& slot) {
+    slot = nullptr;
+
+    // Кешуємо лише для власного з'єднання потоку:
+    // чуже з'єднання (DI у PortsRepo) може використовуватись паралельно
+    Connection* c = tlsConnection.conn;
+    if (!stmtCacheEnabled_.load(std::memory_order_relaxed) || !c || c->db != db) {
+        stmtMisses_.fetch_add(1, std::memory_order_relaxed);
+        return prepareOrThrow(db, sql);
+    }
+
+    auto it = c->stmts.find(std::string_view(sql));
+    if (it != c->stmts.end() && !it->second.inUse) {
+        stmtHits_.fetch_add(1, std::memory_order_relaxed);
+        it->second.inUse = true;
+        slot = &it->second.inUse;
+        return it->second.st;
+    }
+
+    stmtMisses_.fetch_add(1, std::memory_order_relaxed);
+    sqlite3_stmt* st = prepareOrThrow(db, sql);
+
+    // Той самий SQL уже виконується вище по стеку — віддаємо незакешовану копію
+    if (it != c->stmts.end() || c->stmts.size() >= kMaxCachedStmts) {
+        return st;
+    }
+
+    auto [ins, ok] = c->stmts.emplace(sql, Connection::CachedStmt{st, true});
+    (void)ok;
+    stmtCached_.fetch_add(1, std::memory_order_relaxed);
+    slot = &ins->second.inUse;
+    return st;
+}
+
+void Db::giveBackStmt(sqlite3_stmt* st, bool* slot) noexcept {
+    if (!slot) {
+        sqlite3_finalize(st);
+        return;
+    }
+    // reset завершує неявну read-транзакцію, clear_bindings — звільняє копії тексту
+    sqlite3_reset(st);
+    sqlite3_clear_bindings(st);
+    *slot = false;
+}
+
+StmtCacheStats Db::stmtCacheStats() {
+    StmtCacheStats s;
+    s.hits   = stmtHits_.load(std::memory_order_relaxed);
+    s.misses = stmtMisses_.load(std::memory_order_relaxed);
+    s.size   = stmtCached_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void Db::runMigrations() {
+    const auto t0 = std::chrono::steady_clock::now();
+    auto elapsedMs = [&] {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    };
+
+    // Швидкий шлях: БД уже актуальна
+    const int current = currentSchemaVersion(db_);
+    if (current >= kLatestSchemaVersion) {
+        std::cout << "[Db] schema v" << current << " is up to date (" << elapsedMs() << " ms)\n";
+        return;
+    }
+
+    // foreign_keys не можна перемкнути всередині транзакції,
+    // а перебудова таблиць у міграціях вимагає, щоб вони були вимкнені
+    execOrThrow(db_, "PRAGMA foreign_keys = OFF;");
+    execOrThrow(db_, "BEGIN IMMEDIATE;");
+    try {
+        execOrThrow(db_,
+            "CREATE TABLE IF NOT EXISTS schema_version ("
+            "  version    INTEGER PRIMARY KEY,"
+            "  name       TEXT NOT NULL,"
+            "  applied_at TEXT NOT NULL DEFAULT (strftime('%Y-%m-%dT%H:%M:%SZ','now'))"
+            ");"
+        );
+
+        for (const auto& m : kMigrations) {
+            if (m.version <= current) continue;
+
+            m.apply(db_);
+
+            sqlite3_stmt* st = nullptr;
+            if (sqlite3_prepare_v2(db_, "INSERT INTO schema_version(version, name) VALUES(?, ?);",
+                                   -1, &st, nullptr) != SQLITE_OK) {
+                throw std::runtime_error(sqlite3_errmsg(db_));
+            }
+            sqlite3_bind_int(st, 1, m.version);
+            sqlite3_bind_text(st, 2, m.name, -1, SQLITE_STATIC);
+            const int rc = sqlite3_step(st);
+            sqlite3_finalize(st);
+            if (rc != SQLITE_DONE) {
+                throw std::runtime_error(std::string("schema_version insert failed: ") + sqlite3_errmsg(db_));
+            }
+            std::cout << "[Db] applied migration " << m.version << ": " << m.name << "\n";
+        }
+
+        if (scalarInt(db_, "SELECT COUNT(*) FROM pragma_foreign_key_check;") != 0) {
+            throw std::runtime_error("foreign key check failed after migrations");
+        }
+
+        execOrThrow(db_, "COMMIT;");
+    } catch (...) {
+        sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+        sqlite3_exec(db_, "PRAGMA foreign_keys = ON;", nullptr, nullptr, nullptr);
+        throw;
+    }
+    execOrThrow(db_, "PRAGMA foreign_keys = ON;");
+
+    // --- AUTO-SEEDING DISABLED ---
+    if (kEnableSeeding) {
+        seedPortsIfEmpty(db_);
+        seedShipsIfEmpty(db_);
+    }
+
+    std::cout << "[Db] schema migrated v" << current << " -> v" << kLatestSchemaVersion
+              << " (" << elapsedMs() << " ms)\n";
 }
 
 void Db::insertLog(const std::string& level,
@@ -318,57 +1116,224 @@ void Db::insertLog(const std::string& level,
                    int entity_id,
                    const std::string& user,
                    const std::string& message) {
-    const char* sql = "INSERT INTO logs(ts, level, event_type, entity, entity_id, user, message) VALUES (?, ?, ?, ?, ?, ?, ?);";
-    sqlite3_stmt* st = nullptr;
-    if (sqlite3_prepare_v2(db_, sql, -1, &st, nullptr) != SQLITE_OK) {
-        throw std::runtime_error(sqlite3_errmsg(db_));
-    }
-
-    // timestamp UTC ISO-8601
-    std::time_t t = std::time(nullptr);
-    std::tm tm = *std::gmtime(&t);
-    char buf[32];
-    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
-    const std::string ts(buf);
-
-    sqlite3_bind_text(st, 1, ts.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(st, 2, level.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(st, 3, event_type.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(st, 4, entity.c_str(), -1, SQLITE_TRANSIENT);
-    if (entity_id > 0) sqlite3_bind_int(st, 5, entity_id); else sqlite3_bind_null(st, 5);
-    sqlite3_bind_text(st, 6, user.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(st, 7, message.c_str(), -1, SQLITE_TRANSIENT);
-
-    if (sqlite3_step(st) != SQLITE_DONE) {
-        std::string err = sqlite3_errmsg(db_);
-        sqlite3_finalize(st);
-        throw std::runtime_error("log insert failed: " + err);
+    // момент події (а не запису в БД), мс від epoch
+    LogRecord r{util::nowMs(), level, event_type, entity, entity_id, user, message};
+
+    sqlite3* db = handle();
+
+    const bool inTransaction = sqlite3_get_autocommit(db) == 0;
+
+    if (auditWriter_) {
+        // async всередині транзакції: рядок чекає на з'єднанні і йде в чергу
+        // після COMMIT (publishChanges) або зникає при rollback
+        if (inTransaction) {
+            if (Connection* c = ownConnection(db)) {
+                c->pendingLogs.push_back(std::move(r));
+                return;
+            }
+        } else if (auditWriter_->enqueue(std::move(r))) {
+            // async: рядок іде в чергу; якщо вона повна — пишемо одразу
+            // (enqueue забирає запис лише у разі успіху)
+            return;
+        }
     }
-    sqlite3_finalize(st);
+    // sync (або чуже з'єднання): рядок пишеться в ту ж транзакцію,
+    // щоб аудит комітився/відкочувався разом зі зміною
+    writeLogRow(db, r);
+}
+
+void Db::writeLogRow(sqlite3* db, const LogRecord& r) {
+    const int month = util::monthKey(r.ts);
+    if (month != logMonth_.load(std::memory_order_acquire)) {
+        ensureLogPartition(db, month);
+    }
+
+    // SQL партиції кешується на потік; сам statement — у кеші з'єднання
+    thread_local int sqlMonth = 0;
+    thread_local std::string sql;
+    if (sqlMonth != month) {
+        sql = "INSERT INTO " + logPartitionName(month) +
+              "(id, ts, level, event_type, entity, entity_id, user, message) VALUES (" +
+              kNextLogIdSql + ", ?, ?, ?, ?, ?, ?, ?);";
+        sqlMonth = month;
+    }
+    Stmt st(db, sql);
+
+    sqlite3_bind_int64(st.get(), 1, r.ts);
+    sqlite3_bind_text(st.get(), 2, r.level.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(st.get(), 3, r.event_type.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(st.get(), 4, r.entity.c_str(), -1, SQLITE_STATIC);
+    if (r.entity_id > 0) sqlite3_bind_int(st.get(), 5, r.entity_id); else sqlite3_bind_null(st.get(), 5);
+    sqlite3_bind_text(st.get(), 6, r.user.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(st.get(), 7, r.message.c_str(), -1, SQLITE_STATIC);
+
+    if (sqlite3_step(st.get()) != SQLITE_DONE) {
+        throw std::runtime_error("log insert failed: " + std::string(sqlite3_errmsg(db)));
+    }
+}
+
+// Викликається з потоку AuditLogWriter: одна транзакція (один fsync) на пачку
+void Db::writeLogBatch(std::vector<LogRecord>& rows) {
+    sqlite3* db = handle();
+
+    Transaction tx(db);
+    for (const auto& r : rows) {
+        writeLogRow(db, r);
+    }
+    tx.commit();
+}
+
+// Партиція місяця (і наступного — щоб перехід місяця не робив DDL на
+// гарячому шляху). Працює і всередині вже відкритої транзакції.
+void Db::ensureLogPartition(sqlite3* db, int month) {
+    std::lock_guard<std::mutex> lock(logPartitionMu_);
+    if (logMonth_.load() == month) return;
+
+    execOrThrow(db, "SAVEPOINT log_partition;");
+    try {
+        const bool created = createLogPartition(db, month);
+        const bool createdNext = createLogPartition(db, addMonths(month, 1));
+        if (created || createdNext) {
+            rebuildLogsView(db);
+        }
+        if (auditOpts_.retentionMonths > 0) {
+            dropLogPartitionsBefore(db, addMonths(monthKeyNow(), 1 - auditOpts_.retentionMonths));
+        }
+        execOrThrow(db, "RELEASE log_partition;");
+    } catch (...) {
+        sqlite3_exec(db, "ROLLBACK TO log_partition; RELEASE log_partition;", nullptr, nullptr, nullptr);
+        throw;
+    }
+
+    // Лише поточний місяць вважаємо «гарячим»: запізнілі рядки минулого
+    // місяця теж пройдуть через ensure, але без DDL
+    if (month == monthKeyNow()) {
+        logMonth_.store(month, std::memory_order_release);
+    }
+}
+
+int Db::dropExpiredLogPartitions() {
+    if (auditOpts_.retentionMonths <= 0) return 0;
+
+    sqlite3* db = handle();
+    std::lock_guard<std::mutex> lock(logPartitionMu_);
+
+    execOrThrow(db, "BEGIN IMMEDIATE;");
+    int dropped = 0;
+    try {
+        dropped = dropLogPartitionsBefore(db, addMonths(monthKeyNow(), 1 - auditOpts_.retentionMonths));
+        execOrThrow(db, "COMMIT;");
+    } catch (...) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        throw;
+    }
+
+    if (dropped > 0) {
+        // Повертає вільні сторінки файлу, якщо БД створена з auto_vacuum=INCREMENTAL
+        sqlite3_exec(db, "PRAGMA incremental_vacuum;", nullptr, nullptr, nullptr);
+        std::cout << "[Db] dropped " << dropped << " expired log partition(s)\n";
+    }
+    return dropped;
+}
+
+std::vector<std::string> Db::logPartitions() {
+    return logPartitionNames(handle());
+}
+
+void Db::configureAuditLog(const AuditLogOptions& opts) {
+    // Старий писач дописує свою чергу в деструкторі
+    auditWriter_.reset();
+    auditOpts_ = opts;
+
+    if (opts.mode == AuditLogMode::Async) {
+        auditWriter_ = std::make_unique<AuditLogWriter>(
+            opts, [this](std::vector<LogRecord>& rows) { writeLogBatch(rows); });
+    }
+}
+
+void Db::flushLogs() {
+    if (auditWriter_) auditWriter_->flush();
 }
 
 void Db::reset() {
     // reset для тестів: чистимо бізнес-дані,
     // але НЕ чіпаємо ports/ship_types, щоб ShipsRepo::create не падав з нуля
 
-    execOrThrow(db_, "BEGIN;");
+    sqlite3* db = handle();
+
+    Transaction tx(db);
+    execOrThrow(db, "DELETE FROM crew_assignments;");
+    execOrThrow(db, "DELETE FROM company_ports;");
+    execOrThrow(db, "DELETE FROM ships;");
+    execOrThrow(db, "DELETE FROM people;");
+    execOrThrow(db, "DELETE FROM companies;");
+
+    execOrThrow(
+        db,
+        "DELETE FROM sqlite_sequence WHERE name IN ("
+        "'crew_assignments','company_ports','ships','people','companies'"
+        ");"
+    );
+    tx.commit();
+}
+
+// ================== Db::Transaction ==================
+
+namespace {
+// Одне ім'я для всіх рівнів: ROLLBACK TO/RELEASE діють на найглибший
+// savepoint з цим ім'ям, тобто саме на рівень цього об'єкта.
+constexpr const char* kTxSavepoint = "unit_of_work";
+} // namespace
+
+Db::Transaction::Transaction() : Transaction(Db::instance().handle()) {}
+
+Db::Transaction::Transaction(sqlite3* db)
+    : db_(db), nested_(sqlite3_get_autocommit(db) == 0) {
+    if (nested_) {
+        if (auto* c = Db::instance().ownConnection(db_)) {
+            changeMark_ = c->pendingChanges.size();
+            logMark_ = c->pendingLogs.size();
+        }
+        execOrThrow(db_, std::string("SAVEPOINT ") + kTxSavepoint + ";");
+    } else {
+        // дописати події autocommit-запитів, що ще не дійшли до підписників
+        Db::instance().publishChanges(db_);
+        execOrThrow(db_, "BEGIN IMMEDIATE;");
+    }
+}
+
+Db::Transaction::~Transaction() {
+    if (done_) return;
     try {
-        execOrThrow(db_, "DELETE FROM crew_assignments;");
-        execOrThrow(db_, "DELETE FROM company_ports;");
-        execOrThrow(db_, "DELETE FROM ships;");
-        execOrThrow(db_, "DELETE FROM people;");
-        execOrThrow(db_, "DELETE FROM companies;");
-
-        execOrThrow(
-            db_,
-            "DELETE FROM sqlite_sequence WHERE name IN ("
-            "'crew_assignments','company_ports','ships','people','companies'"
-            ");"
-        );
+        rollback();
+    } catch (...) {
+        // деструктор не кидає; з'єднання лишиться у стані, який поверне SQLite
+    }
+}
 
+void Db::Transaction::commit() {
+    if (done_) throw std::logic_error("Transaction already finished");
+    if (nested_) {
+        execOrThrow(db_, std::string("RELEASE ") + kTxSavepoint + ";");
+    } else {
         execOrThrow(db_, "COMMIT;");
-    } catch (...) {
-        sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
-        throw;
+        Db::instance().publishChanges(db_);
+    }
+    done_ = true;
+}
+
+void Db::Transaction::rollback() {
+    if (done_) throw std::logic_error("Transaction already finished");
+    done_ = true;
+    if (nested_) {
+        // ROLLBACK TO не викликає rollback_hook — відкидаємо події savepoint самі
+        if (auto* c = Db::instance().ownConnection(db_)) {
+            if (c->pendingChanges.size() > changeMark_) c->pendingChanges.resize(changeMark_);
+            if (c->pendingLogs.size() > logMark_) c->pendingLogs.resize(logMark_);
+        }
+        execOrThrow(db_, std::string("ROLLBACK TO ") + kTxSavepoint + "; RELEASE " + kTxSavepoint + ";");
+    } else if (sqlite3_get_autocommit(db_) == 0) {
+        // SQLite могла вже відкотити транзакцію сама (напр. SQLITE_FULL)
+        execOrThrow(db_, "ROLLBACK;");
     }
 }
@@ -0,0 +1,98 @@
+﻿// src/db/DbOptions.cpp
+#include "db/DbOptions.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+
+const char* env(const char* name) {
+    const char* v = std::getenv(name);
+    return (v && *v) ? v : nullptr;
+}
+
+std::string upper(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return s;
+}
+
+template <std::size_t N>
+bool oneOf(const std::string& v, const std::array<std::string_view, N>& allowed) {
+    return std::find(allowed.begin(), allowed.end(), v) != allowed.end();
+}
+
+constexpr std::array<std::string_view, 6> kJournalModes = {
+    "DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF"
+};
+
+constexpr std::array<std::string_view, 4> kSyncModes = {
+    "OFF", "NORMAL", "FULL", "EXTRA"
+};
+
+} // namespace
+
+DbOptions DbOptions::forProfile(const std::string& name) {
+    DbOptions o;
+    o.profile = name;
+
+    if (name == "durable") {
+        o.journalMode = "WAL";
+        o.synchronous = "FULL";
+        o.cacheSizeKb = 16384;
+        o.mmapSize    = 0;
+    } else if (name == "balanced") {
+        o.journalMode = "WAL";
+        o.synchronous = "NORMAL";
+        o.cacheSizeKb = 65536;
+        o.mmapSize    = 256LL * 1024 * 1024;
+    } else if (name == "bench") {
+        o.path        = ":memory:";
+        o.journalMode = "MEMORY";
+        o.synchronous = "OFF";
+        o.cacheSizeKb = 65536;
+        o.mmapSize    = 0;
+    } else if (name == "bench-tmpfs") {
+        o.path        = "/dev/shm/oop_bench.db";
+        o.journalMode = "WAL";
+        o.synchronous = "OFF";
+        o.cacheSizeKb = 65536;
+        o.mmapSize    = 256LL * 1024 * 1024;
+    } else {
+        throw std::invalid_argument("unknown db profile '" + name +
+                                    "' (expected durable, balanced, bench or bench-tmpfs)");
+    }
+    return o;
+}
+
+DbOptions DbOptions::fromEnv(const std::string& defaultProfile) {
+    const char* p = env("OOP_DB_PROFILE");
+    DbOptions o = forProfile(p ? p : defaultProfile);
+    o.applyEnv();
+    return o;
+}
+
+void DbOptions::applyEnv() {
+    if (const char* v = env("OOP_DB_PATH"))          path        = v;
+    if (const char* v = env("OOP_DB_JOURNAL_MODE"))  journalMode = v;
+    if (const char* v = env("OOP_DB_SYNCHRONOUS"))   synchronous = v;
+    if (const char* v = env("OOP_DB_CACHE_SIZE_KB")) cacheSizeKb = std::atoi(v);
+    if (const char* v = env("OOP_DB_MMAP_SIZE"))     mmapSize    = std::atoll(v);
+}
+
+void DbOptions::validate() const {
+    if (!oneOf(upper(journalMode), kJournalModes)) {
+        throw std::invalid_argument("invalid journal_mode '" + journalMode + "'");
+    }
+    if (!oneOf(upper(synchronous), kSyncModes)) {
+        throw std::invalid_argument("invalid synchronous '" + synchronous + "'");
+    }
+    if (cacheSizeKb < 0 || mmapSize < 0) {
+        throw std::invalid_argument("cache_size_kb and mmap_size must be non-negative");
+    }
+}
@@ -0,0 +1,15 @@
+﻿// src/db/Stmt.cpp
+#include "db/Stmt.h"
+#include "db/Db.h"
+
+Stmt::Stmt(sqlite3* db, const char* sql) {
+    st_ = Db::instance().takeStmt(db, sql, slot_);
+}
+
+Stmt::~Stmt() {
+    if (!st_) return;
+    sqlite3* db = sqlite3_db_handle(st_);
+    Db::giveBackStmt(st_, slot_);
+    // autocommit-запит міг щойно закомітити зміни — віддаємо їх у ChangeFeed
+    Db::instance().publishChanges(db);
+}
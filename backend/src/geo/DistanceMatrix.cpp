@@ -0,0 +1,201 @@
+﻿// src/geo/DistanceMatrix.cpp
+#include "geo/DistanceMatrix.h"
+#include "geo/Geo.h"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace geo {
+
+namespace {
+
+// Менше рядків на потік — потоки дорожчі за саму тригонометрію
+constexpr std::size_t kMinRowsPerThread = 64;
+
+} // namespace
+
+DistanceMatrix& DistanceMatrix::instance() {
+    static DistanceMatrix m;
+    return m;
+}
+
+void DistanceMatrix::build(const std::vector<Port>& ports, unsigned threads) {
+    const std::size_t n = ports.size();
+
+    std::vector<std::int64_t> ids(n);
+    std::vector<double> lat(n), lon(n);
+    std::unordered_map<std::int64_t, std::size_t> slotOf;
+    slotOf.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        ids[i] = ports[i].id;
+        lat[i] = ports[i].lat;
+        lon[i] = ports[i].lon;
+        slotOf[ports[i].id] = i;
+    }
+
+    // запас під нові порти, щоб перші create не перевиділяли матрицю
+    const std::size_t stride = std::max<std::size_t>(16, n + n / 8);
+    std::vector<float> dist(stride * stride, 0.0f);
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t workers = std::clamp<std::size_t>(n / kMinRowsPerThread, 1, threads);
+
+    // рядок i рахує потік i % workers; кожен пише лише свої рядки
+    auto fillRows = [&](std::size_t first) {
+        std::vector<double> buf(n);
+        for (std::size_t i = first; i < n; i += workers) {
+            haversineKm(lat[i], lon[i], lat.data(), lon.data(), buf.data(), n);
+            float* row = dist.data() + i * stride;
+            for (std::size_t j = 0; j < n; ++j) row[j] = static_cast<float>(buf[j]);
+            row[i] = 0.0f;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (std::size_t w = 1; w < workers; ++w) pool.emplace_back(fillRows, w);
+    fillRows(0);
+    for (auto& t : pool) t.join();
+
+    std::unique_lock lock(mu_);
+    stride_ = stride;
+    dist_ = std::move(dist);
+    ids_ = std::move(ids);
+    lat_ = std::move(lat);
+    lon_ = std::move(lon);
+    slotOf_ = std::move(slotOf);
+}
+
+// Перевиділення заодно ущільнює «дірки» видалених портів, тож часті
+// create/delete не роздувають матрицю. Росте в ~1.25 раза: матриця
+// квадратна, тож подвоєння сторони — це x4 пам'яті.
+void DistanceMatrix::reserveLocked(std::size_t slots) {
+    if (slots <= stride_) return;
+
+    const std::size_t used = ids_.size();
+    std::vector<std::size_t> live;
+    live.reserve(slotOf_.size());
+    for (std::size_t i = 0; i < used; ++i) {
+        if (ids_[i] != 0) live.push_back(i);
+    }
+    const std::size_t need = slots - (used - live.size());
+
+    const std::size_t stride = need <= stride_
+        ? stride_
+        : std::max<std::size_t>({16, need, stride_ + stride_ / 4});
+    std::vector<float> dist(stride * stride, 0.0f);
+
+    std::vector<std::int64_t> ids(live.size());
+    std::vector<double> lat(live.size()), lon(live.size());
+    for (std::size_t k = 0; k < live.size(); ++k) {
+        const std::size_t i = live[k];
+        const float* src = dist_.data() + i * stride_;
+        float* dst = dist.data() + k * stride;
+        for (std::size_t m = 0; m < live.size(); ++m) dst[m] = src[live[m]];
+        ids[k] = ids_[i];
+        lat[k] = lat_[i];
+        lon[k] = lon_[i];
+        slotOf_[ids[k]] = k;
+    }
+
+    dist_ = std::move(dist);
+    ids_ = std::move(ids);
+    lat_ = std::move(lat);
+    lon_ = std::move(lon);
+    stride_ = stride;
+}
+
+// Рядок slot з ядра, стовпець — його ж значення (матриця симетрична)
+void DistanceMatrix::patchLocked(std::size_t slot) {
+    const std::size_t n = ids_.size();
+    std::vector<double> buf(n);
+    haversineKm(lat_[slot], lon_[slot], lat_.data(), lon_.data(), buf.data(), n);
+    buf[slot] = 0.0;
+
+    float* row = dist_.data() + slot * stride_;
+    for (std::size_t j = 0; j < n; ++j) {
+        const float d = static_cast<float>(buf[j]);
+        row[j] = d;
+        dist_[j * stride_ + slot] = d;
+    }
+}
+
+void DistanceMatrix::upsert(const Port& p) {
+    std::unique_lock lock(mu_);
+
+    std::size_t slot;
+    if (const auto it = slotOf_.find(p.id); it != slotOf_.end()) {
+        slot = it->second;
+        // назва/регіон на відстані не впливають
+        if (lat_[slot] == p.lat && lon_[slot] == p.lon) return;
+        lat_[slot] = p.lat;
+        lon_[slot] = p.lon;
+    } else {
+        reserveLocked(ids_.size() + 1);   // може ущільнити слоти
+        slot = ids_.size();
+        ids_.push_back(p.id);
+        lat_.push_back(p.lat);
+        lon_.push_back(p.lon);
+        slotOf_[p.id] = slot;
+    }
+    patchLocked(slot);
+}
+
+void DistanceMatrix::remove(std::int64_t portId) {
+    std::unique_lock lock(mu_);
+    const auto it = slotOf_.find(portId);
+    if (it == slotOf_.end()) return;
+    ids_[it->second] = 0;
+    slotOf_.erase(it);
+}
+
+std::optional<double> DistanceMatrix::distanceKm(std::int64_t from, std::int64_t to) const {
+    std::shared_lock lock(mu_);
+    const auto a = slotOf_.find(from);
+    const auto b = slotOf_.find(to);
+    if (a == slotOf_.end() || b == slotOf_.end()) return std::nullopt;
+    return dist_[a->second * stride_ + b->second];
+}
+
+bool DistanceMatrix::row(std::int64_t portId, std::vector<Entry>& out) const {
+    std::shared_lock lock(mu_);
+    const auto it = slotOf_.find(portId);
+    if (it == slotOf_.end()) return false;
+
+    const std::size_t slot = it->second;
+    const float* row = dist_.data() + slot * stride_;
+    out.clear();
+    out.reserve(slotOf_.size());
+    for (std::size_t j = 0; j < ids_.size(); ++j) {
+        if (j == slot || ids_[j] == 0) continue;
+        out.push_back(Entry{ids_[j], row[j]});
+    }
+    return true;
+}
+
+std::size_t DistanceMatrix::coordsOf(const std::int64_t* ids, std::size_t n,
+                                     double* lat, double* lon) const {
+    constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+    std::shared_lock lock(mu_);
+    std::size_t found = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto it = slotOf_.find(ids[i]);
+        if (it == slotOf_.end()) {
+            lat[i] = lon[i] = kNaN;
+            continue;
+        }
+        lat[i] = lat_[it->second];
+        lon[i] = lon_[it->second];
+        ++found;
+    }
+    return found;
+}
+
+std::size_t DistanceMatrix::size() const {
+    std::shared_lock lock(mu_);
+    return slotOf_.size();
+}
+
+} // namespace geo
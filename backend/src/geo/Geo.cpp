@@ -0,0 +1,39 @@
+﻿// src/geo/Geo.cpp
+#include "geo/Geo.h"
+
+#include <cmath>
+
+namespace geo {
+
+void PortCoords::reserve(std::size_t n) {
+    ids.reserve(n);
+    lat.reserve(n);
+    lon.reserve(n);
+}
+
+void PortCoords::push_back(std::int64_t id, double latDeg, double lonDeg) {
+    ids.push_back(id);
+    lat.push_back(latDeg);
+    lon.push_back(lonDeg);
+}
+
+void distancesFromKm(double lat, double lon, const PortCoords& ports, std::vector<double>& out) {
+    out.resize(ports.size());
+    haversineKm(lat, lon, ports.lat.data(), ports.lon.data(), out.data(), ports.size());
+}
+
+std::int64_t travelTimeMs(double distanceKm, double speedKnots) noexcept {
+    if (!(speedKnots > 0.0) || !(distanceKm > 0.0)) return 0;
+    const double hours = distanceKm / (speedKnots * kKmPerNauticalMile);
+    return static_cast<std::int64_t>(std::llround(hours * 3600.0 * 1000.0));
+}
+
+VoyagePlan planVoyage(const Port& from, const Port& to,
+                      double speedKnots, std::int64_t departedAtMs) noexcept {
+    VoyagePlan p;
+    p.distanceKm = haversineKm(from.lat, from.lon, to.lat, to.lon);
+    p.etaMs = departedAtMs + travelTimeMs(p.distanceKm, speedKnots);
+    return p;
+}
+
+} // namespace geo
@@ -0,0 +1,447 @@
+﻿// src/geo/Haversine.cpp
+// Haversine і slerp по великому колу: скалярні формули і пакетні AVX2-ядра
+// з вибором під час виконання.
+#include "geo/Geo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define OOP_GEO_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#else
+#define OOP_GEO_X86 0
+#endif
+
+// GCC/Clang компілюють AVX2-функції без глобального -mavx2,
+// тож бінарник лишається сумісним з процесорами без AVX2
+#if OOP_GEO_X86 && (defined(__GNUC__) || defined(__clang__))
+#define OOP_GEO_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define OOP_GEO_AVX2
+#endif
+
+namespace geo {
+
+namespace {
+
+constexpr double kDegToRad = 3.14159265358979323846 / 180.0;
+
+using Kernel = void (*)(const double*, const double*, const double*, const double*,
+                        double*, std::size_t) noexcept;
+using KernelFrom = void (*)(double, double, const double*, const double*,
+                            double*, std::size_t) noexcept;
+using KernelSlerp = void (*)(const double*, const double*, const double*, const double*,
+                             const double*, double*, double*, std::size_t) noexcept;
+
+// Дуга коротша за це (рад) — лінійна інтерполяція: sin(delta) ~ 0
+constexpr double kSlerpMinAngle = 1e-12;
+constexpr double kRadToDeg = 180.0 / 3.14159265358979323846;
+
+void slerpOne(double lat1, double lon1, double lat2, double lon2, double f,
+              double& latOut, double& lonOut) noexcept {
+    const double p1 = lat1 * kDegToRad, l1 = lon1 * kDegToRad;
+    const double p2 = lat2 * kDegToRad, l2 = lon2 * kDegToRad;
+
+    const double x1 = std::cos(p1) * std::cos(l1), y1 = std::cos(p1) * std::sin(l1), z1 = std::sin(p1);
+    const double x2 = std::cos(p2) * std::cos(l2), y2 = std::cos(p2) * std::sin(l2), z2 = std::sin(p2);
+
+    // кут між векторами: atan2(|u1 x u2|, u1 . u2) стабільний на всьому [0, pi]
+    const double cx = y1 * z2 - z1 * y2, cy = z1 * x2 - x1 * z2, cz = x1 * y2 - y1 * x2;
+    const double sinD = std::sqrt(cx * cx + cy * cy + cz * cz);
+    const double delta = std::atan2(sinD, x1 * x2 + y1 * y2 + z1 * z2);
+
+    double a = 1.0 - f, b = f;
+    if (delta > kSlerpMinAngle) {
+        a = std::sin((1.0 - f) * delta) / sinD;
+        b = std::sin(f * delta) / sinD;
+    }
+
+    const double x = a * x1 + b * x2, y = a * y1 + b * y2, z = a * z1 + b * z2;
+    latOut = std::atan2(z, std::sqrt(x * x + y * y)) * kRadToDeg;
+    lonOut = std::atan2(y, x) * kRadToDeg;
+}
+
+void slerpScalar(const double* lat1, const double* lon1,
+                 const double* lat2, const double* lon2,
+                 const double* frac, double* latOut, double* lonOut, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+        slerpOne(lat1[i], lon1[i], lat2[i], lon2[i], frac[i], latOut[i], lonOut[i]);
+    }
+}
+
+void haversineScalar(const double* lat1, const double* lon1,
+                     const double* lat2, const double* lon2,
+                     double* out, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = haversineKm(lat1[i], lon1[i], lat2[i], lon2[i]);
+    }
+}
+
+void haversineFromScalar(double lat, double lon,
+                         const double* lat2, const double* lon2,
+                         double* out, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = haversineKm(lat, lon, lat2[i], lon2[i]);
+    }
+}
+
+#if OOP_GEO_X86
+
+// ---------- AVX2: sin/cos/atan поліномами (Cephes), 4 double за раз ----------
+// Стандартних векторних sin/asin немає, тож:
+//   sin, cos — зведення до [-pi/4, pi/4] за квадрантом + мінімакс-поліноми;
+//   asin(sqrt(a)) = atan(sqrt(a) / sqrt(1 - a)) — раціональна апроксимація atan.
+// Похибка — кілька ulp, на відстанях Землі це менше міліметра.
+
+// pi/2 = kPio2Hi + kPio2Lo: множення j * kPio2Hi точне для малих j
+constexpr double kPio2Hi = 1.57079632673412561417e+00;
+constexpr double kPio2Lo = 6.07710050650619224932e-11;
+constexpr double kTwoOverPi = 0.63661977236758134308;
+
+constexpr double kSinCoef[] = {
+     1.58962301576546568060e-10, -2.50507477628578072866e-8,
+     2.75573136213857245213e-6,  -1.98412698295895385996e-4,
+     8.33333333332211858878e-3,  -1.66666666666666307295e-1,
+};
+constexpr double kCosCoef[] = {
+    -1.13585365213876817300e-11,  2.08757008419747316778e-9,
+    -2.75573141792967388112e-7,   2.48015872888517045348e-5,
+    -1.38888888888730564116e-3,   4.16666666666665929218e-2,
+};
+
+constexpr double kAtanP[] = {
+    -8.750608600031904122785e-1, -1.615753718733365076637e1,
+    -7.500855792314704667340e1,  -1.228866684490136173410e2,
+    -6.485021904942025371773e1,
+};
+constexpr double kAtanQ[] = {   // старший коефіцієнт 1
+     2.485846490142306297962e1,   1.650270098316988542046e2,
+     4.328810604912902668951e2,   4.853903996359136964868e2,
+     1.945506571482613964425e2,
+};
+constexpr double kTan3Pi8 = 2.41421356237309504880;
+constexpr double kPio2 = 1.57079632679489661923;
+constexpr double kPio4 = 7.85398163397448309616e-1;
+constexpr double kMoreBits = 6.123233995736765886130e-17;
+
+template <std::size_t N>
+OOP_GEO_AVX2 inline __m256d polevl(__m256d z, const double (&c)[N]) {
+    __m256d p = _mm256_set1_pd(c[0]);
+    for (std::size_t k = 1; k < N; ++k) {
+        p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(c[k]));
+    }
+    return p;
+}
+
+// Старший коефіцієнт 1 (Cephes p1evl)
+template <std::size_t N>
+OOP_GEO_AVX2 inline __m256d p1evl(__m256d z, const double (&c)[N]) {
+    __m256d p = _mm256_add_pd(z, _mm256_set1_pd(c[0]));
+    for (std::size_t k = 1; k < N; ++k) {
+        p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(c[k]));
+    }
+    return p;
+}
+
+// sin і cos одного аргументу: зведення спільне, обидва поліноми поруч
+OOP_GEO_AVX2 inline void sinCosPd(__m256d x, __m256d& sinOut, __m256d& cosOut) {
+    const __m256d j = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(kTwoOverPi)),
+                                      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d r = _mm256_fnmadd_pd(j, _mm256_set1_pd(kPio2Hi), x);
+    r = _mm256_fnmadd_pd(j, _mm256_set1_pd(kPio2Lo), r);
+
+    // квадрант j mod 4 у {0, 1, 2, 3}
+    const __m256d q = _mm256_fnmadd_pd(
+        _mm256_floor_pd(_mm256_mul_pd(j, _mm256_set1_pd(0.25))), _mm256_set1_pd(4.0), j);
+
+    const __m256d z = _mm256_mul_pd(r, r);
+    const __m256d s = _mm256_fmadd_pd(_mm256_mul_pd(r, z), polevl(z, kSinCoef), r);
+    const __m256d c = _mm256_fmadd_pd(_mm256_mul_pd(z, z), polevl(z, kCosCoef),
+                                      _mm256_fnmadd_pd(_mm256_set1_pd(0.5), z, _mm256_set1_pd(1.0)));
+
+    const __m256d q1 = _mm256_cmp_pd(q, _mm256_set1_pd(1.0), _CMP_EQ_OQ);
+    const __m256d q2 = _mm256_cmp_pd(q, _mm256_set1_pd(2.0), _CMP_EQ_OQ);
+    const __m256d q3 = _mm256_cmp_pd(q, _mm256_set1_pd(3.0), _CMP_EQ_OQ);
+    const __m256d swap = _mm256_or_pd(q1, q3);
+    const __m256d signBit = _mm256_set1_pd(-0.0);
+
+    // sin: q0 s, q1 c, q2 -s, q3 -c;  cos: q0 c, q1 -s, q2 -c, q3 s
+    sinOut = _mm256_xor_pd(_mm256_blendv_pd(s, c, swap),
+                           _mm256_and_pd(_mm256_or_pd(q2, q3), signBit));
+    cosOut = _mm256_xor_pd(_mm256_blendv_pd(c, s, swap),
+                           _mm256_and_pd(_mm256_or_pd(q1, q2), signBit));
+}
+
+OOP_GEO_AVX2 inline __m256d atanPd(__m256d x) {
+    const __m256d signBit = _mm256_set1_pd(-0.0);
+    const __m256d sign = _mm256_and_pd(x, signBit);
+    const __m256d ax = _mm256_andnot_pd(signBit, x);
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    const __m256d big = _mm256_cmp_pd(ax, _mm256_set1_pd(kTan3Pi8), _CMP_GT_OQ);
+    const __m256d mid = _mm256_andnot_pd(big, _mm256_cmp_pd(ax, _mm256_set1_pd(0.66), _CMP_GT_OQ));
+
+    __m256d xr = _mm256_blendv_pd(ax, _mm256_div_pd(_mm256_sub_pd(ax, one), _mm256_add_pd(ax, one)), mid);
+    xr = _mm256_blendv_pd(xr, _mm256_div_pd(_mm256_set1_pd(-1.0), ax), big);
+
+    __m256d y = _mm256_and_pd(mid, _mm256_set1_pd(kPio4));
+    y = _mm256_blendv_pd(y, _mm256_set1_pd(kPio2), big);
+    __m256d more = _mm256_and_pd(mid, _mm256_set1_pd(0.5 * kMoreBits));
+    more = _mm256_blendv_pd(more, _mm256_set1_pd(kMoreBits), big);
+
+    const __m256d z = _mm256_mul_pd(xr, xr);
+    const __m256d t = _mm256_div_pd(_mm256_mul_pd(z, polevl(z, kAtanP)), p1evl(z, kAtanQ));
+    const __m256d res = _mm256_add_pd(y, _mm256_add_pd(_mm256_fmadd_pd(xr, t, xr), more));
+    return _mm256_xor_pd(res, sign);
+}
+
+// atan2 через atan(y / x) з поправкою квадранта; atan2(0, 0) = 0
+OOP_GEO_AVX2 inline __m256d atan2Pd(__m256d y, __m256d x) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d signBit = _mm256_set1_pd(-0.0);
+
+    __m256d r = atanPd(_mm256_div_pd(y, x));
+    const __m256d xNeg = _mm256_cmp_pd(x, zero, _CMP_LT_OQ);
+    const __m256d piSigned = _mm256_or_pd(_mm256_set1_pd(kPio2 * 2.0), _mm256_and_pd(y, signBit));
+    r = _mm256_add_pd(r, _mm256_and_pd(xNeg, piSigned));
+
+    const __m256d origin = _mm256_and_pd(_mm256_cmp_pd(x, zero, _CMP_EQ_OQ),
+                                         _mm256_cmp_pd(y, zero, _CMP_EQ_OQ));
+    return _mm256_blendv_pd(r, zero, origin);
+}
+
+OOP_GEO_AVX2 inline __m256d haversine4(__m256d lat1, __m256d lon1, __m256d lat2, __m256d lon2) {
+    const __m256d toRad = _mm256_set1_pd(kDegToRad);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    const __m256d p1 = _mm256_mul_pd(lat1, toRad);
+    const __m256d p2 = _mm256_mul_pd(lat2, toRad);
+    const __m256d hdlat = _mm256_mul_pd(_mm256_sub_pd(p2, p1), half);
+    const __m256d hdlon = _mm256_mul_pd(_mm256_mul_pd(_mm256_sub_pd(lon2, lon1), toRad), half);
+
+    __m256d sinP1, cosP1, sinP2, cosP2, sinLat, cosLat, sinLon, cosLon;
+    sinCosPd(p1, sinP1, cosP1);
+    sinCosPd(p2, sinP2, cosP2);
+    sinCosPd(hdlat, sinLat, cosLat);
+    sinCosPd(hdlon, sinLon, cosLon);
+
+    __m256d a = _mm256_fmadd_pd(_mm256_mul_pd(cosP1, cosP2), _mm256_mul_pd(sinLon, sinLon),
+                                _mm256_mul_pd(sinLat, sinLat));
+    a = _mm256_min_pd(a, one);
+
+    // 2 * asin(sqrt(a)) = 2 * atan(sqrt(a) / sqrt(1 - a)); a == 1 дає atan(inf) = pi/2
+    const __m256d c = atanPd(_mm256_div_pd(_mm256_sqrt_pd(a), _mm256_sqrt_pd(_mm256_sub_pd(one, a))));
+    return _mm256_mul_pd(c, _mm256_set1_pd(2.0 * kEarthRadiusKm));
+}
+
+OOP_GEO_AVX2 void haversineAvx2(const double* lat1, const double* lon1,
+                                const double* lat2, const double* lon2,
+                                double* out, std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, haversine4(_mm256_loadu_pd(lat1 + i), _mm256_loadu_pd(lon1 + i),
+                                             _mm256_loadu_pd(lat2 + i), _mm256_loadu_pd(lon2 + i)));
+    }
+    if (i == n) return;
+
+    // хвіст — тим самим ядром через буфер, щоб результат не залежав від позиції
+    alignas(32) double buf[4][4] = {};
+    const std::size_t rest = n - i;
+    std::memcpy(buf[0], lat1 + i, rest * sizeof(double));
+    std::memcpy(buf[1], lon1 + i, rest * sizeof(double));
+    std::memcpy(buf[2], lat2 + i, rest * sizeof(double));
+    std::memcpy(buf[3], lon2 + i, rest * sizeof(double));
+    alignas(32) double res[4];
+    _mm256_store_pd(res, haversine4(_mm256_load_pd(buf[0]), _mm256_load_pd(buf[1]),
+                                    _mm256_load_pd(buf[2]), _mm256_load_pd(buf[3])));
+    std::memcpy(out + i, res, rest * sizeof(double));
+}
+
+OOP_GEO_AVX2 void haversineFromAvx2(double lat, double lon,
+                                    const double* lat2, const double* lon2,
+                                    double* out, std::size_t n) noexcept {
+    const __m256d lat1 = _mm256_set1_pd(lat);
+    const __m256d lon1 = _mm256_set1_pd(lon);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, haversine4(lat1, lon1,
+                                             _mm256_loadu_pd(lat2 + i), _mm256_loadu_pd(lon2 + i)));
+    }
+    if (i == n) return;
+
+    alignas(32) double buf[2][4] = {};
+    const std::size_t rest = n - i;
+    std::memcpy(buf[0], lat2 + i, rest * sizeof(double));
+    std::memcpy(buf[1], lon2 + i, rest * sizeof(double));
+    alignas(32) double res[4];
+    _mm256_store_pd(res, haversine4(lat1, lon1, _mm256_load_pd(buf[0]), _mm256_load_pd(buf[1])));
+    std::memcpy(out + i, res, rest * sizeof(double));
+}
+
+OOP_GEO_AVX2 inline void slerp4(__m256d lat1, __m256d lon1, __m256d lat2, __m256d lon2, __m256d f,
+                                __m256d& latOut, __m256d& lonOut) {
+    const __m256d toRad = _mm256_set1_pd(kDegToRad);
+    const __m256d toDeg = _mm256_set1_pd(kRadToDeg);
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    __m256d sp1, cp1, sl1, cl1, sp2, cp2, sl2, cl2;
+    sinCosPd(_mm256_mul_pd(lat1, toRad), sp1, cp1);
+    sinCosPd(_mm256_mul_pd(lon1, toRad), sl1, cl1);
+    sinCosPd(_mm256_mul_pd(lat2, toRad), sp2, cp2);
+    sinCosPd(_mm256_mul_pd(lon2, toRad), sl2, cl2);
+
+    const __m256d x1 = _mm256_mul_pd(cp1, cl1), y1 = _mm256_mul_pd(cp1, sl1), z1 = sp1;
+    const __m256d x2 = _mm256_mul_pd(cp2, cl2), y2 = _mm256_mul_pd(cp2, sl2), z2 = sp2;
+
+    const __m256d cx = _mm256_fmsub_pd(y1, z2, _mm256_mul_pd(z1, y2));
+    const __m256d cy = _mm256_fmsub_pd(z1, x2, _mm256_mul_pd(x1, z2));
+    const __m256d cz = _mm256_fmsub_pd(x1, y2, _mm256_mul_pd(y1, x2));
+    const __m256d sinD = _mm256_sqrt_pd(_mm256_fmadd_pd(cx, cx, _mm256_fmadd_pd(cy, cy, _mm256_mul_pd(cz, cz))));
+    const __m256d dot = _mm256_fmadd_pd(x1, x2, _mm256_fmadd_pd(y1, y2, _mm256_mul_pd(z1, z2)));
+    const __m256d delta = atan2Pd(sinD, dot);
+
+    const __m256d g = _mm256_sub_pd(one, f);
+    __m256d sa, ca, sb, cb;
+    sinCosPd(_mm256_mul_pd(g, delta), sa, ca);
+    sinCosPd(_mm256_mul_pd(f, delta), sb, cb);
+
+    // коротка дуга — лінійні ваги (1 - f, f), інакше sin(...) / sin(delta)
+    const __m256d tiny = _mm256_cmp_pd(delta, _mm256_set1_pd(kSlerpMinAngle), _CMP_LE_OQ);
+    const __m256d safeSin = _mm256_blendv_pd(sinD, one, tiny);
+    const __m256d a = _mm256_blendv_pd(_mm256_div_pd(sa, safeSin), g, tiny);
+    const __m256d b = _mm256_blendv_pd(_mm256_div_pd(sb, safeSin), f, tiny);
+
+    const __m256d x = _mm256_fmadd_pd(a, x1, _mm256_mul_pd(b, x2));
+    const __m256d y = _mm256_fmadd_pd(a, y1, _mm256_mul_pd(b, y2));
+    const __m256d z = _mm256_fmadd_pd(a, z1, _mm256_mul_pd(b, z2));
+
+    const __m256d h = _mm256_sqrt_pd(_mm256_fmadd_pd(x, x, _mm256_mul_pd(y, y)));
+    latOut = _mm256_mul_pd(atan2Pd(z, h), toDeg);
+    lonOut = _mm256_mul_pd(atan2Pd(y, x), toDeg);
+}
+
+OOP_GEO_AVX2 void slerpAvx2(const double* lat1, const double* lon1,
+                            const double* lat2, const double* lon2,
+                            const double* frac, double* latOut, double* lonOut, std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d la, lo;
+        slerp4(_mm256_loadu_pd(lat1 + i), _mm256_loadu_pd(lon1 + i),
+               _mm256_loadu_pd(lat2 + i), _mm256_loadu_pd(lon2 + i),
+               _mm256_loadu_pd(frac + i), la, lo);
+        _mm256_storeu_pd(latOut + i, la);
+        _mm256_storeu_pd(lonOut + i, lo);
+    }
+    if (i == n) return;
+
+    alignas(32) double buf[5][4] = {};
+    const std::size_t rest = n - i;
+    std::memcpy(buf[0], lat1 + i, rest * sizeof(double));
+    std::memcpy(buf[1], lon1 + i, rest * sizeof(double));
+    std::memcpy(buf[2], lat2 + i, rest * sizeof(double));
+    std::memcpy(buf[3], lon2 + i, rest * sizeof(double));
+    std::memcpy(buf[4], frac + i, rest * sizeof(double));
+    __m256d la, lo;
+    slerp4(_mm256_load_pd(buf[0]), _mm256_load_pd(buf[1]), _mm256_load_pd(buf[2]),
+           _mm256_load_pd(buf[3]), _mm256_load_pd(buf[4]), la, lo);
+    alignas(32) double resLat[4], resLon[4];
+    _mm256_store_pd(resLat, la);
+    _mm256_store_pd(resLon, lo);
+    std::memcpy(latOut + i, resLat, rest * sizeof(double));
+    std::memcpy(lonOut + i, resLon, rest * sizeof(double));
+}
+
+#if defined(_MSC_VER) && !defined(__clang__)
+bool cpuHasAvx2Fma() noexcept {
+    int r[4];
+    __cpuid(r, 0);
+    if (r[0] < 7) return false;
+
+    __cpuid(r, 1);
+    const bool fma = (r[2] & (1 << 12)) != 0;
+    const bool osxsave = (r[2] & (1 << 27)) != 0;
+    const bool avx = (r[2] & (1 << 28)) != 0;
+    if (!fma || !osxsave || !avx) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;   // ОС зберігає YMM
+
+    __cpuidex(r, 7, 0);
+    return (r[1] & (1 << 5)) != 0;
+}
+#else
+bool cpuHasAvx2Fma() noexcept {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+#endif
+
+#endif // OOP_GEO_X86
+
+struct KernelChoice {
+    Kernel fn;
+    KernelFrom from;
+    KernelSlerp slerp;
+    const char* name;
+};
+
+KernelChoice selectKernel() noexcept {
+    const char* env = std::getenv("OOP_GEO_KERNEL");
+    const bool forceScalar = env && std::strcmp(env, "scalar") == 0;
+#if OOP_GEO_X86
+    if (!forceScalar && cpuHasAvx2Fma()) {
+        return {&haversineAvx2, &haversineFromAvx2, &slerpAvx2, "avx2"};
+    }
+#else
+    (void)forceScalar;
+#endif
+    return {&haversineScalar, &haversineFromScalar, &slerpScalar, "scalar"};
+}
+
+const KernelChoice& kernel() noexcept {
+    static const KernelChoice k = selectKernel();
+    return k;
+}
+
+} // namespace
+
+double haversineKm(double lat1, double lon1, double lat2, double lon2) noexcept {
+    const double p1 = lat1 * kDegToRad;
+    const double p2 = lat2 * kDegToRad;
+    const double sdlat = std::sin((p2 - p1) * 0.5);
+    const double sdlon = std::sin((lon2 - lon1) * kDegToRad * 0.5);
+
+    const double a = sdlat * sdlat + std::cos(p1) * std::cos(p2) * sdlon * sdlon;
+    return 2.0 * kEarthRadiusKm * std::asin(std::sqrt(std::min(a, 1.0)));
+}
+
+void haversineKm(const double* lat1, const double* lon1,
+                 const double* lat2, const double* lon2,
+                 double* out, std::size_t n) noexcept {
+    kernel().fn(lat1, lon1, lat2, lon2, out, n);
+}
+
+void haversineKm(double lat, double lon,
+                 const double* lat2, const double* lon2,
+                 double* out, std::size_t n) noexcept {
+    kernel().from(lat, lon, lat2, lon2, out, n);
+}
+
+void interpolateGreatCircle(const double* lat1, const double* lon1,
+                            const double* lat2, const double* lon2,
+                            const double* frac,
+                            double* latOut, double* lonOut, std::size_t n) noexcept {
+    kernel().slerp(lat1, lon1, lat2, lon2, frac, latOut, lonOut, n);
+}
+
+const char* kernelName() noexcept {
+    return kernel().name;
+}
+
+} // namespace geo
@@ -0,0 +1,283 @@
+﻿// src/geo/PortIndex.cpp
+#include "geo/PortIndex.h"
+#include "geo/Geo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <utility>
+
+namespace geo {
+
+namespace {
+
+// Скільки змін тримати поверх дерева до перебудови: хвіст перевіряється
+// лінійно в кожному запиті, перебудова — O(n log n) на кожну пачку
+constexpr std::size_t kMaxPending = 256;
+
+constexpr double kDegToRad = 3.14159265358979323846 / 180.0;
+constexpr double kPi = 3.14159265358979323846;
+
+struct Vec3 {
+    double v[3];
+};
+
+Vec3 toUnit(double latDeg, double lonDeg) noexcept {
+    const double lat = latDeg * kDegToRad;
+    const double lon = lonDeg * kDegToRad;
+    const double c = std::cos(lat);
+    return Vec3{{c * std::cos(lon), c * std::sin(lon), std::sin(lat)}};
+}
+
+double chord2(const Vec3& a, const Vec3& b) noexcept {
+    const double dx = a.v[0] - b.v[0];
+    const double dy = a.v[1] - b.v[1];
+    const double dz = a.v[2] - b.v[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Квадрат хорди для дуги radiusKm; >= 4 — уся сфера
+double chord2ForRadius(double radiusKm) noexcept {
+    const double theta = radiusKm / kEarthRadiusKm;
+    if (theta >= kPi) return 4.0;
+    const double c = 2.0 * std::sin(theta * 0.5);
+    return c * c;
+}
+
+} // namespace
+
+// Неявне збалансоване дерево: вузол діапазону [lo, hi) лежить у mid = (lo + hi) / 2,
+// ліве піддерево — [lo, mid), праве — [mid + 1, hi). Без вказівників.
+struct PortIndex::Tree {
+    struct Node {
+        Vec3 p;
+        std::uint32_t port;     // індекс у ports
+        std::uint8_t axis;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<Port> ports;
+
+    void build(std::size_t lo, std::size_t hi) {
+        if (hi - lo <= 1) {
+            if (hi > lo) nodes[lo].axis = 0;
+            return;
+        }
+
+        // вісь найбільшого розкиду
+        double mn[3] = {2, 2, 2};
+        double mx[3] = {-2, -2, -2};
+        for (std::size_t i = lo; i < hi; ++i) {
+            for (int a = 0; a < 3; ++a) {
+                mn[a] = std::min(mn[a], nodes[i].p.v[a]);
+                mx[a] = std::max(mx[a], nodes[i].p.v[a]);
+            }
+        }
+        std::uint8_t axis = 0;
+        for (std::uint8_t a = 1; a < 3; ++a) {
+            if (mx[a] - mn[a] > mx[axis] - mn[axis]) axis = a;
+        }
+
+        const std::size_t mid = lo + (hi - lo) / 2;
+        std::nth_element(nodes.begin() + lo, nodes.begin() + mid, nodes.begin() + hi,
+                         [axis](const Node& a, const Node& b) { return a.p.v[axis] < b.p.v[axis]; });
+        nodes[mid].axis = axis;
+
+        build(lo, mid);
+        build(mid + 1, hi);
+    }
+
+    using Best = std::pair<double, std::uint32_t>;   // (хорда², індекс порту)
+
+    // hidden — id, чиї вузли застаріли (порт змінено або видалено)
+    using Hidden = std::unordered_set<std::int64_t>;
+
+    void nearest(std::size_t lo, std::size_t hi, const Vec3& q, std::size_t k,
+                 const Hidden& hidden, std::priority_queue<Best>& best) const {
+        if (lo >= hi) return;
+        const std::size_t mid = lo + (hi - lo) / 2;
+        const Node& n = nodes[mid];
+
+        if (hidden.empty() || !hidden.count(ports[n.port].id)) {
+            const double d2 = chord2(q, n.p);
+            if (best.size() < k) {
+                best.emplace(d2, n.port);
+            } else if (d2 < best.top().first) {
+                best.pop();
+                best.emplace(d2, n.port);
+            }
+        }
+
+        const double diff = q.v[n.axis] - n.p.v[n.axis];
+        const bool leftFirst = diff < 0;
+        nearest(leftFirst ? lo : mid + 1, leftFirst ? mid : hi, q, k, hidden, best);
+        if (best.size() < k || diff * diff < best.top().first) {
+            nearest(leftFirst ? mid + 1 : lo, leftFirst ? hi : mid, q, k, hidden, best);
+        }
+    }
+
+    void within(std::size_t lo, std::size_t hi, const Vec3& q, double r2,
+                const Hidden& hidden, std::vector<Best>& out) const {
+        if (lo >= hi) return;
+        const std::size_t mid = lo + (hi - lo) / 2;
+        const Node& n = nodes[mid];
+
+        const double d2 = chord2(q, n.p);
+        if (d2 <= r2 && (hidden.empty() || !hidden.count(ports[n.port].id))) {
+            out.emplace_back(d2, n.port);
+        }
+
+        const double diff = q.v[n.axis] - n.p.v[n.axis];
+        if (diff < 0 || diff * diff <= r2) within(lo, mid, q, r2, hidden, out);
+        if (diff >= 0 || diff * diff <= r2) within(mid + 1, hi, q, r2, hidden, out);
+    }
+};
+
+// Те, що бачать запити: дерево + хвіст змін після його побудови
+struct PortIndex::Snapshot {
+    std::shared_ptr<const Tree> tree;
+    Tree::Hidden hidden;        // вузли дерева, які пропускаємо
+    std::vector<Port> extra;    // актуальні версії змінених портів
+    std::size_t size{0};
+};
+
+PortIndex& PortIndex::instance() {
+    static PortIndex idx;
+    return idx;
+}
+
+std::shared_ptr<const PortIndex::Snapshot> PortIndex::snapshot() const {
+    std::lock_guard<std::mutex> lock(snapMu_);
+    return snap_;
+}
+
+void PortIndex::rebuildLocked() {
+    auto t = std::make_shared<Tree>();
+    t->ports.reserve(ports_.size());
+    for (const auto& [id, p] : ports_) t->ports.push_back(p);
+
+    t->nodes.resize(t->ports.size());
+    for (std::size_t i = 0; i < t->ports.size(); ++i) {
+        t->nodes[i] = Tree::Node{toUnit(t->ports[i].lat, t->ports[i].lon),
+                                 static_cast<std::uint32_t>(i), 0};
+    }
+    t->build(0, t->nodes.size());
+
+    tree_ = std::move(t);
+    pending_.clear();
+    publishLocked();
+}
+
+// Новий знімок: дерево спільне, копіюється лише хвіст (<= kMaxPending)
+void PortIndex::publishLocked() {
+    auto s = std::make_shared<Snapshot>();
+    s->tree = tree_;
+    s->hidden = pending_;
+    s->extra.reserve(pending_.size());
+    for (const std::int64_t id : pending_) {
+        if (const auto it = ports_.find(id); it != ports_.end()) s->extra.push_back(it->second);
+    }
+    s->size = ports_.size();
+
+    std::lock_guard<std::mutex> lock(snapMu_);
+    snap_ = std::move(s);
+}
+
+void PortIndex::build(const std::vector<Port>& ports) {
+    std::lock_guard<std::mutex> lock(writeMu_);
+    ports_.clear();
+    ports_.reserve(ports.size());
+    for (const auto& p : ports) ports_[p.id] = p;
+    rebuildLocked();
+}
+
+void PortIndex::upsert(const Port& p) {
+    std::lock_guard<std::mutex> lock(writeMu_);
+    if (const auto it = ports_.find(p.id); it != ports_.end()) {
+        const Port& cur = it->second;
+        // нічого, що видно в результатах, не змінилось
+        if (cur.lat == p.lat && cur.lon == p.lon &&
+            cur.name == p.name && cur.region == p.region) {
+            return;
+        }
+    }
+    ports_[p.id] = p;
+    pending_.insert(p.id);
+    if (pending_.size() > kMaxPending) rebuildLocked(); else publishLocked();
+}
+
+void PortIndex::remove(std::int64_t portId) {
+    std::lock_guard<std::mutex> lock(writeMu_);
+    if (ports_.erase(portId) == 0) return;
+    pending_.insert(portId);
+    if (pending_.size() > kMaxPending) rebuildLocked(); else publishLocked();
+}
+
+std::size_t PortIndex::size() const {
+    const auto s = snapshot();
+    return s ? s->size : 0;
+}
+
+namespace {
+
+// Кандидат: (хорда², порт); Port живе у знімку, який тримає викликач
+using Candidate = std::pair<double, const Port*>;
+
+std::vector<PortIndex::Hit> toHits(std::vector<Candidate>& best, double lat, double lon) {
+    std::sort(best.begin(), best.end(),
+              [](const Candidate& a, const Candidate& b) { return a.first < b.first; });
+    std::vector<PortIndex::Hit> out;
+    out.reserve(best.size());
+    for (const auto& [d2, p] : best) {
+        out.push_back(PortIndex::Hit{*p, haversineKm(lat, lon, p->lat, p->lon)});
+    }
+    return out;
+}
+
+} // namespace
+
+std::vector<PortIndex::Hit> PortIndex::nearest(double lat, double lon, std::size_t k) const {
+    const auto s = snapshot();
+    if (!s || k == 0 || s->size == 0) return {};
+
+    const Vec3 q = toUnit(lat, lon);
+    std::priority_queue<Tree::Best> heap;
+    s->tree->nearest(0, s->tree->nodes.size(), q, k, s->hidden, heap);
+
+    std::vector<Candidate> best;
+    best.reserve(heap.size() + s->extra.size());
+    while (!heap.empty()) {
+        best.emplace_back(heap.top().first, &s->tree->ports[heap.top().second]);
+        heap.pop();
+    }
+    for (const auto& p : s->extra) {
+        best.emplace_back(chord2(q, toUnit(p.lat, p.lon)), &p);
+    }
+    if (best.size() > k) {
+        std::partial_sort(best.begin(), best.begin() + k, best.end(),
+                          [](const Candidate& a, const Candidate& b) { return a.first < b.first; });
+        best.resize(k);
+    }
+    return toHits(best, lat, lon);
+}
+
+std::vector<PortIndex::Hit> PortIndex::within(double lat, double lon, double radiusKm) const {
+    const auto s = snapshot();
+    if (!s || !(radiusKm >= 0.0) || s->size == 0) return {};
+
+    const Vec3 q = toUnit(lat, lon);
+    const double r2 = chord2ForRadius(radiusKm);
+    std::vector<Tree::Best> found;
+    s->tree->within(0, s->tree->nodes.size(), q, r2, s->hidden, found);
+
+    std::vector<Candidate> best;
+    best.reserve(found.size() + s->extra.size());
+    for (const auto& [d2, i] : found) best.emplace_back(d2, &s->tree->ports[i]);
+    for (const auto& p : s->extra) {
+        const double d2 = chord2(q, toUnit(p.lat, p.lon));
+        if (d2 <= r2) best.emplace_back(d2, &p);
+    }
+    return toHits(best, lat, lon);
+}
+
+} // namespace geo
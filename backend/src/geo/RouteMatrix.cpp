@@ -0,0 +1,488 @@
+﻿// src/geo/RouteMatrix.cpp
+#include "geo/RouteMatrix.h"
+#include "util/Time.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace geo {
+
+namespace {
+
+constexpr char kMagic[8] = {'O', 'O', 'P', 'R', 'M', 'X', '0', '1'};
+constexpr std::uint32_t kFormatVersion = 1;
+
+// Джерел за одне звернення до спільного лічильника
+constexpr std::size_t kSourcesPerClaim = 8;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t headerBytes;
+    std::uint64_t ports;
+    std::uint64_t fingerprint;
+    std::int64_t computedAtMs;
+    double computeMs;
+    std::uint64_t reserved[2];
+};
+static_assert(sizeof(FileHeader) == 64, "route matrix header must stay 64 bytes");
+
+std::size_t fileBytes(std::size_t n) {
+    return sizeof(FileHeader) + n * sizeof(std::int64_t) + n * n * sizeof(float);
+}
+
+// Текст останньої системної помилки (errno / GetLastError)
+std::string lastSysError() {
+#ifdef _WIN32
+    return "error " + std::to_string(::GetLastError());
+#else
+    return std::strerror(errno);
+#endif
+}
+
+[[noreturn]] void throwSys(const std::string& what, const std::string& path, const std::string& err) {
+    throw std::runtime_error("RouteMatrix: " + what + " '" + path + "': " + err);
+}
+
+#ifdef _WIN32
+std::wstring widen(const std::string& s) {
+    if (s.empty()) return {};
+    const int n = ::MultiByteToWideChar(CP_UTF8, 0, s.data(), static_cast<int>(s.size()), nullptr, 0);
+    std::wstring w(static_cast<std::size_t>(n), L'\0');
+    ::MultiByteToWideChar(CP_UTF8, 0, s.data(), static_cast<int>(s.size()), w.data(), n);
+    return w;
+}
+#endif
+
+// Файл, відображений у пам'ять (mmap / MapViewOfFile).
+// Дескриптори закриваються одразу після відображення — view тримає файл сам;
+// для запису (writable) файл лишається відкритим до flush().
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    // Створити (обрізати) path розміром bytes і відобразити для запису
+    bool create(const std::string& path, std::size_t bytes);
+    // Відобразити весь наявний файл лише для читання
+    bool open(const std::string& path);
+    // Скинути зміни на диск (лише після create)
+    bool flush();
+    void close() noexcept;
+
+    void* data() const noexcept { return base_; }
+    std::size_t size() const noexcept { return bytes_; }
+    const std::string& error() const noexcept { return error_; }
+
+private:
+    bool fail() {
+        error_ = lastSysError();
+        close();
+        return false;
+    }
+
+    void* base_{nullptr};
+    std::size_t bytes_{0};
+    std::string error_;
+#ifdef _WIN32
+    HANDLE file_{INVALID_HANDLE_VALUE};
+#else
+    int fd_{-1};
+#endif
+};
+
+#ifdef _WIN32
+
+bool MappedFile::create(const std::string& path, std::size_t bytes) {
+    close();
+    file_ = ::CreateFileW(widen(path).c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                          CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) return fail();
+
+    // CreateFileMapping з розміром сама розширює файл
+    const auto size = static_cast<std::uint64_t>(bytes);
+    HANDLE mapping = ::CreateFileMappingW(file_, nullptr, PAGE_READWRITE,
+                                          static_cast<DWORD>(size >> 32),
+                                          static_cast<DWORD>(size & 0xffffffffu), nullptr);
+    if (!mapping) return fail();
+    base_ = ::MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, bytes);
+    ::CloseHandle(mapping);
+    if (!base_) return fail();
+    bytes_ = bytes;
+    return true;
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    // FILE_SHARE_DELETE — щоб наступний rebuild міг замінити файл
+    HANDLE file = ::CreateFileW(widen(path).c_str(), GENERIC_READ,
+                                FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return fail();
+
+    LARGE_INTEGER size{};
+    if (!::GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        ::CloseHandle(file);
+        return fail();
+    }
+    HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    ::CloseHandle(file);
+    if (!mapping) return fail();
+    base_ = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    ::CloseHandle(mapping);
+    if (!base_) return fail();
+    bytes_ = static_cast<std::size_t>(size.QuadPart);
+    return true;
+}
+
+bool MappedFile::flush() {
+    if (!::FlushViewOfFile(base_, bytes_) || !::FlushFileBuffers(file_)) {
+        error_ = lastSysError();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close() noexcept {
+    if (base_) ::UnmapViewOfFile(base_);
+    if (file_ != INVALID_HANDLE_VALUE) ::CloseHandle(file_);
+    base_ = nullptr;
+    bytes_ = 0;
+    file_ = INVALID_HANDLE_VALUE;
+}
+
+// Windows не замінює файл з відкритим view: поточну матрицю вже відпущено,
+// але читач ще може тримати її копію — кілька коротких повторів
+bool replaceFile(const std::string& from, const std::string& to) {
+    const std::wstring wfrom = widen(from);
+    const std::wstring wto = widen(to);
+    for (int attempt = 0; attempt < 20; ++attempt) {
+        if (::MoveFileExW(wfrom.c_str(), wto.c_str(), MOVEFILE_REPLACE_EXISTING)) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return false;
+}
+
+#else
+
+bool MappedFile::create(const std::string& path, std::size_t bytes) {
+    close();
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) return fail();
+    if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0) return fail();
+    void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base == MAP_FAILED) return fail();
+    base_ = base;
+    bytes_ = bytes;
+    return true;
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return fail();
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return fail();
+    }
+    const auto bytes = static_cast<std::size_t>(st.st_size);
+    void* base = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) return fail();
+    base_ = base;
+    bytes_ = bytes;
+    return true;
+}
+
+bool MappedFile::flush() {
+    if (::msync(base_, bytes_, MS_SYNC) != 0) {
+        error_ = lastSysError();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close() noexcept {
+    if (base_) ::munmap(base_, bytes_);
+    if (fd_ >= 0) ::close(fd_);
+    base_ = nullptr;
+    bytes_ = 0;
+    fd_ = -1;
+}
+
+bool replaceFile(const std::string& from, const std::string& to) {
+    return std::rename(from.c_str(), to.c_str()) == 0;
+}
+
+#endif
+
+// Dijkstra з одного джерела в рядок out (n float).
+// Індексована 4-арна купа з decrease-key: вузол у купі не більше одного разу,
+// тож купа не росте на щільних ребрах, а неглибоке дерево дешевше просіювати.
+struct Dijkstra {
+    static constexpr std::uint32_t kNotQueued = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t kDone = kNotQueued - 1;
+
+    std::vector<double> dist;
+    std::vector<std::uint32_t> heap;   // вузли, ключ — dist
+    std::vector<std::uint32_t> pos;    // позиція вузла в heap, kNotQueued або kDone
+
+    void siftUp(std::size_t i) {
+        const std::uint32_t v = heap[i];
+        const double key = dist[v];
+        while (i > 0) {
+            const std::size_t parent = (i - 1) / 4;
+            const std::uint32_t p = heap[parent];
+            if (dist[p] <= key) break;
+            heap[i] = p;
+            pos[p] = static_cast<std::uint32_t>(i);
+            i = parent;
+        }
+        heap[i] = v;
+        pos[v] = static_cast<std::uint32_t>(i);
+    }
+
+    void siftDown(std::size_t i) {
+        const std::size_t n = heap.size();
+        const std::uint32_t v = heap[i];
+        const double key = dist[v];
+        for (;;) {
+            const std::size_t first = 4 * i + 1;
+            if (first >= n) break;
+            std::size_t best = first;
+            const std::size_t last = std::min(first + 4, n);
+            for (std::size_t c = first + 1; c < last; ++c) {
+                if (dist[heap[c]] < dist[heap[best]]) best = c;
+            }
+            if (dist[heap[best]] >= key) break;
+            heap[i] = heap[best];
+            pos[heap[i]] = static_cast<std::uint32_t>(i);
+            i = best;
+        }
+        heap[i] = v;
+        pos[v] = static_cast<std::uint32_t>(i);
+    }
+
+    void run(const RouteGraph& g, std::uint32_t src, float* out) {
+        const std::size_t n = g.size();
+        dist.assign(n, std::numeric_limits<double>::infinity());
+        pos.assign(n, kNotQueued);
+        heap.clear();
+
+        dist[src] = 0.0;
+        heap.push_back(src);
+        pos[src] = 0;
+        while (!heap.empty()) {
+            const std::uint32_t u = heap.front();
+            pos[u] = kDone;
+            heap.front() = heap.back();
+            heap.pop_back();
+            if (!heap.empty()) siftDown(0);
+
+            const double d = dist[u];
+            for (std::uint32_t e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+                const std::uint32_t v = g.targets[e];
+                const double nd = d + g.weights[e];
+                if (nd >= dist[v]) continue;   // і для kDone: їхня dist остаточна
+                dist[v] = nd;
+                if (pos[v] == kNotQueued) {
+                    heap.push_back(v);
+                    siftUp(heap.size() - 1);
+                } else {
+                    siftUp(pos[v]);
+                }
+            }
+        }
+
+        for (std::size_t i = 0; i < n; ++i) out[i] = static_cast<float>(dist[i]);
+    }
+};
+
+} // namespace
+
+struct RouteMatrix::Mapping {
+    MappedFile file;
+    const FileHeader* header{nullptr};
+    const std::int64_t* ids{nullptr};
+    const float* dist{nullptr};
+    std::unordered_map<std::int64_t, std::size_t> slotOf;
+
+    std::size_t size() const noexcept { return static_cast<std::size_t>(header->ports); }
+};
+
+RouteMatrix& RouteMatrix::instance() {
+    static RouteMatrix m;
+    return m;
+}
+
+void RouteMatrix::compute(const RouteGraph& g, float* out, unsigned threads) {
+    const std::size_t n = g.size();
+    if (n == 0) return;
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t workers = std::clamp<std::size_t>(n / kSourcesPerClaim, 1, threads);
+
+    // динамічний розподіл: джерела різні за вартістю (компоненти графа,
+    // щільність), тож потік бере наступну порцію, щойно звільнився
+    std::atomic<std::size_t> next{0};
+    auto work = [&] {
+        Dijkstra d;
+        for (;;) {
+            const std::size_t first = next.fetch_add(kSourcesPerClaim, std::memory_order_relaxed);
+            if (first >= n) return;
+            const std::size_t last = std::min(n, first + kSourcesPerClaim);
+            for (std::size_t s = first; s < last; ++s) {
+                d.run(g, static_cast<std::uint32_t>(s), out + s * n);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (std::size_t w = 1; w < workers; ++w) pool.emplace_back(work);
+    work();
+    for (auto& t : pool) t.join();
+}
+
+void RouteMatrix::rebuild(const RouteGraph& g, const std::string& path, unsigned threads) {
+    const std::size_t n = g.size();
+    const std::size_t bytes = fileBytes(n);
+    const std::string tmp = path + ".tmp";
+
+    MappedFile out;
+    if (!out.create(tmp, bytes)) throwSys("cannot create", tmp, out.error());
+
+    auto* header = static_cast<FileHeader*>(out.data());
+    auto* ids = reinterpret_cast<std::int64_t*>(header + 1);
+    auto* dist = reinterpret_cast<float*>(ids + n);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; ++i) ids[i] = g.ports[i].id;
+    compute(g, dist, threads);
+    const double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - t0).count();
+
+    // заголовок останнім: файл без magic не відкриється
+    FileHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kFormatVersion;
+    h.headerBytes = sizeof(FileHeader);
+    h.ports = n;
+    h.fingerprint = g.fingerprint;
+    h.computedAtMs = util::nowMs();
+    h.computeMs = ms;
+    *header = h;
+
+    if (!out.flush()) throwSys("cannot flush", tmp, out.error());
+    out.close();
+
+#ifdef _WIN32
+    // відображений файл на Windows не замінити — відпускаємо свою копію
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        map_.reset();
+    }
+#endif
+    if (!replaceFile(tmp, path)) throwSys("cannot replace", path, lastSysError());
+
+    if (!load(path, g.fingerprint)) {
+        throw std::runtime_error("RouteMatrix: freshly written '" + path + "' failed to load");
+    }
+}
+
+bool RouteMatrix::load(const std::string& path, std::uint64_t fingerprint) {
+    auto m = std::make_shared<Mapping>();
+    if (!m->file.open(path) || m->file.size() < sizeof(FileHeader)) return false;
+
+    m->header = static_cast<const FileHeader*>(m->file.data());
+    const FileHeader& h = *m->header;
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 ||
+        h.version != kFormatVersion ||
+        h.headerBytes != sizeof(FileHeader) ||
+        h.fingerprint != fingerprint ||
+        fileBytes(static_cast<std::size_t>(h.ports)) != m->file.size()) {
+        return false;
+    }
+
+    const std::size_t n = m->size();
+    m->ids = reinterpret_cast<const std::int64_t*>(m->header + 1);
+    m->dist = reinterpret_cast<const float*>(m->ids + n);
+    m->slotOf.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) m->slotOf[m->ids[i]] = i;
+
+    std::lock_guard<std::mutex> lock(mu_);
+    map_ = std::move(m);
+    return true;
+}
+
+std::shared_ptr<const RouteMatrix::Mapping> RouteMatrix::current() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return map_;
+}
+
+std::optional<double> RouteMatrix::routeKm(std::int64_t from, std::int64_t to) const {
+    const auto m = current();
+    if (!m) return std::nullopt;
+    const auto a = m->slotOf.find(from);
+    const auto b = m->slotOf.find(to);
+    if (a == m->slotOf.end() || b == m->slotOf.end()) return std::nullopt;
+    return m->dist[a->second * m->size() + b->second];
+}
+
+bool RouteMatrix::row(std::int64_t portId, std::vector<Entry>& out) const {
+    out.clear();
+    const auto m = current();
+    if (!m) return false;
+    const auto it = m->slotOf.find(portId);
+    if (it == m->slotOf.end()) return false;
+
+    const std::size_t n = m->size();
+    const float* r = m->dist + it->second * n;
+    out.reserve(n);
+    for (std::size_t j = 0; j < n; ++j) {
+        out.push_back(Entry{m->ids[j], r[j]});
+    }
+    return true;
+}
+
+RouteMatrix::Info RouteMatrix::info() const {
+    Info i;
+    const auto m = current();
+    if (!m) return i;
+    i.loaded = true;
+    i.ports = m->size();
+    i.fingerprint = m->header->fingerprint;
+    i.computedAtMs = m->header->computedAtMs;
+    i.computeMs = m->header->computeMs;
+    return i;
+}
+
+} // namespace geo
@@ -0,0 +1,274 @@
+﻿// src/geo/RoutePlanner.cpp
+#include "geo/RoutePlanner.h"
+#include "geo/Geo.h"
+#include "geo/PortIndex.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace geo {
+
+namespace {
+
+// FNV-1a: відбиток графа, щоб знати, чи збережена матриця ще про нього
+struct Fnv1a {
+    std::uint64_t h{1469598103934665603ull};
+
+    template <typename T>
+    void add(const T* data, std::size_t n) {
+        const auto* b = reinterpret_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < n * sizeof(T); ++i) {
+            h = (h ^ b[i]) * 1099511628211ull;
+        }
+    }
+};
+
+// Робочі масиви A* на потік: stamp замість очищення O(ports) на кожен запит
+struct SearchScratch {
+    std::vector<double> g;
+    std::vector<std::uint32_t> parent;
+    std::vector<std::uint32_t> seen;     // == gen — g/parent дійсні в цьому пошуку
+    std::vector<std::uint32_t> closed;   // == gen — вузол остаточний
+    std::uint32_t gen{0};
+
+    void begin(std::size_t n) {
+        if (seen.size() != n || gen == std::numeric_limits<std::uint32_t>::max()) {
+            g.assign(n, 0.0);
+            parent.assign(n, 0);
+            seen.assign(n, 0);
+            closed.assign(n, 0);
+            gen = 0;
+        }
+        ++gen;
+    }
+};
+
+} // namespace
+
+std::size_t RoutePlanner::KeyHash::operator()(const Key& k) const noexcept {
+    const std::hash<std::int64_t> h;
+    return h(k.first) * 1000003u ^ h(k.second);
+}
+
+RoutePlanner& RoutePlanner::instance() {
+    static RoutePlanner p;
+    return p;
+}
+
+void RoutePlanner::configure(const RouteOptions& opts) {
+    std::lock_guard<std::mutex> lock(mu_);
+    opts_ = opts;
+}
+
+RouteOptions RoutePlanner::options() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return opts_;
+}
+
+std::shared_ptr<const RouteGraph> buildRouteGraph(
+    const std::vector<Port>& ports,
+    const std::vector<std::pair<std::int64_t, std::int64_t>>& lanes,
+    const RouteOptions& opts) {
+    auto g = std::make_shared<RouteGraph>();
+    g->ports = ports;
+    const std::size_t n = ports.size();
+    g->nodeOf.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        g->nodeOf[ports[i].id] = static_cast<std::uint32_t>(i);
+    }
+
+    // неорієнтовані ребра як пари (u, v) в обидва боки
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+
+    if (opts.maxLegKm > 0.0 && opts.maxNeighbors > 0) {
+        PortIndex index;   // локальний, не спільний PortIndex::instance()
+        index.build(ports);
+        for (std::size_t i = 0; i < n; ++i) {
+            // +1: найближчий — сам порт
+            for (const auto& hit : index.nearest(ports[i].lat, ports[i].lon, opts.maxNeighbors + 1)) {
+                if (hit.distanceKm > opts.maxLegKm) break;
+                const std::uint32_t j = g->nodeOf.at(hit.port.id);
+                if (j == i) continue;
+                edges.emplace_back(static_cast<std::uint32_t>(i), j);
+                edges.emplace_back(j, static_cast<std::uint32_t>(i));
+            }
+        }
+    }
+
+    for (const auto& [from, to] : lanes) {
+        const auto a = g->nodeOf.find(from);
+        const auto b = g->nodeOf.find(to);
+        if (a == g->nodeOf.end() || b == g->nodeOf.end() || a->second == b->second) continue;
+        edges.emplace_back(a->second, b->second);
+        edges.emplace_back(b->second, a->second);
+    }
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    g->offsets.assign(n + 1, 0);
+    g->targets.reserve(edges.size());
+    g->weights.reserve(edges.size());
+    for (const auto& [u, v] : edges) {
+        ++g->offsets[u + 1];
+        g->targets.push_back(v);
+        g->weights.push_back(haversineKm(ports[u].lat, ports[u].lon, ports[v].lat, ports[v].lon));
+    }
+    for (std::size_t i = 0; i < n; ++i) g->offsets[i + 1] += g->offsets[i];
+
+    Fnv1a fp;
+    for (const auto& p : ports) {
+        fp.add(&p.id, 1);
+        fp.add(&p.lat, 1);
+        fp.add(&p.lon, 1);
+    }
+    fp.add(g->offsets.data(), g->offsets.size());
+    fp.add(g->targets.data(), g->targets.size());
+    g->fingerprint = fp.h;
+    return g;
+}
+
+void RoutePlanner::build(const std::vector<Port>& ports,
+                         const std::vector<std::pair<std::int64_t, std::int64_t>>& lanes) {
+    auto g = buildRouteGraph(ports, lanes, options());
+
+    std::lock_guard<std::mutex> lock(mu_);
+    graph_ = std::move(g);
+    ++version_;
+    lru_.clear();
+    index_.clear();
+}
+
+std::shared_ptr<const RouteGraph> RoutePlanner::graph() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return graph_;
+}
+
+std::shared_ptr<const RouteGraph> RoutePlanner::snapshot(std::uint64_t& version) const {
+    std::lock_guard<std::mutex> lock(mu_);
+    version = version_;
+    return graph_;
+}
+
+std::shared_ptr<const Route> RoutePlanner::lookup(const Key& key) {
+    std::lock_guard<std::mutex> lock(mu_);
+    const auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++misses_;
+        return nullptr;
+    }
+    ++hits_;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->route;
+}
+
+void RoutePlanner::remember(const Key& key, std::shared_ptr<const Route> route, std::uint64_t version) {
+    std::lock_guard<std::mutex> lock(mu_);
+    // граф перебудували, поки рахували, — маршрут уже не з поточного графа
+    if (version != version_ || opts_.cacheSize == 0) return;
+
+    if (const auto it = index_.find(key); it != index_.end()) {
+        it->second->route = std::move(route);
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return;
+    }
+
+    lru_.push_front(CacheEntry{key, std::move(route)});
+    index_[key] = lru_.begin();
+    while (lru_.size() > opts_.cacheSize) {
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+    }
+}
+
+std::shared_ptr<const Route> RoutePlanner::plan(std::int64_t from, std::int64_t to, bool* cached) {
+    if (cached) *cached = false;
+
+    std::uint64_t version = 0;
+    const auto g = snapshot(version);
+    if (!g) return nullptr;
+
+    const auto a = g->nodeOf.find(from);
+    const auto b = g->nodeOf.find(to);
+    if (a == g->nodeOf.end() || b == g->nodeOf.end()) return nullptr;
+
+    const Key key{from, to};
+    if (auto hit = lookup(key)) {
+        if (cached) *cached = true;
+        return hit;
+    }
+
+    const std::uint32_t start = a->second;
+    const std::uint32_t goal = b->second;
+    const Port& target = g->ports[goal];
+    auto h = [&](std::uint32_t u) {
+        return haversineKm(g->ports[u].lat, g->ports[u].lon, target.lat, target.lon);
+    };
+
+    thread_local SearchScratch s;
+    s.begin(g->ports.size());
+
+    using Open = std::pair<double, std::uint32_t>;   // (g + h, вузол)
+    std::priority_queue<Open, std::vector<Open>, std::greater<>> open;
+
+    s.g[start] = 0.0;
+    s.parent[start] = start;
+    s.seen[start] = s.gen;
+    open.emplace(h(start), start);
+
+    bool found = false;
+    while (!open.empty()) {
+        const std::uint32_t u = open.top().second;
+        open.pop();
+        if (s.closed[u] == s.gen) continue;   // застарілий запис черги
+        s.closed[u] = s.gen;
+        if (u == goal) {
+            found = true;
+            break;
+        }
+
+        for (std::uint32_t e = g->offsets[u]; e < g->offsets[u + 1]; ++e) {
+            const std::uint32_t v = g->targets[e];
+            if (s.closed[v] == s.gen) continue;
+            const double ng = s.g[u] + g->weights[e];
+            if (s.seen[v] != s.gen || ng < s.g[v]) {
+                s.seen[v] = s.gen;
+                s.g[v] = ng;
+                s.parent[v] = u;
+                open.emplace(ng + h(v), v);
+            }
+        }
+    }
+
+    auto route = std::make_shared<Route>();
+    if (found) {
+        route->found = true;
+        route->distanceKm = s.g[goal];
+        for (std::uint32_t u = goal;; u = s.parent[u]) {
+            route->ports.push_back(g->ports[u]);
+            if (u == start) break;
+        }
+        std::reverse(route->ports.begin(), route->ports.end());
+    }
+
+    std::shared_ptr<const Route> out = std::move(route);
+    remember(key, out, version);
+    return out;
+}
+
+RoutePlanner::Stats RoutePlanner::stats() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    Stats st;
+    if (graph_) {
+        st.ports = graph_->ports.size();
+        st.edges = graph_->targets.size();
+    }
+    st.cached = lru_.size();
+    st.hits = hits_;
+    st.misses = misses_;
+    return st;
+}
+
+} // namespace geo
@@ -1,13 +1,61 @@
 ﻿#include <drogon/drogon.h>
 #include <json/json.h>
 #include "db/Db.h"
+#include "db/Backup.h"
+#include "geo/DistanceMatrix.h"
+#include "geo/Geo.h"
+#include "geo/PortIndex.h"
+#include "geo/RoutePlanner.h"
+#include "repos/PortsRepo.h"
+#include "services/ArrivalScheduler.h"
+#include "services/RouteMatrixJob.h"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
+#include <string>
+#include <vector>
 
-// Forward declaration for auto-arrival timer
-void setupAutoArrivalTimer();
+// Forward declaration: режим запису аудиту з config.json / оточення
+AuditLogOptions auditLogOptionsFromConfig(const Json::Value& custom);
 
-int main() {
+// Forward declaration: параметри сховища з config.json / оточення
+DbOptions dbOptionsFromConfig(const Json::Value& custom);
+
+// Forward declaration: параметри графа маршрутів з config.json
+geo::RouteOptions routeOptionsFromConfig(const Json::Value& custom);
+
+// Forward declaration: файл матриці маршрутів (custom_config.routes.matrix_path)
+std::string routeMatrixPath(const Json::Value& custom);
+
+// Forward declaration: режим CLI "--backup <dest>"
+int runBackupCli(const std::string& dest);
+
+int main(int argc, char* argv[]) {
+    const auto startedAt = std::chrono::steady_clock::now();
+
+    // Try to locate config.json in several likely locations so running from
+    // the build output directory still finds the project's config.
+    std::string cfg = "config.json";
+    try {
+        namespace fs = std::filesystem;
+        if (!fs::exists(cfg)) {
+            const std::vector<std::string> cand = {"../config.json", "../../config.json"};
+            for (const auto &c : cand) {
+                if (fs::exists(c)) {
+                    cfg = c;
+                    break;
+                }
+            }
+        }
+    } catch (...) {
+        // ignore filesystem errors and fall back to default
+    }
+    drogon::app().loadConfigFile(cfg);
+
+    // Сховище налаштовується з config.json, тому конфіг читаємо до Db::instance()
     try {
+        Db::configure(dbOptionsFromConfig(drogon::app().getCustomConfig()));
         // ініціалізація БД (всередині Db() вже є runMigrations)
         Db::instance();
     } catch (const std::exception& e) {
@@ -15,6 +63,34 @@ int main() {
         return 3;
     }
 
+    // CLI: oop_backend --backup [dest] — онлайн-копія без запуску сервера
+    if (argc >= 2 && std::string(argv[1]) == "--backup") {
+        return runBackupCli(argc >= 3 ? argv[2] : BackupService::defaultDestination());
+    }
+
+    // Матриця відстаней порт-порт і просторовий індекс портів:
+    // одна побудова тут, далі їх оновлює PortsController
+    try {
+        const auto t0 = std::chrono::steady_clock::now();
+        PortsRepo repo;
+        const auto ports = repo.all();
+        geo::DistanceMatrix::instance().build(ports);
+        geo::PortIndex::instance().build(ports);
+
+        auto& planner = geo::RoutePlanner::instance();
+        planner.configure(routeOptionsFromConfig(drogon::app().getCustomConfig()));
+        planner.build(ports, repo.lanes());
+
+        const auto ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - t0).count();
+        LOG_INFO << "[Geo] distance matrix, port index and route graph ("
+                 << planner.stats().edges << " edges) over " << ports.size()
+                 << " ports built in " << ms << " ms (" << geo::kernelName() << ")";
+    } catch (const std::exception& e) {
+        std::cerr << "[Geo] port geometry build failed: " << e.what() << std::endl;
+        return 3;
+    }
+
     drogon::app().registerHandler(
         "/health",
         [](const drogon::HttpRequestPtr&,
@@ -22,6 +98,16 @@ int main() {
 
             Json::Value j;
             j["status"] = "ok";
+
+            const auto& o = Db::instance().options();
+            Json::Value db;
+            db["profile"]      = o.profile;
+            db["path"]         = Db::instance().path();
+            db["journal_mode"] = o.journalMode;
+            db["synchronous"]  = o.synchronous;
+            db["commit_seq"]   = static_cast<Json::UInt64>(Db::instance().commitSeq());
+            j["db"] = db;
+
             auto resp = drogon::HttpResponse::newHttpJsonResponse(j);
             resp->setStatusCode(drogon::k200OK);
             cb(resp);
@@ -29,62 +115,160 @@ int main() {
         {drogon::Get}
     );
 
-    // Try to locate config.json in several likely locations so running from
-    // the build output directory still finds the project's config.
-    std::string cfg = "config.json";
     try {
-        namespace fs = std::filesystem;
-        if (!fs::exists(cfg)) {
-            const std::vector<std::string> cand = {"../config.json", "../../config.json"};
-            for (const auto &c : cand) {
-                if (fs::exists(c)) {
-                    cfg = c;
-                    break;
-                }
-            }
-        }
-    } catch (...) {
-        // ignore filesystem errors and fall back to default
+        const auto auditOpts = auditLogOptionsFromConfig(drogon::app().getCustomConfig());
+        Db::instance().configureAuditLog(auditOpts);
+        Db::instance().dropExpiredLogPartitions();
+        LOG_INFO << "[Db] audit log mode: "
+                 << (auditOpts.mode == AuditLogMode::Async ? "async" : "sync");
+    } catch (const std::exception& e) {
+        std::cerr << "[Db] audit log setup failed: " << e.what() << std::endl;
+        return 3;
     }
-    drogon::app().loadConfigFile(cfg);
-    
-    // Встановлюємо таймер для автоматичної обробки прибуттів кораблів
-    setupAutoArrivalTimer();
     
+    // Час холодного старту: від входу в main до готовності приймати запити
+    drogon::app().registerBeginningAdvice([startedAt] {
+        const auto ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - startedAt).count();
+        LOG_INFO << "[Startup] ready to accept requests in " << ms << " ms";
+    });
+
+    // Прибуття кораблів: планувальник у процесі, прокидається рівно на eta
+    try {
+        ArrivalScheduler::instance().start();
+    } catch (const std::exception& e) {
+        std::cerr << "[Arrivals] scheduler start failed: " << e.what() << std::endl;
+        return 3;
+    }
+
+    // Матриця маршрутів усіх пар: відображається з файлу або рахується у фоні
+    try {
+        RouteMatrixJob::instance().start(routeMatrixPath(drogon::app().getCustomConfig()));
+    } catch (const std::exception& e) {
+        std::cerr << "[Routes] route matrix job start failed: " << e.what() << std::endl;
+        return 3;
+    }
+
     drogon::app().run();
 
+    RouteMatrixJob::instance().stop();
+    ArrivalScheduler::instance().stop();
+
+    // Дописуємо чергу аудиту до виходу
+    Db::instance().flushLogs();
+
     return 0;
 }
 
 /**
- * Функція налаштовує автоматичний таймер для перевірки прибуттів кораблів
- * Викликає endpoint /api/ships/process-arrivals кожні 60 секунд
+ * Читає секцію custom_config.db:
+ *   { "profile": "durable" | "balanced" | "bench" | "bench-tmpfs",
+ *     "path": "...", "journal_mode": "WAL", "synchronous": "NORMAL",
+ *     "cache_size_kb": 65536, "mmap_size": 268435456 }
+ * Профіль задає значення за замовчуванням, решта полів їх перекриває.
+ * Змінні оточення (OOP_DB_PROFILE, OOP_DB_PATH, ...) мають найвищий пріоритет.
  */
-void setupAutoArrivalTimer() {
-    LOG_INFO << "[AutoArrival] Starting auto-arrival timer (60 seconds interval)";
-    
-    auto timer_id = drogon::app().getLoop()->runEvery(60.0, []() {
-        LOG_DEBUG << "[AutoArrival] Running scheduled ship arrival check";
-        
-        try {
-            // Створюємо внутрішній HTTP клієнт
-            auto client = drogon::HttpClient::newHttpClient("http://127.0.0.1:8082");
-            auto req = drogon::HttpRequest::newHttpRequest();
-            req->setMethod(drogon::Post);
-            req->setPath("/api/ships/process-arrivals");
-            
-            client->sendRequest(req, [](drogon::ReqResult result, const drogon::HttpResponsePtr& response) {
-                if (result == drogon::ReqResult::Ok && response) {
-                    auto body = response->getBody();
-                    LOG_INFO << "[AutoArrival] Response: " << body;
-                } else {
-                    LOG_WARN << "[AutoArrival] Failed to process arrivals: request failed";
+DbOptions dbOptionsFromConfig(const Json::Value& custom) {
+    const Json::Value& d = custom["db"];
+
+    std::string profile = d.get("profile", "balanced").asString();
+    if (const char* env = std::getenv("OOP_DB_PROFILE"); env && *env) {
+        profile = env;
+    }
+
+    DbOptions opts = DbOptions::forProfile(profile);
+    opts.path        = d.get("path", opts.path).asString();
+    opts.journalMode = d.get("journal_mode", opts.journalMode).asString();
+    opts.synchronous = d.get("synchronous", opts.synchronous).asString();
+    opts.cacheSizeKb = d.get("cache_size_kb", opts.cacheSizeKb).asInt();
+    opts.mmapSize    = d.get("mmap_size", Json::Int64(opts.mmapSize)).asInt64();
+    opts.applyEnv();
+    return opts;
+}
+
+/**
+ * Копіює поточну БД у dest (sqlite3_backup порціями), друкуючи прогрес.
+ * Безпечно запускати поряд з працюючим сервером: у WAL-режимі копія
+ * читає один знімок і не блокує писачів.
+ */
+int runBackupCli(const std::string& dest) {
+    int lastDecile = -1;
+    try {
+        const BackupStatus s = runBackup(Db::instance().handle(), dest, BackupOptions{},
+            [&lastDecile](const BackupStatus& p) {
+                const int decile = static_cast<int>(p.percent()) / 10;
+                if (decile != lastDecile) {
+                    lastDecile = decile;
+                    std::cerr << "[Backup] " << static_cast<int>(p.percent()) << "% ("
+                              << (p.totalPages - p.remainingPages) << "/" << p.totalPages
+                              << " pages)" << std::endl;
                 }
+                return true;
             });
-        } catch (const std::exception& e) {
-            LOG_ERROR << "[AutoArrival] Exception: " << e.what();
-        }
-    });
-    
-    LOG_INFO << "[AutoArrival] Timer started with ID: " << timer_id;
-}
\ No newline at end of file
+        std::cerr << "[Backup] done: " << s.dest << " in " << s.elapsedMs << " ms" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "[Backup] failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+/**
+ * Читає секцію custom_config.audit_log:
+ *   { "mode": "sync" | "async", "batch_rows": 256, "flush_interval_ms": 50, "capacity": 16384,
+ *     "retention_months": 12 }
+ * Змінна оточення OOP_AUDIT_LOG_MODE перекриває mode.
+ */
+AuditLogOptions auditLogOptionsFromConfig(const Json::Value& custom) {
+    AuditLogOptions opts;
+    const Json::Value& a = custom["audit_log"];
+
+    std::string mode = a.get("mode", "sync").asString();
+    if (const char* env = std::getenv("OOP_AUDIT_LOG_MODE"); env && *env) {
+        mode = env;
+    }
+
+    if (mode == "async") {
+        opts.mode = AuditLogMode::Async;
+    } else if (mode != "sync") {
+        throw std::runtime_error("audit_log.mode must be 'sync' or 'async', got '" + mode + "'");
+    }
+
+    opts.batchRows       = a.get("batch_rows", Json::UInt64(opts.batchRows)).asUInt64();
+    opts.flushIntervalMs = a.get("flush_interval_ms", opts.flushIntervalMs).asInt();
+    opts.capacity        = a.get("capacity", Json::UInt64(opts.capacity)).asUInt64();
+    opts.retentionMonths = a.get("retention_months", opts.retentionMonths).asInt();
+    return opts;
+}
+
+/**
+ * Читає секцію custom_config.routes:
+ *   { "max_leg_km": 1500, "max_neighbors": 32, "cache_size": 4096 }
+ * max_leg_km = 0 — ребра графа лише з таблиці sea_lanes.
+ */
+geo::RouteOptions routeOptionsFromConfig(const Json::Value& custom) {
+    geo::RouteOptions opts;
+    const Json::Value& r = custom["routes"];
+
+    opts.maxLegKm     = r.get("max_leg_km", opts.maxLegKm).asDouble();
+    opts.maxNeighbors = r.get("max_neighbors", Json::UInt64(opts.maxNeighbors)).asUInt64();
+    opts.cacheSize    = r.get("cache_size", Json::UInt64(opts.cacheSize)).asUInt64();
+    if (opts.maxLegKm < 0.0) {
+        throw std::runtime_error("routes.max_leg_km must be >= 0");
+    }
+    return opts;
+}
+
+/**
+ * custom_config.routes.matrix_path; за замовчуванням — поряд із БД
+ * (<db>.routes), для БД у пам'яті — у тимчасовому каталозі.
+ */
+std::string routeMatrixPath(const Json::Value& custom) {
+    const std::string path = custom["routes"].get("matrix_path", "").asString();
+    if (!path.empty()) return path;
+
+    if (Db::instance().options().inMemory()) {
+        return (std::filesystem::temp_directory_path() / "oop_route_matrix.bin").string();
+    }
+    return Db::instance().path() + ".routes";
+}
@@ -1,6 +1,7 @@
 ﻿// src/repos/CompaniesRepo.cpp
 #include "repos/CompaniesRepo.h"
 #include "db/Db.h"
+#include "db/Stmt.h"
 
 #include <sqlite3.h>
 #include <stdexcept>
@@ -11,30 +12,6 @@
 
 namespace {
 
-// ---- RAII stmt ---------------------------------
-
-class Stmt {
-public:
-    Stmt(sqlite3* db, const char* sql) : db_(db) {
-        if (sqlite3_prepare_v2(db_, sql, -1, &st_, nullptr) != SQLITE_OK) {
-            throw std::runtime_error(sqlite3_errmsg(db_));
-        }
-    }
-
-    ~Stmt() {
-        if (st_) sqlite3_finalize(st_);
-    }
-
-    sqlite3_stmt* get() const noexcept { return st_; }
-
-    Stmt(const Stmt&) = delete;
-    Stmt& operator=(const Stmt&) = delete;
-
-private:
-    sqlite3* db_{nullptr};
-    sqlite3_stmt* st_{nullptr};
-};
-
 // ---- helpers -----------------------------------
 
 inline std::string safe_text(sqlite3_stmt* st, int col) {
@@ -71,16 +48,6 @@ Ship parseShip(sqlite3_stmt* st) {
     return s;
 }
 
-void execSimple(sqlite3* db, const char* sql) {
-    char* err = nullptr;
-    const int rc = sqlite3_exec(db, sql, nullptr, nullptr, &err);
-    if (rc != SQLITE_OK) {
-        std::string msg = err ? err : sqlite3_errmsg(db);
-        if (err) sqlite3_free(err);
-        throw std::runtime_error(msg);
-    }
-}
-
 } // namespace
 
 // ---- CRUD companies --------------------------------------------
@@ -98,6 +65,11 @@ std::vector<Company> CompaniesRepo::all() {
     return out;
 }
 
+Page<Company> CompaniesRepo::page(const PageRequest& req) {
+    const char* sql = "SELECT id,name FROM companies WHERE id > ? ORDER BY id LIMIT ?";
+    return fetchPage<Company>(Db::instance().handle(), sql, req, parseCompany);
+}
+
 std::optional<Company> CompaniesRepo::byId(std::int64_t id) {
     sqlite3* db = Db::instance().handle();
 
@@ -112,8 +84,32 @@ std::optional<Company> CompaniesRepo::byId(std::int64_t id) {
     return std::nullopt;
 }
 
+std::optional<Company> CompaniesRepo::byName(const std::string& name) {
+    sqlite3* db = Db::instance().handle();
+
+    const char* sql = "SELECT id,name FROM companies WHERE name=?";
+
+    Stmt st(db, sql);
+    sqlite3_bind_text(st.get(), 1, name.c_str(), -1, SQLITE_STATIC);
+
+    if (sqlite3_step(st.get()) == SQLITE_ROW) {
+        return parseCompany(st.get());
+    }
+    return std::nullopt;
+}
+
+bool CompaniesRepo::existsByName(const std::string& name) {
+    sqlite3* db = Db::instance().handle();
+
+    Stmt st(db, "SELECT 1 FROM companies WHERE name=? LIMIT 1");
+    sqlite3_bind_text(st.get(), 1, name.c_str(), -1, SQLITE_STATIC);
+
+    return sqlite3_step(st.get()) == SQLITE_ROW;
+}
+
 Company CompaniesRepo::create(const std::string& name) {
     sqlite3* db = Db::instance().handle();
+    Db::Transaction tx(db);
 
     const char* sql = "INSERT INTO companies(name) VALUES(?)";
 
@@ -132,6 +128,7 @@ Company CompaniesRepo::create(const std::string& name) {
         std::string msg = "Created company '" + name + "' (id=" + std::to_string(id) + ")";
         Db::instance().insertLog("AUDIT", "company.create", "company", (int)id, "system", msg);
     } catch (...) {}
+    tx.commit();
     return *c;
 }
 
@@ -142,6 +139,7 @@ Company CompaniesRepo::create(const Company& c) {
 
 bool CompaniesRepo::update(std::int64_t id, const std::string& name) {
     sqlite3* db = Db::instance().handle();
+    Db::Transaction tx(db);
 
     const char* sql = "UPDATE companies SET name=? WHERE id=?";
 
@@ -161,6 +159,7 @@ bool CompaniesRepo::update(std::int64_t id, const std::string& name) {
         } catch (...) {}
     }
 
+    tx.commit();
     return changed;
 }
 
@@ -171,6 +170,7 @@ bool CompaniesRepo::update(const Company& c) {
 
 bool CompaniesRepo::remove(std::int64_t id) {
     sqlite3* db = Db::instance().handle();
+    Db::Transaction tx(db);
 
     const char* sql = "DELETE FROM companies WHERE id=?";
 
@@ -189,6 +189,7 @@ bool CompaniesRepo::remove(std::int64_t id) {
         } catch (...) {}
     }
 
+    tx.commit();
     return changed;
 }
 
@@ -217,57 +218,49 @@ std::vector<Port> CompaniesRepo::ports(std::int64_t companyId) {
 bool CompaniesRepo::addPort(std::int64_t companyId, std::int64_t portId, bool isMain) {
     sqlite3* db = Db::instance().handle();
 
-    if (isMain) {
-        execSimple(db, "BEGIN;");
-    }
+    // зняття старого main і upsert нового — одна одиниця роботи
+    Db::Transaction tx(db);
 
-    try {
-        if (isMain) {
-            const char* clearSql =
-                "UPDATE company_ports SET is_main=0 WHERE company_id=?";
+    if (isMain) {
+        const char* clearSql =
+            "UPDATE company_ports SET is_main=0 WHERE company_id=?";
 
-            Stmt clear(db, clearSql);
-            sqlite3_bind_int64(clear.get(), 1, companyId);
+        Stmt clear(db, clearSql);
+        sqlite3_bind_int64(clear.get(), 1, companyId);
 
-            if (sqlite3_step(clear.get()) != SQLITE_DONE) {
-                throw std::runtime_error(std::string("clear main port failed: ") + sqlite3_errmsg(db));
-            }
+        if (sqlite3_step(clear.get()) != SQLITE_DONE) {
+            throw std::runtime_error(std::string("clear main port failed: ") + sqlite3_errmsg(db));
         }
+    }
 
-        // Upsert
-        const char* upsertSql =
-            "INSERT INTO company_ports(company_id,port_id,is_main) "
-            "VALUES(?,?,?) "
-            "ON CONFLICT(company_id,port_id) "
-            "DO UPDATE SET is_main=excluded.is_main;";
-
-        Stmt up(db, upsertSql);
-        sqlite3_bind_int64(up.get(), 1, companyId);
-        sqlite3_bind_int64(up.get(), 2, portId);
-        sqlite3_bind_int64(up.get(), 3, isMain ? 1 : 0);
+    // Upsert
+    const char* upsertSql =
+        "INSERT INTO company_ports(company_id,port_id,is_main) "
+        "VALUES(?,?,?) "
+        "ON CONFLICT(company_id,port_id) "
+        "DO UPDATE SET is_main=excluded.is_main;";
 
-        if (sqlite3_step(up.get()) != SQLITE_DONE) {
-            throw std::runtime_error(std::string("add port failed: ") + sqlite3_errmsg(db));
-        }
+    Stmt up(db, upsertSql);
+    sqlite3_bind_int64(up.get(), 1, companyId);
+    sqlite3_bind_int64(up.get(), 2, portId);
+    sqlite3_bind_int64(up.get(), 3, isMain ? 1 : 0);
 
-        if (isMain) {
-            execSimple(db, "COMMIT;");
-        }
-        try {
-            std::string msg = "Added port_id=" + std::to_string(portId) + " to company_id=" + std::to_string(companyId) + (isMain ? " (main)" : "");
-            Db::instance().insertLog("AUDIT", "company.add_port", "company", (int)companyId, "system", msg);
-        } catch (...) {}
-        return true;
-    } catch (...) {
-        if (isMain) {
-            sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
-        }
-        throw;
+    if (sqlite3_step(up.get()) != SQLITE_DONE) {
+        throw std::runtime_error(std::string("add port failed: ") + sqlite3_errmsg(db));
     }
+
+    try {
+        std::string msg = "Added port_id=" + std::to_string(portId) + " to company_id=" + std::to_string(companyId) + (isMain ? " (main)" : "");
+        Db::instance().insertLog("AUDIT", "company.add_port", "company", (int)companyId, "system", msg);
+    } catch (...) {}
+
+    tx.commit();
+    return true;
 }
 
 bool CompaniesRepo::removePort(std::int64_t companyId, std::int64_t portId) {
     sqlite3* db = Db::instance().handle();
+    Db::Transaction tx(db);
 
     const char* sql =
         "DELETE FROM company_ports WHERE company_id=? AND port_id=?";
@@ -286,6 +279,7 @@ bool CompaniesRepo::removePort(std::int64_t companyId, std::int64_t portId) {
             Db::instance().insertLog("AUDIT", "company.remove_port", "company", (int)companyId, "system", msg);
         } catch (...) {}
     }
+    tx.commit();
     return changed;
 }
 
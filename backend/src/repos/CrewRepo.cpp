@@ -1,6 +1,8 @@
 ﻿// src/repos/CrewRepo.cpp
 #include "repos/CrewRepo.h"
 #include "db/Db.h"
+#include "db/Stmt.h"
+#include "util/Time.h"
 
 #include <sqlite3.h>
 
@@ -12,44 +14,15 @@
 
 namespace {
 
-// ---------- RAII wrapper for sqlite3_stmt ----------
-class Stmt {
-public:
-    Stmt(sqlite3* db, const char* sql) : db_(db) {
-        if (sqlite3_prepare_v2(db_, sql, -1, &st_, nullptr) != SQLITE_OK) {
-            throw std::runtime_error(sqlite3_errmsg(db_));
-        }
-    }
-
-    ~Stmt() {
-        if (st_) sqlite3_finalize(st_);
-    }
-
-    sqlite3_stmt* get() const noexcept { return st_; }
-
-    Stmt(const Stmt&) = delete;
-    Stmt& operator=(const Stmt&) = delete;
-
-private:
-    sqlite3* db_{nullptr};
-    sqlite3_stmt* st_{nullptr};
-};
-
-inline std::string safe_text(sqlite3_stmt* st, int col) {
-    const unsigned char* t = sqlite3_column_text(st, col);
-    return t ? reinterpret_cast<const char*>(t) : "";
-}
-
 CrewAssignment parseRow(sqlite3_stmt* st) {
     CrewAssignment a{};
     a.id        = sqlite3_column_int64(st, 0);
     a.person_id = sqlite3_column_int64(st, 1);
     a.ship_id   = sqlite3_column_int64(st, 2);
-    a.start_utc = safe_text(st, 3);
+    a.start_utc = sqlite3_column_int64(st, 3);
 
-    const auto end = safe_text(st, 4);
-    if (!end.empty()) {
-        a.end_utc = end;
+    if (sqlite3_column_type(st, 4) != SQLITE_NULL) {
+        a.end_utc = sqlite3_column_int64(st, 4);
     }
     return a;
 }
@@ -86,8 +59,9 @@ std::vector<CrewAssignment> CrewRepo::currentCrewByShip(long long shipId) {
 
 std::optional<CrewAssignment> CrewRepo::assign(long long personId,
                                                long long shipId,
-                                               const std::string& startUtc) {
+                                               std::int64_t startUtcMs) {
     sqlite3* db = Db::instance().handle();
+    Db::Transaction tx(db);
 
     // Покладаємось на partial unique index:
     //  - ux_crew_person_active(person_id) WHERE end_utc IS NULL
@@ -100,7 +74,7 @@ std::optional<CrewAssignment> CrewRepo::assign(long long personId,
 
     sqlite3_bind_int64(ins.get(), 1, static_cast<std::int64_t>(personId));
     sqlite3_bind_int64(ins.get(), 2, static_cast<std::int64_t>(shipId));
-    sqlite3_bind_text (ins.get(), 3, startUtc.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(ins.get(), 3, startUtcMs);
 
     const int rc = sqlite3_step(ins.get());
     if (rc != SQLITE_DONE) {
@@ -125,24 +99,27 @@ std::optional<CrewAssignment> CrewRepo::assign(long long personId,
     Stmt sel(db, selSql);
     sqlite3_bind_int64(sel.get(), 1, id);
 
-    if (sqlite3_step(sel.get()) == SQLITE_ROW) {
-        return parseRow(sel.get());
+    if (sqlite3_step(sel.get()) != SQLITE_ROW) {
+        throw std::runtime_error("insert ok but fetch failed");
     }
-
-    throw std::runtime_error("insert ok but fetch failed");
+    auto out = parseRow(sel.get());
+    tx.commit();
+    return out;
 }
 
-// завершити призначення за id поточним часом SQLite
+// завершити призначення за id поточним часом
 bool CrewRepo::end(long long assignmentId) {
     sqlite3* db = Db::instance().handle();
+    Db::Transaction tx(db);
 
     const char* sql =
         "UPDATE crew_assignments "
-        "SET end_utc = datetime('now') "
+        "SET end_utc = ? "
         "WHERE id = ? AND end_utc IS NULL";
 
     Stmt st(db, sql);
-    sqlite3_bind_int64(st.get(), 1, static_cast<std::int64_t>(assignmentId));
+    sqlite3_bind_int64(st.get(), 1, util::nowMs());
+    sqlite3_bind_int64(st.get(), 2, static_cast<std::int64_t>(assignmentId));
 
     const int rc = sqlite3_step(st.get());
     if (rc != SQLITE_DONE) {
@@ -157,13 +134,15 @@ bool CrewRepo::end(long long assignmentId) {
         } catch (...) {}
     }
 
+    tx.commit();
     return changed;
 
 }
 
-// завершити призначення за id з явним endUtc
-bool CrewRepo::end(long long assignmentId, const std::string& endUtc) {
+// завершити призначення за id з явним endUtcMs
+bool CrewRepo::end(long long assignmentId, std::int64_t endUtcMs) {
     sqlite3* db = Db::instance().handle();
+    Db::Transaction tx(db);
 
     const char* sql =
         "UPDATE crew_assignments "
@@ -172,7 +151,7 @@ bool CrewRepo::end(long long assignmentId, const std::string& endUtc) {
 
     Stmt st(db, sql);
 
-    sqlite3_bind_text (st.get(), 1, endUtc.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(st.get(), 1, endUtcMs);
     sqlite3_bind_int64(st.get(), 2, static_cast<std::int64_t>(assignmentId));
 
     const int rc = sqlite3_step(st.get());
@@ -183,16 +162,18 @@ bool CrewRepo::end(long long assignmentId, const std::string& endUtc) {
     const bool changed = sqlite3_changes(db) > 0;
     if (changed) {
         try {
-            std::string msg = "Ended assignment id=" + std::to_string(assignmentId) + " with endUtc=" + endUtc;
+            std::string msg = "Ended assignment id=" + std::to_string(assignmentId) + " with endUtc=" + util::formatIsoMs(endUtcMs);
             Db::instance().insertLog("AUDIT", "crew.end", "crew", (int)assignmentId, "system", msg);
         } catch (...) {}
     }
 
+    tx.commit();
     return changed;
 }
 
-bool CrewRepo::endActiveByPerson(long long personId, const std::string& endUtc) {
+bool CrewRepo::endActiveByPerson(long long personId, std::int64_t endUtcMs) {
     sqlite3* db = Db::instance().handle();
+    Db::Transaction tx(db);
 
     const char* sql =
         "UPDATE crew_assignments "
@@ -201,7 +182,7 @@ bool CrewRepo::endActiveByPerson(long long personId, const std::string& endUtc)
 
     Stmt st(db, sql);
 
-    sqlite3_bind_text (st.get(), 1, endUtc.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(st.get(), 1, endUtcMs);
     sqlite3_bind_int64(st.get(), 2, static_cast<std::int64_t>(personId));
 
     const int rc = sqlite3_step(st.get());
@@ -213,10 +194,11 @@ bool CrewRepo::endActiveByPerson(long long personId, const std::string& endUtc)
     const bool changed = changedRows > 0;
     if (changed) {
         try {
-            std::string msg = "Ended " + std::to_string(changedRows) + " active assignments for person_id=" + std::to_string(personId) + " with endUtc=" + endUtc;
+            std::string msg = "Ended " + std::to_string(changedRows) + " active assignments for person_id=" + std::to_string(personId) + " with endUtc=" + util::formatIsoMs(endUtcMs);
             Db::instance().insertLog("AUDIT", "crew.end_multiple", "crew", (int)personId, "system", msg);
         } catch (...) {}
     }
 
+    tx.commit();
     return changed;
 }
@@ -1,5 +1,6 @@
 ﻿#include "repos/PeopleRepo.h"
 #include "db/Db.h"
+#include "db/Stmt.h"
 #include <sqlite3.h>
 #include <stdexcept>
 #include <string>
@@ -11,6 +12,14 @@ namespace {
         const unsigned char* t = sqlite3_column_text(st, col);
         return t ? reinterpret_cast<const char*>(t) : "";
     }
+
+    Person parsePerson(sqlite3_stmt* st) {
+        Person p;
+        p.id        = sqlite3_column_int64(st, 0);
+        p.full_name = safe_text(st, 1);
+        p.rank      = safe_text(st, 2);
+        return p;
+    }
 }
 
 void PeopleRepo::createTable() {
@@ -32,22 +41,16 @@ void PeopleRepo::createTable() {
 
 Person PeopleRepo::create(const Person& p) {
     sqlite3* db = Db::instance().handle();
-    const char* sql = "INSERT INTO people(full_name, rank) VALUES(?, ?);";
-
-    sqlite3_stmt* st = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &st, nullptr) != SQLITE_OK) {
-        throw std::runtime_error(sqlite3_errmsg(db));
-    }
+    Db::Transaction tx(db);
+    Stmt st(db, "INSERT INTO people(full_name, rank) VALUES(?, ?);");
 
     // Прив'язуємо параметри
-    sqlite3_bind_text(st, 1, p.full_name.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(st, 2, p.rank.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(st.get(), 1, p.full_name.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(st.get(), 2, p.rank.c_str(), -1, SQLITE_TRANSIENT);
 
-    if (sqlite3_step(st) != SQLITE_DONE) {
-        sqlite3_finalize(st);
+    if (sqlite3_step(st.get()) != SQLITE_DONE) {
         throw std::runtime_error("PeopleRepo::create step failed: " + std::string(sqlite3_errmsg(db)));
     }
-    sqlite3_finalize(st);
 
     Person created = p;
     created.id = sqlite3_last_insert_rowid(db);
@@ -57,110 +60,89 @@ Person PeopleRepo::create(const Person& p) {
     } catch (...) {
         // Logging should not break the main flow
     }
+    tx.commit();
     return created;
 }
 
 std::vector<Person> PeopleRepo::all() {
     std::vector<Person> out;
     sqlite3* db = Db::instance().handle();
-    const char* sql = "SELECT id, full_name, rank FROM people;";
+    Stmt st(db, "SELECT id, full_name, rank FROM people;");
 
-    sqlite3_stmt* st = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &st, nullptr) != SQLITE_OK) {
-        throw std::runtime_error(sqlite3_errmsg(db));
+    while (sqlite3_step(st.get()) == SQLITE_ROW) {
+        out.push_back(parsePerson(st.get()));
     }
-
-    while (sqlite3_step(st) == SQLITE_ROW) {
-        Person p;
-        p.id        = sqlite3_column_int64(st, 0);
-        p.full_name = safe_text(st, 1);
-        p.rank      = safe_text(st, 2);
-        out.push_back(p);
-    }
-    sqlite3_finalize(st);
     return out;
 }
 
+Page<Person> PeopleRepo::page(const PageRequest& req) {
+    return fetchPage<Person>(Db::instance().handle(),
+                             "SELECT id, full_name, rank FROM people WHERE id > ? ORDER BY id LIMIT ?;",
+                             req, parsePerson);
+}
+
 std::optional<Person> PeopleRepo::byId(long long id) {
     sqlite3* db = Db::instance().handle();
-    const char* sql = "SELECT id, full_name, rank FROM people WHERE id = ?;";
-
-    sqlite3_stmt* st = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &st, nullptr) != SQLITE_OK) {
-        throw std::runtime_error(sqlite3_errmsg(db));
-    }
+    Stmt st(db, "SELECT id, full_name, rank FROM people WHERE id = ?;");
 
-    sqlite3_bind_int64(st, 1, id);
+    sqlite3_bind_int64(st.get(), 1, id);
 
-    if (sqlite3_step(st) == SQLITE_ROW) {
+    if (sqlite3_step(st.get()) == SQLITE_ROW) {
         Person p;
-        p.id        = sqlite3_column_int64(st, 0);
-        p.full_name = safe_text(st, 1);
-        p.rank      = safe_text(st, 2);
-        sqlite3_finalize(st);
+        p.id        = sqlite3_column_int64(st.get(), 0);
+        p.full_name = safe_text(st.get(), 1);
+        p.rank      = safe_text(st.get(), 2);
         return p;
     }
 
-    sqlite3_finalize(st);
     return std::nullopt;
 }
 
 void PeopleRepo::update(const Person& p) {
     sqlite3* db = Db::instance().handle();
-    const char* sql = "UPDATE people SET full_name=?, rank=? WHERE id=?;";
+    Db::Transaction tx(db);
+    Stmt st(db, "UPDATE people SET full_name=?, rank=? WHERE id=?;");
 
-    sqlite3_stmt* st = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &st, nullptr) != SQLITE_OK) {
-        throw std::runtime_error(sqlite3_errmsg(db));
-    }
-
-    sqlite3_bind_text(st, 1, p.full_name.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(st, 2, p.rank.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int64(st, 3, p.id);
+    sqlite3_bind_text(st.get(), 1, p.full_name.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(st.get(), 2, p.rank.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(st.get(), 3, p.id);
 
-    if (sqlite3_step(st) != SQLITE_DONE) {
-        sqlite3_finalize(st);
+    if (sqlite3_step(st.get()) != SQLITE_DONE) {
         throw std::runtime_error("PeopleRepo::update failed: " + std::string(sqlite3_errmsg(db)));
     }
-    sqlite3_finalize(st);
     try {
         std::string msg = "Updated person id=" + std::to_string(p.id) + " name='" + p.full_name + "' rank='" + p.rank + "'";
         Db::instance().insertLog("INFO", "person.update", "person", (int)p.id, "system", msg);
     } catch (...) {
         // ignore logging errors
     }
+    tx.commit();
 }
 
 void PeopleRepo::remove(long long id) {
     sqlite3* db = Db::instance().handle();
+    Db::Transaction tx(db);
     
     // 1. Видаляємо залежності (екіпаж)
-    const char* delCrewSql = "DELETE FROM crew_assignments WHERE person_id = ?;";
-    sqlite3_stmt* stCrew = nullptr;
-    if (sqlite3_prepare_v2(db, delCrewSql, -1, &stCrew, nullptr) == SQLITE_OK) {
-        sqlite3_bind_int64(stCrew, 1, id);
-        sqlite3_step(stCrew);
-        sqlite3_finalize(stCrew);
+    {
+        Stmt stCrew(db, "DELETE FROM crew_assignments WHERE person_id = ?;");
+        sqlite3_bind_int64(stCrew.get(), 1, id);
+        sqlite3_step(stCrew.get());
     }
 
     // 2. Видаляємо людину
-    const char* sql = "DELETE FROM people WHERE id=?;";
-    sqlite3_stmt* st = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &st, nullptr) != SQLITE_OK) {
-        throw std::runtime_error(sqlite3_errmsg(db));
-    }
+    Stmt st(db, "DELETE FROM people WHERE id=?;");
 
-    sqlite3_bind_int64(st, 1, id);
+    sqlite3_bind_int64(st.get(), 1, id);
 
-    if (sqlite3_step(st) != SQLITE_DONE) {
-        sqlite3_finalize(st);
+    if (sqlite3_step(st.get()) != SQLITE_DONE) {
         throw std::runtime_error("PeopleRepo::remove failed: " + std::string(sqlite3_errmsg(db)));
     }
-    sqlite3_finalize(st);
     try {
         std::string msg = "Deleted person id=" + std::to_string(id);
         Db::instance().insertLog("INFO", "person.delete", "person", (int)id, "system", msg);
     } catch (...) {
         // ignore logging errors
     }
+    tx.commit();
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 ﻿// src/repos/PortsRepo.cpp
 #include "repos/PortsRepo.h"
 #include "db/Db.h"
+#include "db/Stmt.h"
 
 #include <sqlite3.h>
 
@@ -8,33 +9,11 @@
 #include <string>
 #include <vector>
 #include <optional>
+#include <cstddef>
 #include <cstdint>
 
 namespace {
 
-// ---------- RAII wrapper for sqlite3_stmt ----------
-class Stmt {
-public:
-    Stmt(sqlite3* db, const char* sql) : db_(db) {
-        if (sqlite3_prepare_v2(db_, sql, -1, &st_, nullptr) != SQLITE_OK) {
-            throw std::runtime_error(sqlite3_errmsg(db_));
-        }
-    }
-
-    ~Stmt() {
-        if (st_) sqlite3_finalize(st_);
-    }
-
-    sqlite3_stmt* get() const noexcept { return st_; }
-
-    Stmt(const Stmt&) = delete;
-    Stmt& operator=(const Stmt&) = delete;
-
-private:
-    sqlite3* db_{nullptr};
-    sqlite3_stmt* st_{nullptr};
-};
-
 inline std::string safe_text(sqlite3_stmt* st, int col) {
     const unsigned char* t = sqlite3_column_text(st, col);
     return t ? reinterpret_cast<const char*>(t) : "";
@@ -77,9 +56,49 @@ std::vector<Port> PortsRepo::all() const {
     return result;
 }
 
+Page<Port> PortsRepo::page(const PageRequest& req) const {
+    const char* sql =
+        "SELECT id, name, region, lat, lon "
+        "FROM ports "
+        "WHERE id > ? "
+        "ORDER BY id LIMIT ?;";
+
+    return fetchPage<Port>(db_, sql, req, parsePort);
+}
+
+geo::PortCoords PortsRepo::coords() const {
+    geo::PortCoords out;
+
+    Stmt count(db_, "SELECT COUNT(*) FROM ports;");
+    if (sqlite3_step(count.get()) == SQLITE_ROW) {
+        out.reserve(static_cast<std::size_t>(sqlite3_column_int64(count.get(), 0)));
+    }
+
+    Stmt st(db_, "SELECT id, lat, lon FROM ports ORDER BY id;");
+    while (sqlite3_step(st.get()) == SQLITE_ROW) {
+        out.push_back(sqlite3_column_int64(st.get(), 0),
+                      sqlite3_column_double(st.get(), 1),
+                      sqlite3_column_double(st.get(), 2));
+    }
+
+    return out;
+}
+
+std::vector<std::pair<std::int64_t, std::int64_t>> PortsRepo::lanes() const {
+    std::vector<std::pair<std::int64_t, std::int64_t>> out;
+
+    Stmt st(db_, "SELECT from_port_id, to_port_id FROM sea_lanes;");
+    while (sqlite3_step(st.get()) == SQLITE_ROW) {
+        out.emplace_back(sqlite3_column_int64(st.get(), 0), sqlite3_column_int64(st.get(), 1));
+    }
+
+    return out;
+}
+
 // ------------------ CREATE ------------------
 
 Port PortsRepo::create(const Port& in) const {
+    Db::Transaction tx(db_);
     const char* sql =
         "INSERT INTO ports (name, region, lat, lon) "
         "VALUES (?, ?, ?, ?);";
@@ -103,6 +122,7 @@ Port PortsRepo::create(const Port& in) const {
         std::string msg = "Created port '" + out.name + "' (id=" + std::to_string(out.id) + ")";
         Db::instance().insertLog("AUDIT", "port.create", "port", (int)out.id, "system", msg);
     } catch (...) {}
+    tx.commit();
     return out;
 }
 
@@ -125,9 +145,35 @@ std::optional<Port> PortsRepo::getById(int64_t id) const {
     return std::nullopt;
 }
 
+// ------------------ GET BY NAME ------------------
+
+std::optional<Port> PortsRepo::byName(const std::string& name) const {
+    const char* sql =
+        "SELECT id, name, region, lat, lon "
+        "FROM ports "
+        "WHERE name = ?;";
+
+    Stmt st(db_, sql);
+    sqlite3_bind_text(st.get(), 1, name.c_str(), -1, SQLITE_STATIC);
+
+    if (sqlite3_step(st.get()) == SQLITE_ROW) {
+        return parsePort(st.get());
+    }
+
+    return std::nullopt;
+}
+
+bool PortsRepo::existsByName(const std::string& name) const {
+    Stmt st(db_, "SELECT 1 FROM ports WHERE name = ? LIMIT 1;");
+    sqlite3_bind_text(st.get(), 1, name.c_str(), -1, SQLITE_STATIC);
+
+    return sqlite3_step(st.get()) == SQLITE_ROW;
+}
+
 // ------------------ UPDATE ------------------
 
 bool PortsRepo::update(const Port& p) const {
+    Db::Transaction tx(db_);
     const char* sql =
         "UPDATE ports "
         "SET name = ?, region = ?, lat = ?, lon = ? "
@@ -152,12 +198,14 @@ bool PortsRepo::update(const Port& p) const {
     } catch (...) {}
 
     // Контролер вже перевіряє існування порту; повертаємо true
+    tx.commit();
     return true;
 }
 
 // ------------------ REMOVE ------------------
 
 bool PortsRepo::remove(int64_t id) const {
+    Db::Transaction tx(db_);
     const char* sql =
         "DELETE FROM ports "
         "WHERE id = ?;";
@@ -177,5 +225,6 @@ bool PortsRepo::remove(int64_t id) const {
             Db::instance().insertLog("AUDIT", "port.delete", "port", (int)id, "system", msg);
         } catch (...) {}
     }
+    tx.commit();
     return changed;
 }
@@ -1,6 +1,7 @@
 ﻿// src/repos/ShipTypesRepo.cpp
 #include "repos/ShipTypesRepo.h"
 #include "db/Db.h"
+#include "db/Stmt.h"
 
 #include <sqlite3.h>
 
@@ -12,29 +13,6 @@
 
 namespace {
 
-// ---------- RAII wrapper for sqlite3_stmt ----------
-class Stmt {
-public:
-    Stmt(sqlite3* db, const char* sql) : db_(db) {
-        if (sqlite3_prepare_v2(db_, sql, -1, &st_, nullptr) != SQLITE_OK) {
-            throw std::runtime_error(sqlite3_errmsg(db_));
-        }
-    }
-
-    ~Stmt() {
-        if (st_) sqlite3_finalize(st_);
-    }
-
-    sqlite3_stmt* get() const noexcept { return st_; }
-
-    Stmt(const Stmt&) = delete;
-    Stmt& operator=(const Stmt&) = delete;
-
-private:
-    sqlite3* db_{nullptr};
-    sqlite3_stmt* st_{nullptr};
-};
-
 inline std::string safe_text(sqlite3_stmt* st, int col) {
     const unsigned char* t = sqlite3_column_text(st, col);
     return t ? reinterpret_cast<const char*>(t) : "";
@@ -69,6 +47,16 @@ std::vector<ShipType> ShipTypesRepo::all() {
     return out;
 }
 
+Page<ShipType> ShipTypesRepo::page(const PageRequest& req) {
+    const char* sql =
+        "SELECT id, code, name, description "
+        "FROM ship_types "
+        "WHERE id > ? "
+        "ORDER BY id LIMIT ?";
+
+    return fetchPage<ShipType>(Db::instance().handle(), sql, req, parseType);
+}
+
 std::optional<ShipType> ShipTypesRepo::byId(long long id) {
     sqlite3* db = Db::instance().handle();
 
@@ -107,6 +95,7 @@ std::optional<ShipType> ShipTypesRepo::byCode(const std::string& code) {
 
 ShipType ShipTypesRepo::create(const ShipType& t) {
     sqlite3* db = Db::instance().handle();
+    Db::Transaction tx(db);
 
     const char* sql =
         "INSERT INTO ship_types(code,name,description) "
@@ -131,11 +120,13 @@ ShipType ShipTypesRepo::create(const ShipType& t) {
         std::string msg = "Created ship type '" + t.name + "' (id=" + std::to_string(id) + ")";
         Db::instance().insertLog("AUDIT", "ship_type.create", "ship_type", (int)id, "system", msg);
     } catch (...) {}
+    tx.commit();
     return *got;
 }
 
 void ShipTypesRepo::update(const ShipType& t) {
     sqlite3* db = Db::instance().handle();
+    Db::Transaction tx(db);
 
     const char* sql =
         "UPDATE ship_types "
@@ -158,10 +149,12 @@ void ShipTypesRepo::update(const ShipType& t) {
         std::string msg = "Updated ship_type id=" + std::to_string(t.id) + " name='" + t.name + "'";
         Db::instance().insertLog("AUDIT", "ship_type.update", "ship_type", (int)t.id, "system", msg);
     } catch (...) {}
+    tx.commit();
 }
 
 void ShipTypesRepo::remove(long long id) {
     sqlite3* db = Db::instance().handle();
+    Db::Transaction tx(db);
 
     const char* sql =
         "DELETE FROM ship_types "
@@ -179,4 +172,5 @@ void ShipTypesRepo::remove(long long id) {
         std::string msg = "Deleted ship_type id=" + std::to_string(id);
         Db::instance().insertLog("AUDIT", "ship_type.delete", "ship_type", (int)id, "system", msg);
     } catch (...) {}
+    tx.commit();
 }
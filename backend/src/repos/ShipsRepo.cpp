@@ -1,9 +1,12 @@
 ﻿// src/repos/ShipsRepo.cpp
 #include "repos/ShipsRepo.h"
 #include "db/Db.h"
+#include "db/Stmt.h"
+#include "repos/VoyagesRepo.h"
 
 #include <sqlite3.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <stdexcept>
@@ -12,29 +15,6 @@
 
 namespace {
 
-// ---------- RAII wrapper ----------
-class Stmt {
-public:
-    Stmt(sqlite3* db, const char* sql) : db_(db) {
-        if (sqlite3_prepare_v2(db_, sql, -1, &st_, nullptr) != SQLITE_OK) {
-            throw std::runtime_error(sqlite3_errmsg(db_));
-        }
-    }
-
-    ~Stmt() {
-        if (st_) sqlite3_finalize(st_);
-    }
-
-    sqlite3_stmt* get() const noexcept { return st_; }
-
-    Stmt(const Stmt&) = delete;
-    Stmt& operator=(const Stmt&) = delete;
-
-private:
-    sqlite3* db_{nullptr};
-    sqlite3_stmt* st_{nullptr};
-};
-
 inline std::string safe_text(sqlite3_stmt* st, int col) {
     const unsigned char* t = sqlite3_column_text(st, col);
     return t ? reinterpret_cast<const char*>(t) : "";
@@ -50,9 +30,9 @@ Ship parseShip(sqlite3_stmt* st) {
     s.status     = safe_text(st, 5);
     s.company_id = sqlite3_column_int64(st, 6); // якщо NULL -> 0
     s.speed_knots = sqlite3_column_double(st, 7);
-    s.departed_at = safe_text(st, 8);
+    s.departed_at = sqlite3_column_int64(st, 8);         // NULL -> 0
     s.destination_port_id = sqlite3_column_int64(st, 9);
-    s.eta = safe_text(st, 10);
+    s.eta = sqlite3_column_int64(st, 10);                // NULL -> 0
     s.voyage_distance_km = sqlite3_column_double(st, 11);
     return s;
 }
@@ -65,6 +45,35 @@ inline void bindNullableInt64(sqlite3_stmt* st, int idx, std::int64_t v) {
     }
 }
 
+constexpr const char* kInsertShipSql =
+    "INSERT INTO ships(name, type, country, port_id, status, company_id, speed_knots, "
+    "departed_at, destination_port_id, eta, voyage_distance_km) "
+    "VALUES(?,?,?,?,?,?,?,?,?,?,?);";
+
+// Рядки прив'язуються без копії (SQLITE_STATIC): s має жити до sqlite3_step
+void bindShipInsert(sqlite3_stmt* st, const Ship& s) {
+    sqlite3_bind_text(st, 1, s.name.c_str(),    -1, SQLITE_STATIC);
+    sqlite3_bind_text(st, 2, s.type.c_str(),    -1, SQLITE_STATIC);
+    sqlite3_bind_text(st, 3, s.country.c_str(), -1, SQLITE_STATIC);
+
+    // port_id: 0/не задано -> NULL
+    bindNullableInt64(st, 4, static_cast<std::int64_t>(s.port_id));
+
+    sqlite3_bind_text(st, 5, s.status.c_str(),  -1, SQLITE_STATIC);
+
+    // company_id: 0/не задано -> NULL
+    bindNullableInt64(st, 6, static_cast<std::int64_t>(s.company_id));
+
+    // speed_knots
+    sqlite3_bind_double(st, 7, s.speed_knots);
+
+    // Voyage tracking fields
+    bindNullableInt64(st, 8, s.departed_at);
+    bindNullableInt64(st, 9, static_cast<std::int64_t>(s.destination_port_id));
+    bindNullableInt64(st, 10, s.eta);
+    sqlite3_bind_double(st, 11, s.voyage_distance_km);
+}
+
 } // namespace
 
 // ===================== ALL =====================
@@ -89,6 +98,18 @@ std::vector<Ship> ShipsRepo::all() {
     return result;
 }
 
+Page<Ship> ShipsRepo::page(const PageRequest& req) {
+    const char* sql =
+        "SELECT id,name,type,country,port_id,status,IFNULL(company_id,0),"
+        "IFNULL(speed_knots,20.0),"
+        "departed_at,IFNULL(destination_port_id,0),eta,IFNULL(voyage_distance_km,0) "
+        "FROM ships "
+        "WHERE id > ? "
+        "ORDER BY id LIMIT ?";
+
+    return fetchPage<Ship>(Db::instance().handle(), sql, req, parseShip);
+}
+
 // ===================== BY PORT =====================
 
 std::vector<Ship> ShipsRepo::getByPortId(long long portId) {
@@ -113,6 +134,102 @@ std::vector<Ship> ShipsRepo::getByPortId(long long portId) {
     return result;
 }
 
+// ===================== DUE ARRIVALS =====================
+
+// Умова status = 'departed' збігається з WHERE часткового індексу,
+// тож планувальник іде по idx_ships_departed_eta діапазоном eta
+std::vector<Ship> ShipsRepo::departedDueBefore(std::int64_t nowMs) {
+    sqlite3* db = Db::instance().handle();
+
+    const char* sql =
+        "SELECT id,name,type,country,port_id,status,IFNULL(company_id,0),"
+        "IFNULL(speed_knots,20.0),"
+        "departed_at,IFNULL(destination_port_id,0),eta,IFNULL(voyage_distance_km,0) "
+        "FROM ships "
+        "WHERE status = 'departed' AND eta > 0 AND eta <= ? "
+        "ORDER BY eta, id";
+
+    Stmt st(db, sql);
+    sqlite3_bind_int64(st.get(), 1, nowMs);
+
+    std::vector<Ship> result;
+    while (sqlite3_step(st.get()) == SQLITE_ROW) {
+        result.push_back(parseShip(st.get()));
+    }
+
+    return result;
+}
+
+// Той самий частковий індекс, але лише 6 колонок рейсу
+std::vector<ShipsRepo::InFlight> ShipsRepo::inFlight() {
+    sqlite3* db = Db::instance().handle();
+
+    Stmt st(db,
+        "SELECT id, name, IFNULL(port_id,0), IFNULL(destination_port_id,0), "
+        "IFNULL(departed_at,0), eta "
+        "FROM ships "
+        "WHERE status = 'departed' AND eta > 0 "
+        "ORDER BY eta, id");
+
+    std::vector<InFlight> result;
+    while (sqlite3_step(st.get()) == SQLITE_ROW) {
+        InFlight f;
+        f.id                = sqlite3_column_int64(st.get(), 0);
+        f.name              = safe_text(st.get(), 1);
+        f.originPortId      = sqlite3_column_int64(st.get(), 2);
+        f.destinationPortId = sqlite3_column_int64(st.get(), 3);
+        f.departedAt        = sqlite3_column_int64(st.get(), 4);
+        f.eta               = sqlite3_column_int64(st.get(), 5);
+        result.push_back(std::move(f));
+    }
+
+    return result;
+}
+
+// Прибуття — set-based: замість update() на кожен корабель (11 колонок,
+// окремий statement і аудит) один UPDATE по idx_ships_departed_eta.
+// BEGIN IMMEDIATE тримає write-лок від SELECT до UPDATE, тож обидва
+// бачать ту саму множину кораблів.
+std::vector<Ship> ShipsRepo::dockDueArrivals(std::int64_t nowMs) {
+    sqlite3* db = Db::instance().handle();
+    Db::Transaction tx(db);
+
+    std::vector<Ship> due = departedDueBefore(nowMs);
+    if (due.empty()) {
+        tx.commit();
+        return due;
+    }
+
+    // рейси закриваються до UPDATE ships: він прибирає їх з предиката
+    VoyagesRepo(db).closeDue(nowMs);
+
+    Stmt st(db,
+        "UPDATE ships "
+        "SET status = 'docked', port_id = destination_port_id, destination_port_id = NULL, "
+        "departed_at = NULL, eta = NULL, voyage_distance_km = 0 "
+        "WHERE status = 'departed' AND eta > 0 AND eta <= ?;");
+    sqlite3_bind_int64(st.get(), 1, nowMs);
+
+    if (sqlite3_step(st.get()) != SQLITE_DONE) {
+        throw std::runtime_error(std::string("ShipsRepo::dockDueArrivals failed: ") + sqlite3_errmsg(db));
+    }
+    if (static_cast<std::size_t>(sqlite3_changes(db)) != due.size()) {
+        throw std::runtime_error("ShipsRepo::dockDueArrivals: due set changed during update");
+    }
+
+    // у транзакції insertLog пише одразу в неї: один коміт на весь тік
+    for (const auto& s : due) {
+        try {
+            std::string msg = "Ship id=" + std::to_string(s.id) + " name='" + s.name +
+                              "' arrived at port " + std::to_string(s.destination_port_id);
+            Db::instance().insertLog("INFO", "ship.arrive", "ship", (int)s.id, "system", msg);
+        } catch (...) {}
+    }
+
+    tx.commit();
+    return due;
+}
+
 // ===================== BY ID =====================
 
 std::optional<Ship> ShipsRepo::byId(long long id) {
@@ -135,46 +252,45 @@ std::optional<Ship> ShipsRepo::byId(long long id) {
     return std::nullopt;
 }
 
-// ===================== CREATE =====================
-
-Ship ShipsRepo::create(const Ship& sIn) {
+// Пошук за UNIQUE-індексом ships.name — O(log n), без скану флоту
+std::optional<Ship> ShipsRepo::byName(const std::string& name) {
     sqlite3* db = Db::instance().handle();
 
     const char* sql =
-        "INSERT INTO ships(name, type, country, port_id, status, company_id, speed_knots, "
-        "departed_at, destination_port_id, eta, voyage_distance_km) "
-        "VALUES(?,?,?,?,?,?,?,?,?,?,?);";
+        "SELECT id,name,type,country,port_id,status,IFNULL(company_id,0),"
+        "IFNULL(speed_knots,20.0),"
+        "departed_at,IFNULL(destination_port_id,0),eta,IFNULL(voyage_distance_km,0) "
+        "FROM ships "
+        "WHERE name=?";
 
     Stmt st(db, sql);
+    sqlite3_bind_text(st.get(), 1, name.c_str(), -1, SQLITE_STATIC);
 
-    sqlite3_bind_text(st.get(), 1, sIn.name.c_str(),    -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(st.get(), 2, sIn.type.c_str(),    -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(st.get(), 3, sIn.country.c_str(), -1, SQLITE_TRANSIENT);
+    if (sqlite3_step(st.get()) == SQLITE_ROW) {
+        return parseShip(st.get());
+    }
 
-    // port_id: 0/не задано -> NULL
-    bindNullableInt64(st.get(), 4, static_cast<std::int64_t>(sIn.port_id));
+    return std::nullopt;
+}
 
-    sqlite3_bind_text(st.get(), 5, sIn.status.c_str(),  -1, SQLITE_TRANSIENT);
+bool ShipsRepo::existsByName(const std::string& name) {
+    sqlite3* db = Db::instance().handle();
 
-    // company_id: 0/не задано -> NULL
-    bindNullableInt64(st.get(), 6, static_cast<std::int64_t>(sIn.company_id));
+    // лише індекс, рядок таблиці не читається
+    Stmt st(db, "SELECT 1 FROM ships WHERE name=? LIMIT 1");
+    sqlite3_bind_text(st.get(), 1, name.c_str(), -1, SQLITE_STATIC);
 
-    // speed_knots
-    sqlite3_bind_double(st.get(), 7, sIn.speed_knots);
+    return sqlite3_step(st.get()) == SQLITE_ROW;
+}
 
-    // Voyage tracking fields
-    if (sIn.departed_at.empty()) {
-        sqlite3_bind_null(st.get(), 8);
-    } else {
-        sqlite3_bind_text(st.get(), 8, sIn.departed_at.c_str(), -1, SQLITE_TRANSIENT);
-    }
-    bindNullableInt64(st.get(), 9, static_cast<std::int64_t>(sIn.destination_port_id));
-    if (sIn.eta.empty()) {
-        sqlite3_bind_null(st.get(), 10);
-    } else {
-        sqlite3_bind_text(st.get(), 10, sIn.eta.c_str(), -1, SQLITE_TRANSIENT);
-    }
-    sqlite3_bind_double(st.get(), 11, sIn.voyage_distance_km);
+// ===================== CREATE =====================
+
+Ship ShipsRepo::create(const Ship& sIn) {
+    sqlite3* db = Db::instance().handle();
+    Db::Transaction tx(db);
+
+    Stmt st(db, kInsertShipSql);
+    bindShipInsert(st.get(), sIn);
 
     const int rc = sqlite3_step(st.get());
     if (rc != SQLITE_DONE) {
@@ -189,13 +305,64 @@ Ship ShipsRepo::create(const Ship& sIn) {
     } catch (...) {
         // ignore logging errors
     }
+    tx.commit();
     return out;
 }
 
+// ===================== BULK CREATE =====================
+
+ShipsRepo::BulkResult ShipsRepo::createMany(const std::vector<Ship>& ships) {
+    sqlite3* db = Db::instance().handle();
+    Db::Transaction tx(db);
+
+    BulkResult res;
+    res.ids.assign(ships.size(), 0);
+
+    // Один statement на всю пачку: лише reset + нові bind-и на рядок
+    Stmt st(db, kInsertShipSql);
+    std::int64_t firstId = 0, lastId = 0;   // AUTOINCREMENT: id ростуть у порядку вставки
+
+    for (std::size_t i = 0; i < ships.size(); ++i) {
+        bindShipInsert(st.get(), ships[i]);
+
+        const int rc = sqlite3_step(st.get());
+        if (rc == SQLITE_DONE) {
+            lastId = sqlite3_last_insert_rowid(db);
+            if (firstId == 0) firstId = lastId;
+            res.ids[i] = lastId;
+            ++res.inserted;
+        } else if ((rc & 0xff) == SQLITE_CONSTRAINT && !sqlite3_get_autocommit(db)) {
+            // Порушення обмеження відкочує лише цей statement — транзакція живе далі
+            res.errors.push_back({i, sqlite3_errmsg(db)});
+        } else {
+            // FULL/IOERR/NOMEM/BUSY можуть відкотити всю транзакцію: далі рядки
+            // комітились би поодинці — імпорт падає цілком (tx відкотить решту)
+            throw std::runtime_error(std::string("ShipsRepo::createMany failed at row ") +
+                                     std::to_string(i) + ": " + sqlite3_errmsg(db));
+        }
+        sqlite3_reset(st.get());
+    }
+
+    if (res.inserted > 0) {
+        try {
+            std::string msg = "Bulk created " + std::to_string(res.inserted) + " ships (" +
+                              std::to_string(res.errors.size()) + " rejected), ids " +
+                              std::to_string(firstId) + ".." + std::to_string(lastId);
+            Db::instance().insertLog("INFO", "ship.bulk_create", "ship", 0, "system", msg);
+        } catch (...) {
+            // ignore logging errors
+        }
+    }
+
+    tx.commit();
+    return res;
+}
+
 // ===================== UPDATE =====================
 
 void ShipsRepo::update(const Ship& s) {
     sqlite3* db = Db::instance().handle();
+    Db::Transaction tx(db);
 
     const char* sql =
         "UPDATE ships "
@@ -219,17 +386,9 @@ void ShipsRepo::update(const Ship& s) {
     sqlite3_bind_double(st.get(), 7, s.speed_knots);
 
     // Voyage tracking fields
-    if (s.departed_at.empty()) {
-        sqlite3_bind_null(st.get(), 8);
-    } else {
-        sqlite3_bind_text(st.get(), 8, s.departed_at.c_str(), -1, SQLITE_TRANSIENT);
-    }
+    bindNullableInt64(st.get(), 8, s.departed_at);
     bindNullableInt64(st.get(), 9, static_cast<std::int64_t>(s.destination_port_id));
-    if (s.eta.empty()) {
-        sqlite3_bind_null(st.get(), 10);
-    } else {
-        sqlite3_bind_text(st.get(), 10, s.eta.c_str(), -1, SQLITE_TRANSIENT);
-    }
+    bindNullableInt64(st.get(), 10, s.eta);
     sqlite3_bind_double(st.get(), 11, s.voyage_distance_km);
 
     sqlite3_bind_int64(st.get(), 12, static_cast<std::int64_t>(s.id));
@@ -242,12 +401,14 @@ void ShipsRepo::update(const Ship& s) {
         std::string msg = "Updated ship id=" + std::to_string(s.id) + " name='" + s.name + "' status='" + s.status + "'";
         Db::instance().insertLog("INFO", "ship.update", "ship", (int)s.id, "system", msg);
     } catch (...) {}
+    tx.commit();
 }
 
 // ===================== REMOVE =====================
 
 void ShipsRepo::remove(long long id) {
     sqlite3* db = Db::instance().handle();
+    Db::Transaction tx(db);
 
     const char* sql =
         "DELETE FROM ships WHERE id=?;";
@@ -266,4 +427,5 @@ void ShipsRepo::remove(long long id) {
         std::string msg = "Deleted ship id=" + std::to_string(id);
         Db::instance().insertLog("INFO", "ship.delete", "ship", (int)id, "system", msg);
     } catch (...) {}
+    tx.commit();
 }
@@ -0,0 +1,188 @@
+﻿// src/repos/VoyagesRepo.cpp
+#include "repos/VoyagesRepo.h"
+#include "db/Db.h"
+#include "db/Stmt.h"
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr const char* kVoyageColumns =
+    "id, ship_id, origin_port_id, destination_port_id, departed_at, "
+    "IFNULL(planned_eta, 0), IFNULL(arrived_at, 0), distance_km, speed_knots";
+
+Voyage parseVoyage(sqlite3_stmt* st) {
+    Voyage v{};
+    v.id                  = sqlite3_column_int64(st, 0);
+    v.ship_id             = sqlite3_column_int64(st, 1);
+    v.origin_port_id      = sqlite3_column_int64(st, 2);
+    v.destination_port_id = sqlite3_column_int64(st, 3);
+    v.departed_at         = sqlite3_column_int64(st, 4);
+    v.planned_eta         = sqlite3_column_int64(st, 5);
+    v.arrived_at          = sqlite3_column_int64(st, 6);
+    v.distance_km         = sqlite3_column_double(st, 7);
+    v.speed_knots         = sqlite3_column_double(st, 8);
+    return v;
+}
+
+void stepDone(sqlite3* db, sqlite3_stmt* st, const char* what) {
+    if (sqlite3_step(st) != SQLITE_DONE) {
+        throw std::runtime_error(std::string("VoyagesRepo::") + what + " failed: " + sqlite3_errmsg(db));
+    }
+}
+
+} // namespace
+
+VoyagesRepo::VoyagesRepo()
+    : db_(Db::instance().handle()) {}
+
+VoyagesRepo::VoyagesRepo(sqlite3* db)
+    : db_(db) {}
+
+// ------------------ WRITE ------------------
+
+std::int64_t VoyagesRepo::open(const Ship& s) const {
+    if (s.port_id <= 0 || s.destination_port_id <= 0 || s.departed_at <= 0) return 0;
+
+    Stmt st(db_,
+        "INSERT INTO voyages (ship_id, origin_port_id, destination_port_id, departed_at, "
+        "                     planned_eta, distance_km, speed_knots) "
+        "VALUES (?, ?, ?, ?, NULLIF(?, 0), ?, ?);");
+    sqlite3_bind_int64 (st.get(), 1, s.id);
+    sqlite3_bind_int64 (st.get(), 2, s.port_id);
+    sqlite3_bind_int64 (st.get(), 3, s.destination_port_id);
+    sqlite3_bind_int64 (st.get(), 4, s.departed_at);
+    sqlite3_bind_int64 (st.get(), 5, s.eta);
+    sqlite3_bind_double(st.get(), 6, s.voyage_distance_km);
+    sqlite3_bind_double(st.get(), 7, s.speed_knots);
+    stepDone(db_, st.get(), "open");
+
+    return sqlite3_last_insert_rowid(db_);
+}
+
+bool VoyagesRepo::close(std::int64_t shipId, std::int64_t arrivedAt) const {
+    Stmt st(db_,
+        "UPDATE voyages SET arrived_at = ? "
+        "WHERE ship_id = ? AND arrived_at IS NULL;");
+    sqlite3_bind_int64(st.get(), 1, arrivedAt);
+    sqlite3_bind_int64(st.get(), 2, shipId);
+    stepDone(db_, st.get(), "close");
+
+    return sqlite3_changes(db_) > 0;
+}
+
+std::size_t VoyagesRepo::closeDue(std::int64_t nowMs) const {
+    // той самий предикат, що в dockDueArrivals (idx_ships_departed_eta),
+    // далі — idx_voyages_ship по кожному кораблю
+    Stmt st(db_,
+        "UPDATE voyages SET arrived_at = ?1 "
+        "WHERE arrived_at IS NULL AND ship_id IN ("
+        "  SELECT id FROM ships WHERE status = 'departed' AND eta > 0 AND eta <= ?1);");
+    sqlite3_bind_int64(st.get(), 1, nowMs);
+    stepDone(db_, st.get(), "closeDue");
+
+    return static_cast<std::size_t>(sqlite3_changes(db_));
+}
+
+// ------------------ READ ------------------
+
+Page<Voyage> VoyagesRepo::page(const PageRequest& req, std::int64_t shipId) const {
+    if (shipId <= 0) {
+        const std::string sql = std::string("SELECT ") + kVoyageColumns +
+            " FROM voyages WHERE id > ? ORDER BY id LIMIT ?;";
+        return fetchPage<Voyage>(db_, sql.c_str(), req, parseVoyage);
+    }
+
+    // рейсів одного корабля небагато: idx_voyages_ship і сортування за id
+    const std::string sql = std::string("SELECT ") + kVoyageColumns +
+        " FROM voyages WHERE ship_id = ?3 AND id > ?1 ORDER BY id LIMIT ?2;";
+
+    Page<Voyage> page;
+    page.items.reserve(static_cast<std::size_t>(req.limit));
+
+    Stmt st(db_, sql.c_str());
+    sqlite3_bind_int64(st.get(), 1, req.after);
+    sqlite3_bind_int(st.get(), 2, req.limit + 1);
+    sqlite3_bind_int64(st.get(), 3, shipId);
+    while (sqlite3_step(st.get()) == SQLITE_ROW) {
+        if (static_cast<int>(page.items.size()) == req.limit) {
+            page.hasMore = true;
+            break;
+        }
+        page.items.push_back(parseVoyage(st.get()));
+    }
+    return page;
+}
+
+std::vector<VoyagesRepo::RouteStats> VoyagesRepo::routeStats(std::int64_t originPortId,
+                                                             std::int64_t destinationPortId,
+                                                             std::int64_t sinceMs,
+                                                             std::int64_t untilMs) const {
+    // Фільтр маршруту — рівність по префіксу idx_voyages_route (пошук, а не
+    // скан); без нього — прохід покривним індексом у порядку GROUP BY.
+    std::string sql =
+        "SELECT origin_port_id, destination_port_id, COUNT(*), "
+        "       AVG(arrived_at - departed_at), AVG(arrived_at - planned_eta), "
+        "       SUM(arrived_at <= planned_eta) "
+        "FROM voyages INDEXED BY idx_voyages_route "
+        "WHERE arrived_at >= ?1 AND arrived_at < ?2";
+    if (originPortId > 0) sql += " AND origin_port_id = ?3";
+    if (destinationPortId > 0) sql += " AND destination_port_id = ?4";
+    sql += " GROUP BY origin_port_id, destination_port_id;";
+
+    Stmt st(db_, sql.c_str());
+    sqlite3_bind_int64(st.get(), 1, sinceMs);
+    sqlite3_bind_int64(st.get(), 2, untilMs);
+    if (originPortId > 0) sqlite3_bind_int64(st.get(), 3, originPortId);
+    if (destinationPortId > 0) sqlite3_bind_int64(st.get(), 4, destinationPortId);
+
+    std::vector<RouteStats> out;
+    while (sqlite3_step(st.get()) == SQLITE_ROW) {
+        RouteStats r;
+        r.originPortId      = sqlite3_column_int64(st.get(), 0);
+        r.destinationPortId = sqlite3_column_int64(st.get(), 1);
+        r.voyages           = sqlite3_column_int64(st.get(), 2);
+        r.avgTransitMs      = sqlite3_column_double(st.get(), 3);
+        r.avgDelayMs        = sqlite3_column_double(st.get(), 4);
+        r.onTime            = sqlite3_column_int64(st.get(), 5);
+        out.push_back(r);
+    }
+    return out;
+}
+
+std::vector<VoyagesRepo::ShipUtilization> VoyagesRepo::shipUtilization(std::int64_t shipId,
+                                                                       std::int64_t sinceMs,
+                                                                       std::int64_t untilMs,
+                                                                       std::int64_t nowMs) const {
+    // перетин [departed_at, arrived_at) з вікном; відкритий рейс — до openEnd.
+    // MAX(0, …) на кожен рейс: рейс, що «відправився» після now, дав би
+    // від'ємний внесок і сховав би час у морі інших рейсів
+    std::string sql =
+        "SELECT ship_id, COUNT(*), "
+        "       SUM(MAX(0, MIN(IFNULL(arrived_at, ?3), ?2) - MAX(departed_at, ?1))) "
+        "FROM voyages INDEXED BY idx_voyages_ship "
+        "WHERE departed_at < ?2 AND (arrived_at IS NULL OR arrived_at > ?1)";
+    if (shipId > 0) sql += " AND ship_id = ?4";
+    sql += " GROUP BY ship_id;";
+
+    Stmt st(db_, sql.c_str());
+    sqlite3_bind_int64(st.get(), 1, sinceMs);
+    sqlite3_bind_int64(st.get(), 2, untilMs);
+    sqlite3_bind_int64(st.get(), 3, std::max(sinceMs, std::min(untilMs, nowMs)));
+    if (shipId > 0) sqlite3_bind_int64(st.get(), 4, shipId);
+
+    std::vector<ShipUtilization> out;
+    while (sqlite3_step(st.get()) == SQLITE_ROW) {
+        ShipUtilization u;
+        u.shipId  = sqlite3_column_int64(st.get(), 0);
+        u.voyages = sqlite3_column_int64(st.get(), 1);
+        u.atSeaMs = std::max<std::int64_t>(0, sqlite3_column_int64(st.get(), 2));
+        out.push_back(u);
+    }
+    return out;
+}
@@ -0,0 +1,208 @@
+﻿// src/services/ArrivalScheduler.cpp
+#include "services/ArrivalScheduler.h"
+#include "repos/ShipsRepo.h"
+#include "util/Time.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <utility>
+
+namespace {
+
+// Сон не довше за це: годинник стіни (eta) може стрибнути, а steady — ні
+constexpr std::int64_t kMaxSleepMs = 1000;
+
+// Після невдалого dock (напр. SQLITE_BUSY) — повтор через цей час
+constexpr std::int64_t kRetryMs = 1000;
+
+} // namespace
+
+ArrivalScheduler& ArrivalScheduler::instance() {
+    static ArrivalScheduler s([](std::int64_t nowMs) {
+        return ShipsRepo{}.dockDueArrivals(nowMs).size();
+    });
+    return s;
+}
+
+ArrivalScheduler::ArrivalScheduler(Dock dock)
+    : ArrivalScheduler(std::move(dock), Clock{}, OnTick{}) {}
+
+ArrivalScheduler::ArrivalScheduler(Dock dock, Clock clock, OnTick onTick)
+    : dock_(std::move(dock)), clock_(std::move(clock)), onTick_(std::move(onTick)) {
+    if (clock_.rate <= 0.0) clock_.rate = 1.0;
+}
+
+ArrivalScheduler::~ArrivalScheduler() {
+    stop();
+}
+
+void ArrivalScheduler::start() {
+    // читаємо БД без лока: track() з контролерів може йти паралельно,
+    // і пізніший schedule() просто перекриє eta з цього знімка
+    const auto departed = ShipsRepo{}.departedDueBefore(std::numeric_limits<std::int64_t>::max());
+
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (thread_.joinable()) return;
+        for (const auto& s : departed) {
+            if (etaOf_.emplace(s.id, s.eta).second) {
+                heap_.push(Entry{s.eta, s.id});
+            }
+        }
+        stop_ = false;
+        thread_ = std::thread([this] { run(); });
+    }
+
+    std::cout << "[Arrivals] scheduler started, " << departed.size()
+              << " ships under way\n";
+}
+
+void ArrivalScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) thread_.join();
+}
+
+void ArrivalScheduler::track(const Ship& s) {
+    if (s.status == "departed" && s.eta > 0) {
+        schedule(s.id, s.eta);
+    } else {
+        cancel(s.id);
+    }
+}
+
+void ArrivalScheduler::schedule(std::int64_t shipId, std::int64_t etaMs) {
+    bool earlier = false;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto [it, inserted] = etaOf_.try_emplace(shipId, etaMs);
+        if (!inserted) {
+            if (it->second == etaMs) return;
+            it->second = etaMs;
+        }
+        earlier = heap_.empty() || etaMs < heap_.top().eta;
+        heap_.push(Entry{etaMs, shipId});
+        compactLocked();
+    }
+    // потік спить до старого найближчого eta — будимо, щоб перерахував
+    if (earlier) wake_.notify_one();
+}
+
+void ArrivalScheduler::cancel(std::int64_t shipId) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (etaOf_.erase(shipId) > 0) {
+        compactLocked();
+    }
+}
+
+std::size_t ArrivalScheduler::pending() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return etaOf_.size();
+}
+
+std::int64_t ArrivalScheduler::nextDueMs() {
+    std::lock_guard<std::mutex> lock(mu_);
+    dropStaleLocked();
+    return heap_.empty() ? 0 : heap_.top().eta;
+}
+
+void ArrivalScheduler::dropStaleLocked() {
+    while (!heap_.empty()) {
+        const Entry& top = heap_.top();
+        const auto it = etaOf_.find(top.shipId);
+        if (it != etaOf_.end() && it->second == top.eta) return;
+        heap_.pop();
+    }
+}
+
+// Застарілі записи лишаються в heap до виштовхування; якщо їх стало
+// більше за живі — перебудовуємо heap з etaOf_, щоб пам'ять не росла
+void ArrivalScheduler::compactLocked() {
+    if (heap_.size() <= 2 * etaOf_.size() + 64) return;
+
+    std::vector<Entry> live;
+    live.reserve(etaOf_.size());
+    for (const auto& [id, eta] : etaOf_) {
+        live.push_back(Entry{eta, id});
+    }
+    heap_ = decltype(heap_)(std::greater<>{}, std::move(live));
+}
+
+std::int64_t ArrivalScheduler::realDelayMs(std::int64_t dueMs, std::int64_t nowMs,
+                                           std::int64_t capMs) const {
+    const double ms = std::ceil(static_cast<double>(dueMs - nowMs) / clock_.rate);
+    return static_cast<std::int64_t>(std::min(ms, static_cast<double>(capMs)));
+}
+
+void ArrivalScheduler::run() {
+    std::vector<Entry> fired;
+
+    std::unique_lock<std::mutex> lock(mu_);
+    while (!stop_) {
+        dropStaleLocked();
+        if (heap_.empty()) {
+            wake_.wait(lock);
+            continue;
+        }
+
+        const std::int64_t nowMs = clock_.now();
+        const std::int64_t due = heap_.top().eta;
+        if (nowMs < due) {
+            wake_.wait_for(lock, std::chrono::milliseconds(realDelayMs(due, nowMs, kMaxSleepMs)));
+            continue;
+        }
+
+        // усе, що настало, — одним тіком
+        fired.clear();
+        while (!heap_.empty() && heap_.top().eta <= nowMs) {
+            const Entry e = heap_.top();
+            heap_.pop();
+            const auto it = etaOf_.find(e.shipId);
+            if (it != etaOf_.end() && it->second == e.eta) {
+                etaOf_.erase(it);
+                fired.push_back(e);
+            }
+        }
+        if (fired.empty()) continue;
+
+        lock.unlock();
+        bool ok = true;
+        std::size_t arrived = 0;
+        const auto t0 = std::chrono::steady_clock::now();
+        try {
+            arrived = dock_(nowMs);
+        } catch (const std::exception& e) {
+            ok = false;
+            std::cerr << "[Arrivals] dock failed: " << e.what() << "\n";
+        } catch (...) {
+            ok = false;
+            std::cerr << "[Arrivals] dock failed\n";
+        }
+        if (onTick_) {
+            const double ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - t0).count();
+            onTick_(Tick{fired.front().eta, nowMs, arrived, ms, ok});
+        } else if (ok) {
+            std::cout << "[Arrivals] " << arrived << " ships docked\n";
+        }
+        lock.lock();
+
+        if (ok) continue;
+
+        // не вдалося — повертаємо в heap з відкладеним eta,
+        // якщо за цей час їх не перепланували
+        for (const auto& e : fired) {
+            const std::int64_t retryAt = nowMs + static_cast<std::int64_t>(kRetryMs * clock_.rate);
+            if (etaOf_.try_emplace(e.shipId, retryAt).second) {
+                heap_.push(Entry{retryAt, e.shipId});
+            }
+        }
+    }
+}
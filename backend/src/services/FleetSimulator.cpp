@@ -0,0 +1,294 @@
+﻿// src/services/FleetSimulator.cpp
+#include "services/FleetSimulator.h"
+#include "db/Db.h"
+#include "db/Stmt.h"
+#include "repos/PortsRepo.h"
+#include "repos/ShipsRepo.h"
+#include "services/ArrivalScheduler.h"
+#include "services/Voyage.h"
+#include "util/Time.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+// Як часто головний потік забирає прибулі кораблі на нове відправлення
+constexpr auto kDispatchPollInterval = std::chrono::milliseconds(5);
+
+double msSince(SteadyClock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(SteadyClock::now() - t0).count();
+}
+
+LatencySummary summarize(std::vector<double> v) {
+    LatencySummary s;
+    s.count = v.size();
+    if (v.empty()) return s;
+    std::sort(v.begin(), v.end());
+    auto at = [&v](double q) {
+        const auto i = static_cast<std::size_t>(std::ceil(q * static_cast<double>(v.size()))) - 1;
+        return v[std::min(i, v.size() - 1)];
+    };
+    s.p50 = at(0.50);
+    s.p95 = at(0.95);
+    s.p99 = at(0.99);
+    s.max = v.back();
+    return s;
+}
+
+// COUNT(*) по кораблях з id у [firstId, lastId]
+std::int64_t countShipRows(const char* sql, std::int64_t firstId, std::int64_t lastId) {
+    if (firstId <= 0) return 0;
+    Stmt st(Db::instance().handle(), sql);
+    sqlite3_bind_int64(st.get(), 1, firstId);
+    sqlite3_bind_int64(st.get(), 2, lastId);
+    return sqlite3_step(st.get()) == SQLITE_ROW ? sqlite3_column_int64(st.get(), 0) : 0;
+}
+
+// Віртуальний час: стартує з реального now і йде в scale разів швидше
+class VirtualClock {
+public:
+    explicit VirtualClock(double scale)
+        : scale_(scale), startReal_(SteadyClock::now()), startMs_(util::nowMs()) {}
+
+    std::int64_t now() const {
+        const double realMs = msSince(startReal_);
+        return startMs_ + static_cast<std::int64_t>(realMs * scale_);
+    }
+
+private:
+    double scale_;
+    SteadyClock::time_point startReal_;
+    std::int64_t startMs_;
+};
+
+} // namespace
+
+FleetSimulator::FleetSimulator(FleetSimOptions opts) : opts_(std::move(opts)) {
+    if (opts_.ships == 0) throw std::runtime_error("simulation needs at least one ship");
+    if (opts_.timeScale <= 0.0) throw std::runtime_error("time scale must be positive");
+    if (opts_.minSpeedKnots <= 0.0 || opts_.maxSpeedKnots < opts_.minSpeedKnots) {
+        throw std::runtime_error("speed range must be positive and min <= max");
+    }
+}
+
+FleetSimReport FleetSimulator::run() {
+    const auto ports = PortsRepo{}.all();
+    if (ports.size() < 2) {
+        throw std::runtime_error("simulation needs at least two ports, found " +
+                                 std::to_string(ports.size()));
+    }
+    if (const auto underWay = ShipsRepo{}.inFlight(); !underWay.empty()) {
+        throw std::runtime_error(std::to_string(underWay.size()) +
+                                 " ships are under way; the accelerated clock would dock them "
+                                 "early - run the simulation on a copy of the database");
+    }
+
+    std::mt19937_64 rng(opts_.seed);
+    std::uniform_int_distribution<std::size_t> pickPort(0, ports.size() - 1);
+    std::uniform_real_distribution<double> pickSpeed(opts_.minSpeedKnots, opts_.maxSpeedKnots);
+
+    // ---- синтетичний флот ----
+    const std::string prefix = "SIM-" + std::to_string(util::nowMs()) + "-";
+    std::vector<Ship> fleet(opts_.ships);
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        Ship& s = fleet[i];
+        s.name = prefix + std::to_string(i + 1);
+        s.type = "cargo";
+        s.country = "SIM";
+        s.port_id = ports[pickPort(rng)].id;
+        s.status = "docked";
+        s.speed_knots = pickSpeed(rng);
+    }
+    const auto created = ShipsRepo{}.createMany(fleet);
+    if (!created.errors.empty()) {
+        throw std::runtime_error("failed to create synthetic fleet: " + created.errors.front().message);
+    }
+
+    FleetSimReport r;
+    r.ports = ports.size();
+    r.ships = created.inserted;
+
+    VirtualClock clock(opts_.timeScale);
+
+    std::mutex mu;                       // arrived, tick-вибірки
+    std::vector<std::int64_t> arrived;   // id прибулих, чекають нового відправлення
+    std::vector<double> dockMs, tickLatencyMs;
+    std::size_t arrivals = 0, ticks = 0, failedTicks = 0;
+
+    ArrivalScheduler scheduler(
+        [&](std::int64_t nowMs) {
+            const auto docked = ShipsRepo{}.dockDueArrivals(nowMs);
+            std::lock_guard<std::mutex> lock(mu);
+            for (const auto& s : docked) arrived.push_back(s.id);
+            return docked.size();
+        },
+        ArrivalScheduler::Clock{[&clock] { return clock.now(); }, opts_.timeScale},
+        [&](const ArrivalScheduler::Tick& t) {
+            std::lock_guard<std::mutex> lock(mu);
+            ++ticks;
+            if (!t.ok) {
+                ++failedTicks;
+                return;
+            }
+            arrivals += t.ships;
+            dockMs.push_back(t.dockMs);
+            tickLatencyMs.push_back(static_cast<double>(t.firedMs - t.dueMs) / opts_.timeScale + t.dockMs);
+        });
+
+    // Відправлення — як у ShipsController::updateOne
+    std::vector<double> departMs;
+    departMs.reserve(opts_.ships * 2);
+    auto depart = [&](std::int64_t id) {
+        const auto t0 = SteadyClock::now();
+        Db::Transaction tx;
+        ShipsRepo repo;
+        const auto cur = repo.byId(id);
+        if (!cur || cur->status == "departed") return;
+
+        Ship s = *cur;
+        std::int64_t dest = cur->port_id;
+        while (dest == cur->port_id) dest = ports[pickPort(rng)].id;
+        s.status = "departed";
+        s.destination_port_id = dest;
+        s.speed_knots = pickSpeed(rng);
+        s.departed_at = 0;
+        s.eta = 0;
+        const std::int64_t nowMs = clock.now();
+        applyVoyagePlan(*cur, s, nowMs);
+
+        repo.update(s);
+        recordVoyage(*cur, s, nowMs);
+        tx.commit();
+        scheduler.track(s);
+        departMs.push_back(msSince(t0));
+    };
+
+    const std::uint64_t seq0 = Db::instance().commitSeq();
+    const auto started = SteadyClock::now();
+    const auto deadline = started + std::chrono::duration_cast<SteadyClock::duration>(
+        std::chrono::duration<double>(opts_.durationSec));
+
+    scheduler.start();
+    for (const auto id : created.ids) {
+        if (id > 0) depart(id);
+    }
+
+    std::vector<std::int64_t> batch;
+    while (SteadyClock::now() < deadline) {
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            batch.swap(arrived);
+        }
+        for (const auto id : batch) {
+            if (SteadyClock::now() >= deadline) break;
+            depart(id);
+        }
+        batch.clear();
+        std::this_thread::sleep_for(kDispatchPollInterval);
+    }
+    scheduler.stop();
+
+    r.realSec = msSince(started) / 1000.0;
+    r.virtualHours = r.realSec * opts_.timeScale / 3600.0;
+    r.commits = Db::instance().commitSeq() - seq0;
+    r.departures = departMs.size();
+    r.departMs = summarize(std::move(departMs));
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        r.arrivals = arrivals;
+        r.ticks = ticks;
+        r.failedTicks = failedTicks;
+        r.dockMs = summarize(std::move(dockMs));
+        r.tickLatencyMs = summarize(std::move(tickLatencyMs));
+    }
+    // UPDATE ships окремо не видно в БД — рахуємо з подій
+    r.shipRowWrites = r.departures + r.arrivals;
+
+    // id пачки createMany йдуть підряд (одна транзакція, AUTOINCREMENT)
+    std::int64_t firstId = 0, lastId = 0;
+    for (const auto id : created.ids) {
+        if (id <= 0) continue;
+        if (firstId == 0) firstId = id;
+        lastId = id;
+    }
+
+    // Аудит і рейси — фактичні рядки кораблів симуляції
+    Db::instance().flushLogs();
+    r.auditRows = static_cast<std::size_t>(countShipRows(
+        "SELECT COUNT(*) FROM logs WHERE entity = 'ship' "
+        "AND event_type IN ('ship.update', 'ship.arrive') AND entity_id BETWEEN ? AND ?;",
+        firstId, lastId));
+    r.voyageRows = static_cast<std::size_t>(countShipRows(
+        "SELECT COUNT(*) + COUNT(arrived_at) FROM voyages WHERE ship_id BETWEEN ? AND ?;",
+        firstId, lastId));
+
+    // Без --keep прибираємо і рейси: інакше вони лишаться в аналітиці voyages
+    if (!opts_.keep && firstId > 0) {
+        Db::Transaction tx;
+        {
+            Stmt st(Db::instance().handle(), "DELETE FROM voyages WHERE ship_id BETWEEN ? AND ?;");
+            sqlite3_bind_int64(st.get(), 1, firstId);
+            sqlite3_bind_int64(st.get(), 2, lastId);
+            if (sqlite3_step(st.get()) != SQLITE_DONE) {
+                throw std::runtime_error(std::string("FleetSimulator: voyages cleanup failed: ") +
+                                         sqlite3_errmsg(Db::instance().handle()));
+            }
+        }
+        ShipsRepo repo;
+        for (const auto id : created.ids) {
+            if (id > 0) repo.remove(id);
+        }
+        tx.commit();
+    }
+    return r;
+}
+
+std::string formatReport(const FleetSimReport& r) {
+    auto perSec = [&r](double n) { return r.realSec > 0.0 ? n / r.realSec : 0.0; };
+    auto line = [](const char* name, const LatencySummary& l) {
+        char buf[160];
+        std::snprintf(buf, sizeof buf, "  %-16s n=%-8zu p50=%8.3f  p95=%8.3f  p99=%8.3f  max=%8.3f ms\n",
+                      name, l.count, l.p50, l.p95, l.p99, l.max);
+        return std::string(buf);
+    };
+
+    char buf[512];
+    std::string out;
+    std::snprintf(buf, sizeof buf,
+                  "fleet: %zu ships across %zu ports\n"
+                  "time:  %.1f s real, %.1f h virtual\n"
+                  "throughput:\n"
+                  "  departures       %zu (%.1f/s)\n"
+                  "  arrivals         %zu (%.1f/s) in %zu ticks, %zu failed\n",
+                  r.ships, r.ports, r.realSec, r.virtualHours,
+                  r.departures, perSec(static_cast<double>(r.departures)),
+                  r.arrivals, perSec(static_cast<double>(r.arrivals)), r.ticks, r.failedTicks);
+    out += buf;
+    out += "latency:\n";
+    out += line("depart tx", r.departMs);
+    out += line("dock per tick", r.dockMs);
+    out += line("tick (eta->done)", r.tickLatencyMs);
+    std::snprintf(buf, sizeof buf,
+                  "db writes:\n"
+                  "  commits          %llu (%.1f/s)\n"
+                  "  ship rows        %zu (%.1f/s, derived: departures + arrivals)\n"
+                  "  audit rows       %zu (%.1f/s)\n"
+                  "  voyage rows      %zu (%.1f/s)\n",
+                  static_cast<unsigned long long>(r.commits), perSec(static_cast<double>(r.commits)),
+                  r.shipRowWrites, perSec(static_cast<double>(r.shipRowWrites)),
+                  r.auditRows, perSec(static_cast<double>(r.auditRows)),
+                  r.voyageRows, perSec(static_cast<double>(r.voyageRows)));
+    out += buf;
+    return out;
+}
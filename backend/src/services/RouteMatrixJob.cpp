@@ -0,0 +1,212 @@
+﻿// src/services/RouteMatrixJob.cpp
+#include "services/RouteMatrixJob.h"
+#include "geo/RouteMatrix.h"
+#include "geo/RoutePlanner.h"
+#include "repos/PortsRepo.h"
+#include "util/Time.h"
+
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <utility>
+
+namespace {
+
+// Пауза після останнього запиту: серія правок портів — один перерахунок
+constexpr std::int64_t kDebounceMs = 2000;
+
+// Граф потрібен планувальнику одразу, тож чекаємо менше — лише щоб
+// склеїти пачку правок (імпорт, серія PUT)
+constexpr std::int64_t kGraphDebounceMs = 250;
+
+// Після невдалого прогону (диск, пам'ять) — повтор через цей час
+constexpr std::int64_t kRetryMs = 60000;
+
+} // namespace
+
+RouteMatrixJob& RouteMatrixJob::instance() {
+    static RouteMatrixJob j;
+    return j;
+}
+
+RouteMatrixJob::~RouteMatrixJob() {
+    stop();
+}
+
+void RouteMatrixJob::start(std::string path, unsigned threads) {
+    const auto graph = geo::RoutePlanner::instance().graph();
+    const bool loaded = graph && geo::RouteMatrix::instance().load(path, graph->fingerprint);
+
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (thread_.joinable()) return;
+        path_ = std::move(path);
+        threads_ = threads;
+        if (!loaded) {
+            pending_ = true;
+            requestedAtMs_ = 0;   // без debounce: матриці ще немає
+        }
+        stop_ = false;
+        thread_ = std::thread([this] { run(); });
+    }
+
+    if (loaded) {
+        std::cout << "[Routes] route matrix loaded from " << path_ << ", "
+                  << geo::RouteMatrix::instance().info().ports << " ports\n";
+    } else {
+        std::cout << "[Routes] no up-to-date route matrix at " << path_
+                  << ", computing in background\n";
+    }
+}
+
+void RouteMatrixJob::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) thread_.join();
+}
+
+void RouteMatrixJob::requestRebuild() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        pending_ = true;
+        requestedAtMs_ = util::nowMs();
+    }
+    wake_.notify_one();
+}
+
+void RouteMatrixJob::requestGraphRebuild() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        graphPending_ = true;
+        graphRequestedAtMs_ = util::nowMs();
+    }
+    wake_.notify_one();
+}
+
+RouteMatrixJob::Status RouteMatrixJob::status() {
+    const auto graph = geo::RoutePlanner::instance().graph();
+    const auto info = geo::RouteMatrix::instance().info();
+
+    std::lock_guard<std::mutex> lock(mu_);
+    Status s;
+    s.path = path_;
+    s.graphPending = graphPending_;
+    s.pending = pending_;
+    s.computing = computing_;
+    s.stale = !info.loaded || !graph || graph->fingerprint != info.fingerprint;
+    s.lastErrorAtMs = lastErrorAtMs_;
+    s.lastError = lastError_;
+    return s;
+}
+
+// Сусідство в графі залежить від усіх портів — граф будується заново
+// (скидає і кеш маршрутів), після чого ставиться перерахунок матриці.
+// Викликається з mu_; лок відпускається на час побудови.
+void RouteMatrixJob::rebuildGraph(std::unique_lock<std::mutex>& lock) {
+    graphPending_ = false;
+    lock.unlock();
+
+    std::string error;
+    std::size_t ports = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    try {
+        PortsRepo repo;
+        const auto all = repo.all();
+        ports = all.size();
+        geo::RoutePlanner::instance().build(all, repo.lanes());
+    } catch (const std::exception& e) {
+        error = e.what();
+    } catch (...) {
+        error = "unknown error";
+    }
+    const double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - t0).count();
+
+    lock.lock();
+    if (error.empty()) {
+        std::cout << "[Routes] route graph over " << ports << " ports rebuilt in "
+                  << ms << " ms\n";
+        pending_ = true;
+        requestedAtMs_ = util::nowMs();
+        return;
+    }
+
+    std::cerr << "[Routes] route graph rebuild failed: " << error << "\n";
+    lastError_ = std::move(error);
+    lastErrorAtMs_ = util::nowMs();
+    if (!graphPending_) {
+        graphPending_ = true;
+        graphRequestedAtMs_ = lastErrorAtMs_ + kRetryMs - kGraphDebounceMs;
+    }
+}
+
+void RouteMatrixJob::run() {
+    std::unique_lock<std::mutex> lock(mu_);
+    while (!stop_) {
+        if (!pending_ && !graphPending_) {
+            wake_.wait(lock);
+            continue;
+        }
+
+        const std::int64_t nowMs = util::nowMs();
+
+        // спершу граф: матриця над застарілим графом однаково не знадобиться
+        if (graphPending_) {
+            const std::int64_t graphDueMs = graphRequestedAtMs_ + kGraphDebounceMs;
+            if (nowMs < graphDueMs) {
+                wake_.wait_for(lock, std::chrono::milliseconds(graphDueMs - nowMs));
+            } else {
+                rebuildGraph(lock);
+            }
+            continue;
+        }
+
+        const std::int64_t dueMs = requestedAtMs_ + kDebounceMs;
+        if (requestedAtMs_ != 0 && nowMs < dueMs) {
+            wake_.wait_for(lock, std::chrono::milliseconds(dueMs - nowMs));
+            continue;
+        }
+
+        pending_ = false;
+        computing_ = true;
+        const std::string path = path_;
+        const unsigned threads = threads_;
+        lock.unlock();
+
+        // знімок графа: зміна портів під час прогону поставить новий запит
+        std::string error;
+        std::size_t ports = 0;
+        const auto t0 = std::chrono::steady_clock::now();
+        try {
+            if (const auto graph = geo::RoutePlanner::instance().graph()) {
+                ports = graph->size();
+                geo::RouteMatrix::instance().rebuild(*graph, path, threads);
+            }
+        } catch (const std::exception& e) {
+            error = e.what();
+        } catch (...) {
+            error = "unknown error";
+        }
+        const double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - t0).count();
+
+        lock.lock();
+        computing_ = false;
+        if (error.empty()) {
+            std::cout << "[Routes] route matrix over " << ports << " ports computed in "
+                      << ms << " ms\n";
+            continue;
+        }
+
+        std::cerr << "[Routes] route matrix rebuild failed: " << error << "\n";
+        lastError_ = std::move(error);
+        lastErrorAtMs_ = util::nowMs();
+        if (!pending_) {
+            pending_ = true;
+            requestedAtMs_ = lastErrorAtMs_ + kRetryMs - kDebounceMs;
+        }
+    }
+}
@@ -0,0 +1,45 @@
+﻿// src/services/Voyage.cpp
+#include "services/Voyage.h"
+#include "geo/Geo.h"
+#include "repos/PortsRepo.h"
+#include "repos/VoyagesRepo.h"
+
+void applyVoyagePlan(const Ship& cur, Ship& s, std::int64_t nowMs) {
+    if (s.status != "departed") return;
+
+    if (cur.status != "departed") {
+        if (s.departed_at <= 0) s.departed_at = nowMs;
+
+        // під час рейсу port_id — порт відправлення (з нього /positions
+        // веде дугу); прибуття переставить його на destination
+        if (cur.port_id > 0) s.port_id = cur.port_id;
+        if (cur.port_id <= 0 || s.destination_port_id <= 0) return;
+
+        PortsRepo ports;
+        const auto from = ports.getById(cur.port_id);
+        const auto to   = ports.getById(s.destination_port_id);
+        if (!from || !to) return;
+
+        const auto plan = geo::planVoyage(*from, *to, s.speed_knots, s.departed_at);
+        s.voyage_distance_km = plan.distanceKm;
+        s.eta = plan.etaMs;
+        return;
+    }
+
+    if (s.speed_knots != cur.speed_knots && s.voyage_distance_km > 0.0 && s.departed_at > 0) {
+        s.eta = s.departed_at + geo::travelTimeMs(s.voyage_distance_km, s.speed_knots);
+    }
+}
+
+void recordVoyage(const Ship& cur, const Ship& s, std::int64_t nowMs) {
+    const bool wasDeparted = cur.status == "departed";
+    const bool isDeparted = s.status == "departed";
+    if (wasDeparted == isDeparted) return;
+
+    VoyagesRepo voyages;
+    if (isDeparted) {
+        voyages.open(s);
+    } else {
+        voyages.close(s.id, nowMs);
+    }
+}
@@ -0,0 +1,117 @@
+﻿// src/sim_main.cpp
+// oop_sim — прискорена симуляція флоту для навантаження рушія прибуттів.
+//
+// Запуск: ./oop_sim --db <path> [--ships N] [--scale X] [--duration SEC]
+//                   [--speed MIN:MAX] [--seed N] [--seed-ports N] [--keep]
+//
+// --db обов'язковий: симуляція створює кораблі і жене годинник уперед,
+// тож її місце — копія (oop_backend --backup <dest>) або порожня БД.
+// --seed-ports N додає N випадкових портів, якщо їх менше двох.
+#include "db/Db.h"
+#include "repos/PortsRepo.h"
+#include "services/FleetSimulator.h"
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+
+void usage() {
+    std::cerr << "usage: oop_sim --db <path> [--ships N] [--scale X] [--duration SEC]\n"
+                 "               [--speed MIN:MAX] [--seed N] [--seed-ports N] [--keep]\n";
+}
+
+// Випадкові порти для порожньої БД; одна транзакція
+void seedPorts(std::size_t n, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> lat(-60.0, 70.0);
+    std::uniform_real_distribution<double> lon(-180.0, 180.0);
+
+    Db::Transaction tx;
+    PortsRepo repo;
+    for (std::size_t i = 0; i < n; ++i) {
+        Port p;
+        p.name = "SIM-PORT-" + std::to_string(i + 1);
+        p.region = "SIM";
+        p.lat = lat(rng);
+        p.lon = lon(rng);
+        repo.create(p);
+    }
+    tx.commit();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    FleetSimOptions opts;
+    std::string dbPath;
+    std::size_t seedPortCount = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+            return argv[++i];
+        };
+
+        try {
+            if (arg == "--db") {
+                dbPath = value();
+            } else if (arg == "--ships") {
+                opts.ships = std::stoull(value());
+            } else if (arg == "--scale") {
+                opts.timeScale = std::stod(value());
+            } else if (arg == "--duration") {
+                opts.durationSec = std::stod(value());
+            } else if (arg == "--speed") {
+                const std::string v = value();
+                const auto colon = v.find(':');
+                if (colon == std::string::npos) throw std::invalid_argument("--speed expects MIN:MAX");
+                opts.minSpeedKnots = std::stod(v.substr(0, colon));
+                opts.maxSpeedKnots = std::stod(v.substr(colon + 1));
+            } else if (arg == "--seed") {
+                opts.seed = std::stoull(value());
+            } else if (arg == "--seed-ports") {
+                seedPortCount = std::stoull(value());
+            } else if (arg == "--keep") {
+                opts.keep = true;
+            } else {
+                usage();
+                return 2;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "[Sim] bad argument " << arg << ": " << e.what() << "\n";
+            usage();
+            return 2;
+        }
+    }
+
+    if (dbPath.empty()) {
+        usage();
+        return 2;
+    }
+
+    try {
+        DbOptions dbOpts = DbOptions::forProfile("balanced");
+        dbOpts.path = dbPath;
+        Db::configure(dbOpts);
+        Db::instance();
+
+        if (seedPortCount > 0 && PortsRepo{}.all().size() < 2) {
+            seedPorts(seedPortCount, opts.seed);
+        }
+
+        FleetSimulator sim(opts);
+        const FleetSimReport report = sim.run();
+        Db::instance().flushLogs();
+
+        std::cout << formatReport(report);
+    } catch (const std::exception& e) {
+        std::cerr << "[Sim] " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
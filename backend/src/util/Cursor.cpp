@@ -0,0 +1,98 @@
+﻿// src/util/Cursor.cpp
+#include "util/Cursor.h"
+
+#include <charconv>
+
+namespace util {
+
+namespace {
+
+constexpr char kAlphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// Версія формату: міняється разом зі схемою ключів
+constexpr std::string_view kPrefix = "c1:";
+
+int decodeChar(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '-') return 62;
+    if (c == '_') return 63;
+    return -1;
+}
+
+std::string base64url(std::string_view in) {
+    std::string out;
+    out.reserve((in.size() + 2) / 3 * 4);
+    std::uint32_t buf = 0;
+    int bits = 0;
+    for (unsigned char c : in) {
+        buf = (buf << 8) | c;
+        bits += 8;
+        while (bits >= 6) {
+            bits -= 6;
+            out.push_back(kAlphabet[(buf >> bits) & 0x3f]);
+        }
+    }
+    if (bits > 0) out.push_back(kAlphabet[(buf << (6 - bits)) & 0x3f]);
+    return out;
+}
+
+std::optional<std::string> unbase64url(std::string_view in) {
+    std::string out;
+    out.reserve(in.size() * 3 / 4);
+    std::uint32_t buf = 0;
+    int bits = 0;
+    for (char c : in) {
+        const int v = decodeChar(c);
+        if (v < 0) return std::nullopt;
+        buf = (buf << 6) | static_cast<std::uint32_t>(v);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out.push_back(static_cast<char>((buf >> bits) & 0xff));
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+std::string encodeCursor(std::initializer_list<std::int64_t> keys) {
+    std::string raw(kPrefix);
+    bool first = true;
+    for (const auto k : keys) {
+        if (!first) raw.push_back(',');
+        raw += std::to_string(k);
+        first = false;
+    }
+    return base64url(raw);
+}
+
+std::optional<std::vector<std::int64_t>> decodeCursor(std::string_view cursor) {
+    if (cursor.empty() || cursor.size() > 128) return std::nullopt;
+
+    const auto raw = unbase64url(cursor);
+    if (!raw || raw->compare(0, kPrefix.size(), kPrefix) != 0) return std::nullopt;
+
+    std::vector<std::int64_t> keys;
+    const char* p   = raw->data() + kPrefix.size();
+    const char* end = raw->data() + raw->size();
+    while (p < end) {
+        std::int64_t v = 0;
+        const auto [next, ec] = std::from_chars(p, end, v);
+        if (ec != std::errc{} || next == p) return std::nullopt;
+        keys.push_back(v);
+        p = next;
+        if (p < end) {
+            if (*p != ',') return std::nullopt;
+            ++p;
+            if (p == end) return std::nullopt;
+        }
+    }
+    if (keys.empty()) return std::nullopt;
+    return keys;
+}
+
+} // namespace util
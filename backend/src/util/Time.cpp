@@ -0,0 +1,34 @@
+﻿// src/util/Time.cpp
+#include "util/Time.h"
+
+#include <chrono>
+
+namespace util {
+
+namespace {
+
+// Розбір і форматування перевіряються ще під час компіляції
+static_assert(parseIsoMs("1970-01-01T00:00:00Z") == 0);
+static_assert(parseIsoMs("2024-02-29T12:34:56.789Z") == 1709210096789);
+static_assert(parseIsoMs("2024-02-29T14:34:56.789+02:00") == 1709210096789);
+static_assert(parseIsoMs("2024-02-29") == 1709164800000);
+static_assert(!parseIsoMs("2023-02-29"));
+static_assert(!parseIsoMs("2024-02-29T25:00"));
+static_assert(formatIso(1709210096789).view() == "2024-02-29T12:34:56.789Z");
+static_assert(formatIso(0).view() == "1970-01-01T00:00:00.000Z");
+static_assert(formatIso(-1).view() == "1969-12-31T23:59:59.999Z");
+static_assert(monthKey(1709210096789) == 202402);
+
+} // namespace
+
+EpochMs nowMs() noexcept {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+std::string formatIsoMs(EpochMs ms) {
+    thread_local IsoFormatter formatter;
+    return formatter.format(ms).str();
+}
+
+} // namespace util
@@ -145,14 +145,14 @@ if tab == "📋 Ship List":
                     
                     try:
                         if departed_at:
-                            dep_dt = datetime.fromisoformat(departed_at)
+                            dep_dt = datetime.fromisoformat(departed_at.replace("Z", "+00:00"))
                             departed_str = dep_dt.strftime("%Y-%m-%d %H:%M")
                     except:
                         pass
                     
                     try:
                         if eta:
-                            eta_dt = datetime.fromisoformat(eta)
+                            eta_dt = datetime.fromisoformat(eta.replace("Z", "+00:00"))
                             eta_str = eta_dt.strftime("%Y-%m-%d %H:%M")
                     except:
                         pass
@@ -485,7 +485,6 @@ elif tab == "🚢 Depart Ship":
                 if st.button(f"🚢 Depart '{ship_name}' to {port_map.get(dest_port, 'port')}", type="primary"):
                     api.api_put(f"/api/ships/{selected_ship_id}", {
                         "status": "departed",
-                        "port_id": int(dest_port),
                         "destination_port_id": int(dest_port),
                         "departed_at": departed_at,
                         "eta": eta_str,